@@ -0,0 +1,100 @@
+#include "byte_channel.h"
+#include <algorithm>
+#include <cstring>
+
+namespace cardity {
+
+ByteChannel::ByteChannel(size_t capacity) : buffer_(std::max<size_t>(capacity, 1)) {}
+
+bool ByteChannel::try_write(const char* data, size_t size) {
+    bool wake;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cancelled_) {
+            return true;    // 丢弃；调用方通过 cancelled() 中止传输
+        }
+        if (size > buffer_.size() - size_) {
+            if (size_ > 0) {
+                paused_ = true;
+                return false;
+            }
+            buffer_.resize(size);    // 单块比容量还大时只能扩容
+            head_ = 0;
+        }
+        size_t tail = (head_ + size_) % buffer_.size();
+        size_t first = std::min(size, buffer_.size() - tail);
+        std::memcpy(buffer_.data() + tail, data, first);
+        std::memcpy(buffer_.data(), data + first, size - first);
+        size_ += size;
+        wake = wanted_ > 0 && size_ >= wanted_;
+    }
+    if (wake) readable_.notify_one();
+    return true;
+}
+
+void ByteChannel::finish(const std::string& error) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+        error_ = error;
+    }
+    readable_.notify_one();
+}
+
+bool ByteChannel::cancelled() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cancelled_;
+}
+
+void ByteChannel::set_resume_callback(std::function<void()> callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resume_ = std::move(callback);
+}
+
+long ByteChannel::read(char* buffer, size_t size) {
+    std::function<void()> resume;
+    size_t count;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // 攒够一整块再唤醒，避免每个网络小包都来回切换线程
+        wanted_ = std::min(size, buffer_.size() / 2);
+        readable_.wait(lock, [&] { return size_ >= wanted_ || finished_; });
+        wanted_ = 0;
+        if (size_ == 0) {
+            return error_.empty() ? 0 : -1;
+        }
+        count = std::min(size, size_);
+        size_t first = std::min(count, buffer_.size() - head_);
+        std::memcpy(buffer, buffer_.data() + head_, first);
+        std::memcpy(buffer + first, buffer_.data(), count - first);
+        head_ = (head_ + count) % buffer_.size();
+        size_ -= count;
+        if (paused_ && size_ <= buffer_.size() / 2) {
+            paused_ = false;
+            resume = resume_;
+        }
+    }
+    if (resume) resume();
+    return static_cast<long>(count);
+}
+
+void ByteChannel::cancel() {
+    std::function<void()> resume;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cancelled_ = true;
+        size_ = 0;
+        if (paused_) {
+            paused_ = false;
+            resume = resume_;    // 让暂停中的传输继续，以便它发现已取消并中止
+        }
+    }
+    if (resume) resume();
+}
+
+std::string ByteChannel::error() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+} // namespace cardity
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace cardity {
+
+// 单生产者/单消费者的有界环形缓冲区，用于把下载流直接喂给解压。
+// 生产者（HTTP 回调）不阻塞：放不下时 try_write 返回 false，由调用方暂停传输；
+// 消费者腾出一半空间后触发 resume 回调，让生产者继续
+class ByteChannel {
+public:
+    explicit ByteChannel(size_t capacity = 1 << 20);
+
+    // 生产者端
+    bool try_write(const char* data, size_t size);    // 全部写入或什么都不写
+    void finish(const std::string& error = "");        // 数据结束；error 非空表示失败
+    bool cancelled() const;
+    void set_resume_callback(std::function<void()> callback);
+
+    // 消费者端：阻塞直到有数据；返回读到的字节数，0 表示结束，-1 表示出错（见 error()）
+    long read(char* buffer, size_t size);
+    void cancel();                                      // 消费者放弃，之后的写入都会失败
+    std::string error() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::condition_variable readable_;
+    std::vector<char> buffer_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    size_t wanted_ = 0;    // 消费者等待的字节数，0 表示没有在等
+    bool finished_ = false;
+    bool cancelled_ = false;
+    bool paused_ = false;
+    std::string error_;
+    std::function<void()> resume_;
+};
+
+} // namespace cardity
@@ -15,11 +15,11 @@ void print_usage(const std::string& program_name) {
     std::cout << std::endl;
     std::cout << "Commands:" << std::endl;
     std::cout << "  init                    - Initialize a new Cardity project" << std::endl;
-    std::cout << "  install <package>       - Install a package" << std::endl;
+    std::cout << "  install [package] [-j N] - Install a package (or all cardity.json dependencies, using cardity.lock)" << std::endl;
     std::cout << "  uninstall <package>     - Uninstall a package" << std::endl;
     std::cout << "  list                    - List installed packages" << std::endl;
     std::cout << "  search <query>          - Search for packages" << std::endl;
-    std::cout << "  build                   - Build the current project" << std::endl;
+    std::cout << "  build [-j N] [--dist]   - Build the current project (incremental; --dist also packs a .tar.gz)" << std::endl;
     std::cout << "  test                    - Run tests" << std::endl;
     std::cout << "  publish                 - Publish the current package" << std::endl;
     std::cout << "  run <script>            - Run a script from cardity.json" << std::endl;
@@ -37,6 +37,7 @@ void print_usage(const std::string& program_name) {
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << program_name << " init" << std::endl;
     std::cout << "  " << program_name << " install @cardity/standard" << std::endl;
+    std::cout << "  " << program_name << " install -j 16" << std::endl;
     std::cout << "  " << program_name << " install github:user/repo" << std::endl;
     std::cout << "  " << program_name << " build" << std::endl;
     std::cout << "  " << program_name << " publish" << std::endl;
@@ -199,20 +200,52 @@ int cmd_init(int argc, char* argv[]) {
 }
 
 int cmd_install(int argc, char* argv[]) {
-    if (argc < 3) {
-        std::cerr << "❌ Package name required" << std::endl;
-        std::cout << "Usage: cardity install <package>" << std::endl;
-        return 1;
-    }
-    
-    std::string package_name = argv[2];
+    std::string package_name = "";
     std::string version = "latest";
+    std::string registry = "https://registry.cardity.dev";
+    std::string cache = "./.cardity";
+    std::string store;
+    bool offline = false;
+    unsigned jobs = 8;
+    
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            jobs = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg.rfind("-j", 0) == 0 && arg.size() > 2) {
+            jobs = static_cast<unsigned>(std::strtoul(arg.c_str() + 2, nullptr, 10));
+        } else if (arg == "--registry" && i + 1 < argc) {
+            registry = argv[++i];
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cache = argv[++i];
+        } else if (arg == "--store" && i + 1 < argc) {
+            store = argv[++i];
+        } else if (arg == "--offline") {
+            offline = true;
+        } else if (package_name.empty()) {
+            package_name = arg;
+        } else {
+            version = arg;
+        }
+    }
     
-    if (argc > 3) {
-        version = argv[3];
+    PackageManager pm(registry, cache);
+    pm.set_concurrency(jobs);
+    if (!store.empty()) {
+        pm.set_store_directory(store);
     }
+    pm.set_offline(offline);
     
-    PackageManager pm;
+    // 未指定包名时安装 cardity.json 中的全部依赖
+    if (package_name.empty()) {
+        if (!std::filesystem::exists("cardity.json")) {
+            std::cerr << "❌ Package name required (or run in a directory with cardity.json)" << std::endl;
+            std::cout << "Usage: cardity install [<package> [version]] [-j N] [--registry <url>] [--cache <path>] [--store <path>] [--offline]" << std::endl;
+            return 1;
+        }
+        std::cout << "📦 Installing dependencies from cardity.json..." << std::endl;
+        return pm.install_project("cardity.json", "cardity.lock") ? 0 : 1;
+    }
     
     if (package_name.find("github:") == 0) {
         // GitHub 包
@@ -267,14 +300,31 @@ int cmd_list(int argc, char* argv[]) {
 }
 
 int cmd_search(int argc, char* argv[]) {
-    if (argc < 3) {
+    std::string query;
+    std::string registry = "https://registry.cardity.dev";
+    std::string cache = "./.cardity";
+    bool offline = false;
+    
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--registry" && i + 1 < argc) {
+            registry = argv[++i];
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cache = argv[++i];
+        } else if (arg == "--offline") {
+            offline = true;
+        } else {
+            query += (query.empty() ? "" : " ") + arg;
+        }
+    }
+    if (query.empty()) {
         std::cerr << "❌ Search query required" << std::endl;
-        std::cout << "Usage: cardity search <query>" << std::endl;
+        std::cout << "Usage: cardity search <query> [--registry <url>] [--cache <path>] [--offline]" << std::endl;
         return 1;
     }
     
-    std::string query = argv[2];
-    PackageManager pm;
+    PackageManager pm(registry, cache);
+    pm.set_offline(offline);
     auto results = pm.search_packages(query);
     
     if (results.empty()) {
@@ -307,9 +357,23 @@ int cmd_build(int argc, char* argv[]) {
     PackageConfig config("cardity.json");
     config.load();
     
+    unsigned jobs = 0;
+    bool dist = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--dist") {
+            dist = true;
+        } else if (arg == "-j" && i + 1 < argc) {
+            jobs = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg.rfind("-j", 0) == 0 && arg.size() > 2) {
+            jobs = static_cast<unsigned>(std::strtoul(arg.c_str() + 2, nullptr, 10));
+        }
+    }
+    
     PackageBuilder builder(".", "dist");
+    builder.set_jobs(jobs);
     
-    if (!builder.build()) {
+    if (!(dist ? builder.build_for_distribution() : builder.build())) {
         std::cerr << "❌ Build failed" << std::endl;
         return 1;
     }
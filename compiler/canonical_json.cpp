@@ -0,0 +1,255 @@
+#include "canonical_json.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace cardity {
+
+void FdSink::write(const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd_, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error(std::string("Failed to write output: ") + std::strerror(errno));
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+JsonWriter::JsonWriter(ByteSink& sink, int indent) : sink_(sink), indent_(indent) {}
+
+JsonWriter::~JsonWriter() {
+    try {
+        flush();
+    } catch (...) {
+        // 析构中不抛异常；需要感知错误的调用方应显式 flush()
+    }
+}
+
+void JsonWriter::flush() {
+    if (used_) {
+        size_t n = used_;
+        used_ = 0;
+        sink_.write(buffer_, n);
+    }
+}
+
+void JsonWriter::put(char c) {
+    if (used_ == sizeof(buffer_)) flush();
+    buffer_[used_++] = c;
+}
+
+void JsonWriter::put(const char* data, size_t size) {
+    if (size > sizeof(buffer_) - used_) {
+        flush();
+        if (size >= sizeof(buffer_)) {
+            sink_.write(data, size);
+            return;
+        }
+    }
+    std::memcpy(buffer_ + used_, data, size);
+    used_ += size;
+}
+
+void JsonWriter::raw(const char* data, size_t size) {
+    put(data, size);
+}
+
+void JsonWriter::newline_indent(size_t depth) {
+    put('\n');
+    for (size_t i = 0; i < depth * static_cast<size_t>(indent_); ++i) put(' ');
+}
+
+void JsonWriter::before_value() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (stack_.empty()) return;
+    Level& level = stack_.back();
+    if (level.count++ > 0) put(',');
+    if (indent_ >= 0) newline_indent(stack_.size());
+}
+
+void JsonWriter::close(char bracket) {
+    Level level = stack_.back();
+    stack_.pop_back();
+    if (indent_ >= 0 && level.count > 0) newline_indent(stack_.size());
+    put(bracket);
+}
+
+void JsonWriter::begin_object() {
+    before_value();
+    put('{');
+    stack_.push_back({true, 0});
+}
+
+void JsonWriter::end_object() {
+    close('}');
+}
+
+void JsonWriter::begin_array() {
+    before_value();
+    put('[');
+    stack_.push_back({false, 0});
+}
+
+void JsonWriter::end_array() {
+    close(']');
+}
+
+void JsonWriter::key(const std::string& name) {
+    before_value();
+    put_string(name);
+    if (indent_ >= 0) put(": ", 2);
+    else put(':');
+    after_key_ = true;
+}
+
+void JsonWriter::put_string(const std::string& s) {
+    put('"');
+    size_t run = 0; // 连续无需转义的字节直接整段写出
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        const char* esc = nullptr;
+        switch (c) {
+            case '"': esc = "\\\""; break;
+            case '\\': esc = "\\\\"; break;
+            case '\b': esc = "\\b"; break;
+            case '\f': esc = "\\f"; break;
+            case '\n': esc = "\\n"; break;
+            case '\r': esc = "\\r"; break;
+            case '\t': esc = "\\t"; break;
+            default: break;
+        }
+        if (!esc && c >= 0x20) continue;
+        put(s.data() + run, i - run);
+        run = i + 1;
+        if (esc) {
+            put(esc, 2);
+        } else {
+            char buf[8];
+            std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+            put(buf, 6);
+        }
+    }
+    put(s.data() + run, s.size() - run);
+    put('"');
+}
+
+void JsonWriter::value(const std::string& s) {
+    before_value();
+    put_string(s);
+}
+
+void JsonWriter::value(const char* s) {
+    value(std::string(s));
+}
+
+void JsonWriter::value(bool b) {
+    before_value();
+    if (b) put("true", 4);
+    else put("false", 5);
+}
+
+void JsonWriter::value(int64_t n) {
+    before_value();
+    char buf[24];
+    int len = std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(n));
+    put(buf, static_cast<size_t>(len));
+}
+
+void JsonWriter::value(uint64_t n) {
+    before_value();
+    char buf[24];
+    int len = std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(n));
+    put(buf, static_cast<size_t>(len));
+}
+
+void JsonWriter::value_null() {
+    before_value();
+    put("null", 4);
+}
+
+void JsonWriter::value(const std::vector<std::string>& items) {
+    begin_array();
+    for (const auto& item : items) value(item);
+    end_array();
+}
+
+void JsonWriter::value(const json& v) {
+    switch (v.type()) {
+        case json::value_t::null:
+            value_null();
+            break;
+        case json::value_t::boolean:
+            value(v.get<bool>());
+            break;
+        case json::value_t::number_integer:
+            value(static_cast<int64_t>(v.get<json::number_integer_t>()));
+            break;
+        case json::value_t::number_unsigned:
+            value(static_cast<uint64_t>(v.get<json::number_unsigned_t>()));
+            break;
+        case json::value_t::string:
+            value(v.get_ref<const std::string&>());
+            break;
+        case json::value_t::array:
+            begin_array();
+            for (const auto& item : v) value(item);
+            end_array();
+            break;
+        case json::value_t::object:
+            // nlohmann::json 的对象基于 std::map，迭代顺序即键的字节序
+            begin_object();
+            for (auto it = v.begin(); it != v.end(); ++it) {
+                key(it.key());
+                value(it.value());
+            }
+            end_object();
+            break;
+        case json::value_t::number_float:
+        case json::value_t::binary:
+        case json::value_t::discarded:
+        default: {
+            // 浮点数沿用 nlohmann 的最短往返表示
+            before_value();
+            std::string s = v.dump();
+            put(s.data(), s.size());
+            break;
+        }
+    }
+}
+
+namespace {
+
+class StringSink : public ByteSink {
+public:
+    std::string data;
+    void write(const char* bytes, size_t size) override { data.append(bytes, size); }
+};
+
+} // namespace
+
+void CanonicalJson::write(const json& value, ByteSink& sink) {
+    JsonWriter writer(sink);
+    writer.value(value);
+    writer.flush();
+}
+
+void CanonicalJson::write_pretty(const json& value, ByteSink& sink, int indent) {
+    JsonWriter writer(sink, indent);
+    writer.value(value);
+    writer.flush();
+}
+
+std::string CanonicalJson::dump(const json& value) {
+    StringSink sink;
+    write(value, sink);
+    return std::move(sink.data);
+}
+
+} // namespace cardity
@@ -0,0 +1,107 @@
+#ifndef CARDITY_CANONICAL_JSON_H
+#define CARDITY_CANONICAL_JSON_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+namespace cardity {
+
+using json = nlohmann::json;
+
+// 字节输出端：哈希器、文件、字符串等
+class ByteSink {
+public:
+    virtual ~ByteSink() = default;
+    virtual void write(const char* data, size_t size) = 0;
+};
+
+// 写入 std::ostream
+class OstreamSink : public ByteSink {
+public:
+    explicit OstreamSink(std::ostream& os) : os_(os) {}
+    void write(const char* data, size_t size) override { os_.write(data, static_cast<std::streamsize>(size)); }
+private:
+    std::ostream& os_;
+};
+
+// 写入文件描述符；失败时抛异常
+class FdSink : public ByteSink {
+public:
+    explicit FdSink(int fd) : fd_(fd) {}
+    void write(const char* data, size_t size) override;
+private:
+    int fd_;
+};
+
+// 流式 JSON 写出器：按调用顺序直接输出，不构建 DOM。
+// indent < 0 为紧凑格式；indent >= 0 的排版与 json::dump(indent) 一致。
+// 调用方负责按字节序给出对象键，才能得到规范化输出。
+class JsonWriter {
+public:
+    explicit JsonWriter(ByteSink& sink, int indent = -1);
+    ~JsonWriter();
+    JsonWriter(const JsonWriter&) = delete;
+    JsonWriter& operator=(const JsonWriter&) = delete;
+
+    void begin_object();
+    void end_object();
+    void begin_array();
+    void end_array();
+    void key(const std::string& name);
+
+    void value(const std::string& s);
+    void value(const char* s);
+    void value(bool b);
+    void value(int64_t n);
+    void value(uint64_t n);
+    void value(int n) { value(static_cast<int64_t>(n)); }
+    void value_null();
+    // 写出已有的 DOM 值（对象键按字节序）
+    void value(const json& v);
+    void value(const std::vector<std::string>& items);
+
+    // 写出原始字节（例如结尾换行）
+    void raw(const char* data, size_t size);
+    void flush();
+
+private:
+    struct Level {
+        bool object;
+        size_t count;
+    };
+
+    void before_value();
+    void close(char bracket);
+    void newline_indent(size_t depth);
+    void put(char c);
+    void put(const char* data, size_t size);
+    void put_string(const std::string& s);
+
+    ByteSink& sink_;
+    int indent_;
+    std::vector<Level> stack_;
+    bool after_key_ = false;
+    char buffer_[4096];
+    size_t used_ = 0;
+};
+
+// 规范化 JSON：对象键按字节序排序、无空白、最小转义（与 json::dump() 紧凑输出一致），
+// 直接分块写入 ByteSink，不生成完整的中间字符串
+class CanonicalJson {
+public:
+    static void write(const json& value, ByteSink& sink);
+
+    // 与 json::dump(indent) 一致的排版输出
+    static void write_pretty(const json& value, ByteSink& sink, int indent = 2);
+
+    // 规范化字符串（调试/小数据用）
+    static std::string dump(const json& value);
+};
+
+} // namespace cardity
+
+#endif // CARDITY_CANONICAL_JSON_H
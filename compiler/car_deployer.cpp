@@ -3,12 +3,48 @@
 #include <fstream>
 #include <sstream>
 #include <iomanip>
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "ast.h"
 #include "carc_generator.h"
+#include "codec.h"
+#include "sha256.h"
+#include "dogecoin_tx.h"
 
 namespace cardity {
 
+namespace {
+
+// WIF（先主网后测试网）或 64 位 hex 私钥
+Secp256k1Key parse_private_key(const std::string& private_key) {
+    std::vector<uint8_t> secret;
+    if (private_key.size() == 64 && Codec::hex_decode(private_key, secret)) {
+        return Secp256k1Key(secret);
+    }
+    try {
+        return Secp256k1Key::from_wif(private_key, DogecoinNetwork::mainnet());
+    } catch (const std::exception&) {
+        return Secp256k1Key::from_wif(private_key, DogecoinNetwork::testnet());
+    }
+}
+
+// 地址 -> 公钥哈希；不是主网/测试网 P2PKH 地址时返回 false
+bool address_pubkey_hash(const std::string& address, std::vector<uint8_t>& pubkey_hash) {
+    std::vector<uint8_t> payload;
+    if (!Base58::decode_check(address, payload) || payload.size() != 21) {
+        return false;
+    }
+    if (payload[0] != DogecoinNetwork::mainnet().p2pkh_prefix &&
+        payload[0] != DogecoinNetwork::testnet().p2pkh_prefix) {
+        return false;
+    }
+    pubkey_hash.assign(payload.begin() + 1, payload.end());
+    return true;
+}
+
+} // namespace
+
 // CarDeployer 实现
 CarDeployer::CarDeployer(const std::string& protocol, const std::string& ver) 
     : protocol_name(protocol), version(ver) {}
@@ -66,7 +102,7 @@ CarFile CarDeployer::create_deployment_package(const std::string& car_file_path)
     car_file.abi = abi_gen.generate_abi();
     
     // 计算哈希
-    car_file.hash = calculate_hash(car_data);
+    car_file.hash = content_hash(car_file);
     
     return car_file;
 }
@@ -112,7 +148,7 @@ CarFile CarDeployer::create_deployment_package_from_json(const json& car_data) {
     car_file.abi = abi_gen.generate_abi();
     
     // 计算哈希
-    car_file.hash = calculate_hash(car_data);
+    car_file.hash = content_hash(car_file);
     
     return car_file;
 }
@@ -165,96 +201,212 @@ json CarDeployer::generate_deployment_json(const json& cpl_data) {
 }
 
 std::string CarDeployer::calculate_hash(const json& data) {
-    std::string json_str = data.dump();
-    
-    // 使用简单的哈希函数（实际应用中应使用更安全的哈希算法）
-    std::hash<std::string> hasher;
-    size_t hash_value = hasher(json_str);
-    
-    // 转换为十六进制字符串
-    std::stringstream ss;
-    ss << std::hex << hash_value;
-    
-    return ss.str();
+    // 规范化 JSON 直接流入 SHA-256，不生成中间字符串；结果与平台/标准库无关
+    Sha256 hasher;
+    CanonicalJson::write(data, hasher);
+    return hasher.hex_digest();
+}
+
+std::string CarDeployer::content_hash(const CarFile& car_file) {
+    return calculate_hash(json{{"abi", car_file.abi},
+                               {"cpl", car_file.cpl},
+                               {"protocol", car_file.protocol},
+                               {"version", car_file.version}});
+}
+
+bool CarDeployer::verify_content_hash(const CarFile& car_file) {
+    return !car_file.hash.empty() && content_hash(car_file) == car_file.hash;
+}
+
+std::vector<uint8_t> CarDeployer::signing_digest(const CarFile& car_file) {
+    // owner 不在内容哈希内，单独纳入签名，防止签名被挪用到其他 owner
+    Sha256 hasher;
+    CanonicalJson::write(json{{"hash", car_file.hash},
+                              {"owner", car_file.owner},
+                              {"protocol", car_file.protocol},
+                              {"version", car_file.version}}, hasher);
+    return hasher.digest();
 }
 
 std::string CarDeployer::sign_car_file(const CarFile& car_file, const std::string& private_key) {
-    // 简化的签名实现（实际应用中应使用更安全的签名算法）
-    std::string data_to_sign = car_file.protocol + car_file.version + car_file.hash;
-    
-    // 这里应该使用实际的签名算法
-    // 暂时返回一个模拟签名
-    return "signature_" + calculate_hash(json::object({{"data", data_to_sign}}));
+    Secp256k1Key key = parse_private_key(private_key);
+    return Codec::hex_encode(key.sign(signing_digest(car_file).data()));
+}
+
+std::string CarDeployer::public_key_from_private(const std::string& private_key) {
+    return Codec::hex_encode(parse_private_key(private_key).public_key());
 }
 
 bool CarDeployer::verify_signature(const CarFile& car_file, const std::string& public_key) {
-    // 简化的签名验证实现
-    if (car_file.signature.empty()) {
+    // 签名只覆盖 hash，内容被替换时 hash 不变，必须先核对内容
+    if (car_file.signature.empty() || !verify_content_hash(car_file)) {
+        return false;
+    }
+    std::vector<uint8_t> signature;
+    if (!Codec::hex_decode(car_file.signature, signature)) {
         return false;
     }
     
-    // 这里应该使用实际的签名验证算法
-    return car_file.signature.find("signature_") == 0;
+    // 公钥 hex 直接验签；地址则要求 signer 与地址匹配
+    std::vector<uint8_t> key;
+    std::string expected = public_key.empty() ? car_file.owner : public_key;
+    std::vector<uint8_t> pubkey_hash;
+    if (address_pubkey_hash(expected, pubkey_hash)) {
+        if (!Codec::hex_decode(car_file.signer, key) || TxHash::hash160(key) != pubkey_hash) {
+            return false;
+        }
+    } else if (!Codec::hex_decode(expected, key)) {
+        return false;
+    }
+    return Secp256k1Key::verify(key, signing_digest(car_file).data(), signature);
 }
 
-std::string CarDeployer::encode_to_base64(const json& car_data) {
-    std::string json_str = car_data.dump();
-    
-    // 简化的 base64 编码（实际应用中应使用标准库）
-    std::string base64_chars = 
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz"
-        "0123456789+/";
-    
-    std::string result;
-    int val = 0, valb = -6;
-    
-    for (unsigned char c : json_str) {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0) {
-            result.push_back(base64_chars[(val >> valb) & 0x3F]);
-            valb -= 6;
+CarFile CarDeployer::load_deployment(const json& deployment) {
+    if (!deployment.is_object() || !deployment.contains("cpl") || !deployment.contains("hash")) {
+        throw std::runtime_error("Invalid deployment file: missing cpl/hash");
+    }
+    CarFile car_file;
+    car_file.protocol = deployment.value("protocol", "unknown");
+    car_file.version = deployment.value("version", "1.0");
+    car_file.owner = deployment.value("owner", "");
+    car_file.cpl = deployment["cpl"];
+    car_file.abi = deployment.value("abi", json::object());
+    car_file.signature = deployment.value("sig", "");
+    car_file.signer = deployment.value("signer", "");
+    car_file.hash = deployment["hash"].get<std::string>();
+    if (!verify_content_hash(car_file)) {
+        throw std::runtime_error("Deployment hash mismatch: content does not match \"hash\"");
+    }
+    return car_file;
+}
+
+// SignatureVerifier 实现
+SignatureVerifier::SignatureVerifier(unsigned jobs)
+    : jobs_(jobs ? jobs : std::max(1u, std::thread::hardware_concurrency())) {}
+
+std::string SignatureVerifier::cache_key(const CarFile& car_file, const std::string& public_key) {
+    // 验签结果只取决于摘要、签名与实际使用的公钥/地址
+    std::string key = Codec::hex_encode(CarDeployer::signing_digest(car_file));
+    key += ':';
+    key += car_file.signature;
+    key += ':';
+    key += public_key.empty() ? car_file.owner : public_key;
+    key += ':';
+    key += car_file.signer;
+    return key;
+}
+
+bool SignatureVerifier::verify(const CarFile& car_file, const std::string& public_key) {
+    // 缓存键不含内容本身：内容与 hash 不符的条目既不查缓存也不写入
+    if (!CarDeployer::verify_content_hash(car_file)) {
+        return false;
+    }
+    std::string key = cache_key(car_file, public_key);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = cache_.find(key);
+        if (it != cache_.end()) {
+            ++hits_;
+            return it->second;
         }
     }
-    
-    if (valb > -6) {
-        result.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
+    bool valid = CarDeployer::verify_signature(car_file, public_key);
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.emplace(std::move(key), valid);
+    return valid;
+}
+
+std::vector<bool> SignatureVerifier::verify_batch(const std::vector<CarFile>& car_files,
+                                                  const std::vector<std::string>& public_keys) {
+    if (!public_keys.empty() && public_keys.size() != car_files.size()) {
+        throw std::runtime_error("verify_batch: public_keys must match car_files");
+    }
+    static const std::string by_owner;
+    auto public_key = [&](size_t i) -> const std::string& {
+        return public_keys.empty() ? by_owner : public_keys[i];
+    };
+    
+    // 内容哈希不依赖缓存，先于查缓存核对；不符的条目直接判为失败且不缓存
+    std::vector<char> intact(car_files.size(), 0);
+    for (size_t i = 0; i < car_files.size(); ++i) {
+        intact[i] = CarDeployer::verify_content_hash(car_files[i]) ? 1 : 0;
     }
     
-    while (result.size() % 4) {
-        result.push_back('=');
+    // 先查缓存，批内重复的条目只验一次
+    std::vector<std::string> keys(car_files.size());
+    std::vector<bool> results(car_files.size(), false);
+    std::vector<size_t> pending;
+    std::unordered_map<std::string, size_t> first_pending;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < car_files.size(); ++i) {
+            if (!intact[i]) continue;
+            keys[i] = cache_key(car_files[i], public_key(i));
+            auto it = cache_.find(keys[i]);
+            if (it != cache_.end()) {
+                ++hits_;
+                results[i] = it->second;
+            } else if (first_pending.emplace(keys[i], pending.size()).second) {
+                pending.push_back(i);
+            }
+        }
     }
     
-    return result;
+    // 各条目互不依赖：按下标分发给工作线程
+    std::vector<char> verified(pending.size(), 0);
+    unsigned workers = static_cast<unsigned>(std::min<size_t>(jobs_, pending.size()));
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t n = next++; n < pending.size(); n = next++) {
+            size_t i = pending[n];
+            verified[n] = CarDeployer::verify_signature(car_files[i], public_key(i)) ? 1 : 0;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < workers; ++t) threads.emplace_back(worker);
+    worker();
+    for (auto& th : threads) th.join();
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t n = 0; n < pending.size(); ++n) {
+        cache_[keys[pending[n]]] = verified[n] != 0;
+    }
+    for (size_t i = 0; i < car_files.size(); ++i) {
+        if (!intact[i]) continue;
+        auto it = first_pending.find(keys[i]);
+        if (it != first_pending.end()) {
+            results[i] = verified[it->second] != 0;
+        }
+    }
+    return results;
+}
+
+size_t SignatureVerifier::cache_size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cache_.size();
+}
+
+size_t SignatureVerifier::cache_hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+void SignatureVerifier::clear_cache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cache_.clear();
+    hits_ = 0;
+}
+
+std::string CarDeployer::encode_to_base64(const json& car_data) {
+    return Codec::base64_encode(car_data.dump());
 }
 
 json CarDeployer::decode_from_base64(const std::string& base64_data) {
-    // 简化的 base64 解码
-    std::string base64_chars = 
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz"
-        "0123456789+/";
-    
-    std::string result;
-    int val = 0, valb = -8;
-    
-    for (unsigned char c : base64_data) {
-        if (c == '=') break;
-        
-        auto it = base64_chars.find(c);
-        if (it == std::string::npos) continue;
-        
-        val = (val << 6) + it;
-        valb += 6;
-        
-        if (valb >= 0) {
-            result.push_back(char((val >> valb) & 0xFF));
-            valb -= 8;
-        }
+    std::vector<uint8_t> bytes;
+    if (!Codec::base64_decode(base64_data, bytes)) {
+        throw std::runtime_error("Invalid base64 data");
     }
-    
-    return json::parse(result);
+    return json::parse(bytes.begin(), bytes.end());
 }
 
 json CarDeployer::generate_inscription_format(const CarFile& car_file) {
@@ -318,31 +470,7 @@ json CarDeployer::generate_inscription_format(const CarFile& car_file) {
             }
         }
         std::vector<uint8_t> carc_bytes = CarcGenerator::compile_to_carc(protocol);
-        // base64 编码字节
-        std::string carc_data(reinterpret_cast<const char*>(carc_bytes.data()), carc_bytes.size());
-        // 复用现有字符串编码方法
-        json tmp = json::object();
-        tmp["raw"] = carc_data; // 占位
-        // 直接对 carc_data 编码
-        std::string base64_chars =
-            "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-            "abcdefghijklmnopqrstuvwxyz"
-            "0123456789+/";
-        std::string result;
-        int val = 0, valb = -6;
-        for (unsigned char c : carc_bytes) {
-            val = (val << 8) + c;
-            valb += 8;
-            while (valb >= 0) {
-                result.push_back(base64_chars[(val >> valb) & 0x3F]);
-                valb -= 6;
-            }
-        }
-        if (valb > -6) {
-            result.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
-        }
-        while (result.size() % 4) result.push_back('=');
-        inscription["carc_b64"] = result;
+        inscription["carc_b64"] = Codec::base64_encode(carc_bytes);
     } catch (...) {
         // 忽略 .carc 编码失败
     }
@@ -366,27 +494,40 @@ bool CarDeployer::validate_car_format(const json& car_data) {
 }
 
 void CarDeployer::export_to_file(const CarFile& car_file, const std::string& output_path) {
-    json output_data;
-    output_data["protocol"] = car_file.protocol;
-    output_data["version"] = car_file.version;
-    output_data["cpl"] = car_file.cpl;
-    output_data["abi"] = car_file.abi;
-    output_data["hash"] = car_file.hash;
+    std::ofstream ofs(output_path);
+    if (!ofs.is_open()) {
+        throw std::runtime_error("Failed to open output file: " + output_path);
+    }
     
+    // 直接流式写出，避免复制 cpl/abi 再整体 dump；键按字节序排列
+    OstreamSink sink(ofs);
+    JsonWriter w(sink, 2);
+    w.begin_object();
+    w.key("abi");
+    w.value(car_file.abi);
+    w.key("cpl");
+    w.value(car_file.cpl);
+    w.key("hash");
+    w.value(car_file.hash);
     if (!car_file.owner.empty()) {
-        output_data["owner"] = car_file.owner;
+        w.key("owner");
+        w.value(car_file.owner);
     }
-    
+    w.key("protocol");
+    w.value(car_file.protocol);
     if (!car_file.signature.empty()) {
-        output_data["sig"] = car_file.signature;
+        w.key("sig");
+        w.value(car_file.signature);
     }
-    
-    std::ofstream ofs(output_path);
-    if (!ofs.is_open()) {
-        throw std::runtime_error("Failed to open output file: " + output_path);
+    if (!car_file.signer.empty()) {
+        w.key("signer");
+        w.value(car_file.signer);
     }
-    
-    ofs << output_data.dump(2) << std::endl;
+    w.key("version");
+    w.value(car_file.version);
+    w.end_object();
+    w.flush();
+    ofs << std::endl;
 }
 
 // WASMClient 实现
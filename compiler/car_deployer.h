@@ -2,6 +2,8 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
+#include <unordered_map>
 #include <nlohmann/json.hpp>
 #include "event_system.h"
 
@@ -16,7 +18,8 @@ struct CarFile {
     std::string owner;
     json cpl;  // 协议逻辑
     json abi;  // 接口定义
-    std::string signature;  // 可选签名
+    std::string signature;  // 可选签名（DER hex）
+    std::string signer;     // 签名公钥（hex），用于按 owner 地址验签
     std::string hash;      // 文件哈希
     
     CarFile() = default;
@@ -45,15 +48,32 @@ public:
     // 生成完整的 .car 部署文件
     json generate_deployment_json(const json& cpl_data);
     
-    // 计算文件哈希
+    // 计算内容哈希：规范化 JSON 的 SHA-256（hex）
     static std::string calculate_hash(const json& data);
     
-    // 签名 .car 文件（可选）
+    // 部署包的内容哈希：对 {abi, cpl, protocol, version} 计算，加载时可由内容重新得出
+    static std::string content_hash(const CarFile& car_file);
+    
+    // hash 字段是否与 cpl/abi 等内容一致（验签前必须先通过）
+    static bool verify_content_hash(const CarFile& car_file);
+    
+    // 签名摘要：规范化 {hash, owner, protocol, version} 的 SHA-256（32 字节）
+    static std::vector<uint8_t> signing_digest(const CarFile& car_file);
+    
+    // 签名 .car 文件（可选）：secp256k1 + RFC 6979，返回 low-S DER hex
+    // private_key 为 WIF（主网/测试网）或 64 位 hex
     static std::string sign_car_file(const CarFile& car_file, const std::string& private_key);
     
-    // 验证签名
+    // 私钥对应的压缩公钥 hex（写入 CarFile::signer）
+    static std::string public_key_from_private(const std::string& private_key);
+    
+    // 验证签名：public_key 为公钥 hex，或 Dogecoin 地址（此时用 signer 验签并要求其哈希与地址一致）；
+    // public_key 为空时按 owner 地址验证。内容与 hash 不符时直接返回 false
     static bool verify_signature(const CarFile& car_file, const std::string& public_key);
     
+    // 从导出的部署 JSON（export_to_file 格式）读取；由内容重新计算哈希，与 hash 字段不符时抛出异常
+    static CarFile load_deployment(const json& deployment);
+    
     // 编码为 base64（用于链上嵌入）
     static std::string encode_to_base64(const json& car_data);
     
@@ -70,6 +90,30 @@ public:
     static void export_to_file(const CarFile& car_file, const std::string& output_path);
 };
 
+// 批量验签器：多线程并行验证，结果按（签名摘要, 签名, 公钥）缓存，重复同步时直接命中
+class SignatureVerifier {
+public:
+    explicit SignatureVerifier(unsigned jobs = 0);    // 0 表示使用硬件并发数
+    
+    bool verify(const CarFile& car_file, const std::string& public_key = "");
+    
+    // public_keys 为空时全部按各自 owner 验证，否则与 car_files 一一对应
+    std::vector<bool> verify_batch(const std::vector<CarFile>& car_files,
+                                   const std::vector<std::string>& public_keys = {});
+    
+    size_t cache_size() const;
+    size_t cache_hits() const;
+    void clear_cache();
+    
+private:
+    static std::string cache_key(const CarFile& car_file, const std::string& public_key);
+    
+    unsigned jobs_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, bool> cache_;
+    size_t hits_ = 0;
+};
+
 // WASM 客户端接口定义
 class WASMClient {
 private:
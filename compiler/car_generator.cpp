@@ -1,8 +1,43 @@
 #include "car_generator.h"
 #include <iostream>
+#include <map>
 
 namespace cardity {
 
+Protocol CarGenerator::from_ast(const ProtocolAST& ast) {
+    Protocol protocol;
+    protocol.name = ast.protocol_name;
+    protocol.metadata.version = ast.version;
+    protocol.metadata.owner = ast.owner;
+    // 传递 imports/using 到 Protocol
+    protocol.imports = ast.imports;
+    protocol.using_aliases = ast.using_aliases;
+    
+    // 转换状态变量
+    for (const auto& state_var : ast.state_variables) {
+        StateVariable var;
+        var.name = state_var.name;
+        var.type = state_var.type;
+        var.default_value = state_var.default_value;
+        protocol.state.variables.push_back(var);
+    }
+    
+    // 转换方法
+    for (const auto& method_ast : ast.methods) {
+        Method method;
+        method.name = method_ast.name;
+        method.params = method_ast.params;
+        method.param_types = method_ast.param_types;
+        method.logic_lines.push_back(method_ast.logic);
+        // 传递可选返回定义
+        method.return_expr = method_ast.return_expr;
+        method.return_type = method_ast.return_type;
+        protocol.methods.push_back(method);
+    }
+    
+    return protocol;
+}
+
 json CarGenerator::compile_to_car(const Protocol& protocol) {
     json car;
     car["p"] = "cardinals";
@@ -76,4 +111,135 @@ std::string CarGenerator::to_string(const json& car_json) {
     return car_json.dump(2); // 使用2个空格缩进
 }
 
+namespace {
+
+// 按名称排序、同名取最后一个（与 json 对象赋值语义一致）
+template <typename T>
+std::map<std::string, const T*> index_by_name(const std::vector<T>& items) {
+    std::map<std::string, const T*> index;
+    for (const auto& item : items) index[item.name] = &item;
+    return index;
+}
+
+} // namespace
+
+void CarGenerator::write_car(const Protocol& protocol, JsonWriter& w) {
+    // 各层键均按字节序输出：cpl < op < p < protocol < version
+    w.begin_object();
+    w.key("cpl");
+    w.begin_object();
+    if (!protocol.imports.empty()) {
+        w.key("imports");
+        w.value(protocol.imports);
+    }
+
+    w.key("methods");
+    auto methods = index_by_name(protocol.methods);
+    if (methods.empty()) {
+        w.value_null();
+    } else {
+        w.begin_object();
+        for (const auto& entry : methods) {
+            const Method& method = *entry.second;
+            w.key(entry.first);
+            w.begin_object();
+            w.key("logic");
+            if (method.logic_lines.size() == 1) {
+                w.value(method.logic_lines[0]);
+            } else {
+                w.value(method.logic_lines);
+            }
+            if (!method.param_types.empty()) {
+                w.key("param_types");
+                w.value(method.param_types);
+            }
+            w.key("params");
+            w.value(method.params);
+            if (!method.return_expr.empty() || !method.return_type.empty()) {
+                w.key("returns");
+                w.begin_object();
+                if (!method.return_expr.empty()) {
+                    w.key("expr");
+                    w.value(method.return_expr);
+                }
+                if (!method.return_type.empty()) {
+                    w.key("type");
+                    w.value(method.return_type);
+                }
+                w.end_object();
+            }
+            w.end_object();
+        }
+        w.end_object();
+    }
+
+    w.key("owner");
+    w.value(protocol.metadata.owner);
+
+    w.key("state");
+    auto variables = index_by_name(protocol.state.variables);
+    if (variables.empty()) {
+        w.value_null();
+    } else {
+        w.begin_object();
+        for (const auto& entry : variables) {
+            w.key(entry.first);
+            w.begin_object();
+            w.key("default");
+            w.value(entry.second->default_value);
+            w.key("type");
+            w.value(entry.second->type);
+            w.end_object();
+        }
+        w.end_object();
+    }
+
+    if (!protocol.using_aliases.empty()) {
+        w.key("using");
+        w.begin_array();
+        for (const auto& pr : protocol.using_aliases) {
+            w.begin_object();
+            w.key("alias");
+            w.value(pr.second);
+            w.key("module");
+            w.value(pr.first);
+            w.end_object();
+        }
+        w.end_array();
+    }
+    w.end_object();
+
+    w.key("op");
+    w.value("deploy");
+    w.key("p");
+    w.value("cardinals");
+    w.key("protocol");
+    w.value(protocol.name);
+    w.key("version");
+    w.value(protocol.metadata.version);
+    w.end_object();
+}
+
+void CarGenerator::write_car(const Protocol& protocol, std::ostream& os, int indent) {
+    OstreamSink sink(os);
+    JsonWriter writer(sink, indent);
+    write_car(protocol, writer);
+    writer.flush();
+}
+
+Protocol CarGenerator::normalize(const Protocol& protocol) {
+    Protocol normalized;
+    normalized.name = protocol.name;
+    normalized.metadata = protocol.metadata;
+    normalized.imports = protocol.imports;
+    normalized.using_aliases = protocol.using_aliases;
+    for (const auto& entry : index_by_name(protocol.state.variables)) {
+        normalized.state.variables.push_back(*entry.second);
+    }
+    for (const auto& entry : index_by_name(protocol.methods)) {
+        normalized.methods.push_back(*entry.second);
+    }
+    return normalized;
+}
+
 } // namespace cardity 
\ No newline at end of file
@@ -2,6 +2,9 @@
 #define CARDITY_CAR_GENERATOR_H
 
 #include "ast.h"
+#include "parser_ast.h"
+#include "canonical_json.h"
+#include <ostream>
 #include <nlohmann/json.hpp>
 
 namespace cardity {
@@ -12,9 +15,21 @@ class CarGenerator {
 public:
     // 将 Protocol AST 编译为 Cardinals .car JSON 格式
     static json compile_to_car(const Protocol& protocol);
+
+    // 将解析器输出的 ProtocolAST 转换为 Protocol
+    static Protocol from_ast(const ProtocolAST& ast);
     
     // 将 JSON 转换为字符串
     static std::string to_string(const json& car_json);
+
+    // 直接从 Protocol 流式写出 .car JSON，不构建 DOM；
+    // 键按字节序输出，与 compile_to_car(protocol).dump(indent) 逐字节一致
+    static void write_car(const Protocol& protocol, JsonWriter& writer);
+    static void write_car(const Protocol& protocol, std::ostream& os, int indent = 2);
+
+    // 按 .car JSON 的语义规整 Protocol：状态变量与方法按名称排序、同名取最后一个。
+    // 顺序与 .car JSON 往返后一致，可直接用于生成 .carc
+    static Protocol normalize(const Protocol& protocol);
     
 private:
     // 编译状态块
@@ -2,9 +2,68 @@
 #include <fstream>
 #include <iostream>
 #include <cstring>
+#include <stdexcept>
+#include <zstd.h>
 
 namespace cardity {
 
+namespace {
+
+// 内置压缩字典（DICT_ID = 1），以 zstd 原始内容字典方式使用。
+// 内容取自文档示例与 examples/ 编译出的 .carc 中高频出现的片段：
+// v1 头部、长度前缀的常见状态变量/类型/默认值，以及 token 以空格连接的方法逻辑。
+// 越常用的片段越靠后（匹配距离更短）。修改内容必须同时更换 DICT_ID，已发布的字典不可变更。
+const char CARC_DICT_V1[] =
+    "CRAC\001\000\000\000\005\000\000\000owner\007\000\000\000address\005\000\000\000doge1\004"
+    "\000\000\000name\006\000\000\000string\000\000\000\000\006\000\000\000symbol\006\000\000"
+    "\000string\000\000\000\000\010\000\000\000decimals\003\000\000\000int\001\000\000\0008\006"
+    "\000\000\000paused\004\000\000\000bool\005\000\000\000false\014\000\000\000total_supply\003"
+    "\000\000\000int\001\000\000\0000\007\000\000\000balance\003\000\000\000int\001\000\000\000"
+    "0\005\000\000\000count\003\000\000\000int\001\000\000\0000\003\000\000\000int\001\000\000"
+    "\0000\006\000\000\000string\000\000\000\000\004\000\000\000bool\005\000\000\000false\004"
+    "\000\000\000bool\004\000\000\000true\007\000\000\000address\000\000\000\000return state "
+    ".  ; return let  ; } else { ctx . block_heightctx . txidctx . senderemit Approval ( ctx "
+    ". sender , params . spender , params . amount ) emit Transfer ( ctx . sender , params . "
+    "to , params . amount ) if ( params . amount <= 0 ) { state . _result = InvalidAmount } i"
+    "f ( state . paused == true ) { state . _result = Paused } if ( state . balances [ ctx . "
+    "sender ] < params . amount ) { state . _result = Insufficient } state . allowances [ sta"
+    "te . balances [ ctx . sender ] = state . balances [ ctx . sender ] - params . amount } s"
+    "tate . balances [ params . to ] = state . balances [ params . to ] + params . amount } s"
+    "tate . total_supply = state . total_supply + params . amount } state . count = state . c"
+    "ount + 1 ; state . balance = state . balance + params . amount ; state . owner == ctx . "
+    "sender == true ) { state . _result =  == false  !=  >=  >  <  &&  || params . spenderpar"
+    "ams . fromparams . valueparams . userparams . toparams . amountstate . _result = ok ; if"
+    " ( state . _result == ok ) { state . _result == ok ) { state .  ) { state . _result = em"
+    "it  ,  ) ; } ) } + 1 ;  -  +  = state . if ( state . if ( params . state . balances [  ]"
+    " = state . balances [ state . params . ";
+
+// 解压上限，防止恶意数据声明超大尺寸
+const uint32_t MAX_RAW_SIZE = 64u * 1024 * 1024;
+
+uint32_t load_uint32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+const ZSTD_DDict* carc_ddict() {
+    // DDict 只读，可跨线程共享
+    static const struct Holder {
+        ZSTD_DDict* dict = ZSTD_createDDict(CARC_DICT_V1, sizeof(CARC_DICT_V1) - 1);
+        ~Holder() { ZSTD_freeDDict(dict); }
+    } holder;
+    return holder.dict;
+}
+
+// 解压上下文分配代价较高，每个线程复用一个
+ZSTD_DCtx* thread_dctx() {
+    thread_local struct Holder {
+        ZSTD_DCtx* ctx = ZSTD_createDCtx();
+        ~Holder() { ZSTD_freeDCtx(ctx); }
+    } holder;
+    return holder.ctx;
+}
+
+} // namespace
+
 std::vector<uint8_t> CarcGenerator::compile_to_carc(const Protocol& protocol) {
     std::vector<uint8_t> data;
     
@@ -65,6 +124,85 @@ bool CarcGenerator::write_to_file(const std::vector<uint8_t>& carc_data, const s
     return true;
 }
 
+bool CarcGenerator::is_compressed(const std::vector<uint8_t>& carc_data) {
+    return carc_data.size() >= 8 && load_uint32(carc_data.data()) == MAGIC &&
+           load_uint32(carc_data.data() + 4) == VERSION_COMPRESSED;
+}
+
+std::vector<uint8_t> CarcGenerator::compress(const std::vector<uint8_t>& carc_data, int level) {
+    if (is_compressed(carc_data)) {
+        return carc_data;
+    }
+    if (carc_data.size() < 8 || load_uint32(carc_data.data()) != MAGIC) {
+        throw std::runtime_error("Invalid .carc data: wrong magic number");
+    }
+    if (carc_data.size() > MAX_RAW_SIZE) {
+        throw std::runtime_error(".carc data too large to compress");
+    }
+    
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+    if (!cctx) {
+        throw std::runtime_error("Failed to create zstd context");
+    }
+    // 尺寸与字典编号已写在 v2 头部，帧内不再重复
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level);
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_contentSizeFlag, 0);
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 0);
+    ZSTD_CCtx_setParameter(cctx, ZSTD_c_dictIDFlag, 0);
+    size_t rc = ZSTD_CCtx_loadDictionary(cctx, CARC_DICT_V1, sizeof(CARC_DICT_V1) - 1);
+    
+    std::vector<uint8_t> data;
+    write_uint32(data, MAGIC);
+    write_uint32(data, VERSION_COMPRESSED);
+    write_uint32(data, DICT_ID);
+    write_uint32(data, static_cast<uint32_t>(carc_data.size()));
+    size_t header_size = data.size();
+    data.resize(header_size + ZSTD_compressBound(carc_data.size()));
+    if (!ZSTD_isError(rc)) {
+        rc = ZSTD_compress2(cctx, data.data() + header_size, data.size() - header_size,
+                            carc_data.data(), carc_data.size());
+    }
+    ZSTD_freeCCtx(cctx);
+    if (ZSTD_isError(rc)) {
+        throw std::runtime_error(std::string("zstd compression failed: ") + ZSTD_getErrorName(rc));
+    }
+    data.resize(header_size + rc);
+    return data;
+}
+
+std::vector<uint8_t> CarcGenerator::decompress(const std::vector<uint8_t>& carc_data) {
+    if (!is_compressed(carc_data)) {
+        return carc_data;
+    }
+    if (carc_data.size() < 16) {
+        throw std::runtime_error("Invalid .carc file: truncated header");
+    }
+    uint32_t dict_id = load_uint32(carc_data.data() + 8);
+    uint32_t raw_size = load_uint32(carc_data.data() + 12);
+    if (dict_id != DICT_ID) {
+        throw std::runtime_error("Unsupported .carc dictionary: " + std::to_string(dict_id));
+    }
+    if (raw_size > MAX_RAW_SIZE) {
+        throw std::runtime_error("Invalid .carc file: declared size too large");
+    }
+    
+    const ZSTD_DDict* ddict = carc_ddict();
+    ZSTD_DCtx* dctx = thread_dctx();
+    if (!ddict || !dctx) {
+        throw std::runtime_error("Failed to create zstd context");
+    }
+    std::vector<uint8_t> raw(raw_size);
+    size_t rc = ZSTD_decompress_usingDDict(dctx, raw.data(), raw.size(),
+                                           carc_data.data() + 16, carc_data.size() - 16, ddict);
+    if (ZSTD_isError(rc)) {
+        throw std::runtime_error(std::string("Invalid .carc file: ") + ZSTD_getErrorName(rc));
+    }
+    if (rc != raw_size) {
+        throw std::runtime_error("Invalid .carc file: size mismatch after decompression");
+    }
+    return raw;
+}
+
 Protocol CarcGenerator::parse_from_carc(const std::string& filename) {
     std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
@@ -80,6 +218,16 @@ Protocol CarcGenerator::parse_from_carc(const std::string& filename) {
     file.read(reinterpret_cast<char*>(data.data()), file_size);
     file.close();
     
+    return parse_carc_data(data);
+}
+
+Protocol CarcGenerator::parse_carc_data(const std::vector<uint8_t>& carc_data) {
+    // 压缩格式先还原为 v1 映像
+    std::vector<uint8_t> data = decompress(carc_data);
+    if (data.size() < 28) {
+        throw std::runtime_error("Invalid .carc file: truncated header");
+    }
+    
     // 解析头部
     size_t offset = 0;
     CarcHeader header;
@@ -11,7 +11,7 @@ namespace cardity {
 // .carc 文件格式结构
 struct CarcHeader {
     uint32_t magic;           // 魔数: 0x43415243 ("CARC")
-    uint32_t version;         // 版本号: 1
+    uint32_t version;         // 版本号: 1（未压缩）
     uint32_t protocol_len;    // 协议名长度
     uint32_t owner_len;       // 所有者地址长度
     uint32_t state_size;      // 状态变量数量
@@ -19,6 +19,14 @@ struct CarcHeader {
     uint32_t total_size;      // 文件总大小
 };
 
+// 压缩 .carc（版本 2）头部：其后是用共享字典压缩的完整 v1 映像
+struct CarcCompressedHeader {
+    uint32_t magic;           // 魔数: 0x43415243 ("CARC")
+    uint32_t version;         // 版本号: 2
+    uint32_t dict_id;         // 压缩字典编号
+    uint32_t raw_size;        // 解压后的 v1 映像大小
+};
+
 struct CarcStateVar {
     uint32_t name_len;        // 变量名长度
     uint32_t type_len;        // 类型长度
@@ -35,15 +43,32 @@ struct CarcMethod {
 
 class CarcGenerator {
 public:
+    static constexpr uint32_t MAGIC = 0x43415243;
+    static constexpr uint32_t VERSION_RAW = 1;
+    static constexpr uint32_t VERSION_COMPRESSED = 2;
+    static constexpr uint32_t DICT_ID = 1;    // 当前内置字典编号
+
     // 将 Protocol AST 编译为 .carc 二进制格式
     static std::vector<uint8_t> compile_to_carc(const Protocol& protocol);
     
+    // 将 v1 .carc 压缩为 v2（zstd + 内置字典）；已压缩的数据原样返回
+    static std::vector<uint8_t> compress(const std::vector<uint8_t>& carc_data, int level = 19);
+    
+    // 解压 v2 .carc 为 v1 映像；v1 数据原样返回
+    static std::vector<uint8_t> decompress(const std::vector<uint8_t>& carc_data);
+    
+    // 是否为压缩格式
+    static bool is_compressed(const std::vector<uint8_t>& carc_data);
+    
     // 将 .carc 二进制数据写入文件
     static bool write_to_file(const std::vector<uint8_t>& carc_data, const std::string& filename);
     
-    // 从 .carc 文件读取并解析
+    // 从 .carc 文件读取并解析（自动识别压缩格式）
     static Protocol parse_from_carc(const std::string& filename);
     
+    // 从内存中的 .carc 数据解析（自动识别压缩格式）
+    static Protocol parse_carc_data(const std::vector<uint8_t>& carc_data);
+    
 private:
     // 写入字符串到二进制数据
     static void write_string(std::vector<uint8_t>& data, const std::string& str);
@@ -3,16 +3,31 @@
 #include <cstring>
 #include <fstream>
 #include <sstream>
-#include <regex>
 #include <filesystem>
 #include <map>
 #include <set>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <csignal>
+#include <cerrno>
+#include <fcntl.h>
+#include <functional>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
 #include "car_deployer.h"
 #include "parser.h"
 #include "tokenizer.h"
 #include "car_generator.h"
 #include "carc_generator.h"
 #include "event_system.h"
+#include "optimizer.h"
+#include "sha256.h"
 
 using namespace cardity;
 
@@ -33,6 +48,11 @@ void print_usage(const std::string& program_name) {
     std::cout << "  --validate    - Validate protocol format only" << std::endl;
     std::cout << "  --format <fmt> - Output format: carc (binary), json, car, or wasm" << std::endl;
     std::cout << "  --carc        - Generate .carc binary format (default)" << std::endl;
+    std::cout << "  -O, --optimize - Optimize method logic (constant folding, dead-store/no-op elimination)" << std::endl;
+    std::cout << "  --compress    - Write compressed .carc (v2, zstd with built-in dictionary) when smaller" << std::endl;
+    std::cout << "  --serve [socket] - Run as a compile daemon on a Unix socket (default: /tmp/cardityc.sock)" << std::endl;
+    std::cout << "  --batch <dir|list> [--out-dir <dir>] [-j N] [--compress] - Compile many protocols (.carc/.json/.abi.json) in parallel" << std::endl;
+    std::cout << "  --verify-sig <dir|file...> [--key <pubkey|addr>] [-j N] - Verify signed deployment files in parallel (default key: owner)" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << program_name << " protocol.car" << std::endl;
@@ -41,59 +61,136 @@ void print_usage(const std::string& program_name) {
     std::cout << "  " << program_name << " protocol.car --validate" << std::endl;
     std::cout << "  " << program_name << " protocol.car --format json" << std::endl;
     std::cout << "  " << program_name << " protocol.car --format carc" << std::endl;
+    std::cout << "  " << program_name << " protocol.car -O --format json" << std::endl;
+    std::cout << "  " << program_name << " protocol.car -O --compress -o protocol.carc" << std::endl;
+    std::cout << "  " << program_name << " --serve /tmp/cardityc.sock" << std::endl;
+    std::cout << "  " << program_name << " --batch protocols/ --out-dir build/ -j 8" << std::endl;
+    std::cout << "  " << program_name << " --verify-sig deployments/ -j 8" << std::endl;
 }
 
-// 解析编程语言格式的协议
-json parse_programming_language_format(const std::string& content) {
-    std::cout << "🔍 Parsing programming language format..." << std::endl;
+// 解析编程语言格式的协议，得到 Protocol；进度与解析器日志写入 log
+Protocol parse_protocol_source(const std::string& content, bool optimize = false, std::ostream& log = std::cout) {
+    log << "🔍 Parsing programming language format..." << std::endl;
     
     // 创建词法分析器和解析器
     Tokenizer tokenizer(content);
-    Parser parser(tokenizer);
+    Parser parser(tokenizer, log);
     
     // 解析协议
     ProtocolAST ast = parser.parse_protocol();
     
-    std::cout << "✅ Successfully parsed programming language format" << std::endl;
-    std::cout << "📋 Protocol: " << ast.protocol_name << std::endl;
-    std::cout << "📋 Version: " << ast.version << std::endl;
-    std::cout << "📋 Owner: " << ast.owner << std::endl;
+    log << "✅ Successfully parsed programming language format" << std::endl;
+    log << "📋 Protocol: " << ast.protocol_name << std::endl;
+    log << "📋 Version: " << ast.version << std::endl;
+    log << "📋 Owner: " << ast.owner << std::endl;
+
+    // 可选：优化方法逻辑
+    if (optimize) {
+        log << "⚙️  Optimizing method logic..." << std::endl;
+        size_t before = 0, after = 0;
+        for (const auto& report : Optimizer::optimize_protocol(ast)) {
+            before += report.tokens_before;
+            after += report.tokens_after;
+            if (report.changed() || report.skipped) {
+                log << "   " << report.summary() << std::endl;
+            }
+        }
+        log << "✅ Optimized method logic: " << before << " -> " << after << " tokens" << std::endl;
+    }
     
     // 将 AST 转换为 Protocol 对象
+    return CarGenerator::from_ast(ast);
+}
+
+// 解析编程语言格式的协议，得到 .car JSON
+json parse_programming_language_format(const std::string& content, bool optimize = false,
+                                       std::ostream& log = std::cout) {
+    // 使用 CarGenerator 将 Protocol 转换为 JSON
+    return CarGenerator::compile_to_car(parse_protocol_source(content, optimize, log));
+}
+
+// 可选压缩 .carc：仅当 v2 确实更小时采用
+static std::vector<uint8_t> maybe_compress_carc(std::vector<uint8_t> carc_data, bool compress) {
+    if (!compress) return carc_data;
+    std::vector<uint8_t> packed = CarcGenerator::compress(carc_data);
+    return packed.size() < carc_data.size() ? packed : carc_data;
+}
+
+// 以 dump(2) 相同的排版流式写出 JSON 文件（末尾换行）
+static void write_json_file(const std::string& path, const std::function<void(JsonWriter&)>& emit) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to write output file: " + path);
+    }
+    try {
+        FdSink sink(fd);
+        JsonWriter writer(sink, 2);
+        emit(writer);
+        writer.raw("\n", 1);
+        writer.flush();
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) {
+        throw std::runtime_error("Failed to write output file: " + path);
+    }
+}
+
+static void write_json_file(const std::string& path, const json& value) {
+    write_json_file(path, [&](JsonWriter& writer) { writer.value(value); });
+}
+
+// 将 .car JSON 转换回 Protocol 对象（生成 .carc 用）
+static Protocol protocol_from_car_json(const json& car_data) {
     Protocol protocol;
-    protocol.name = ast.protocol_name;
-    protocol.metadata.version = ast.version;
-    protocol.metadata.owner = ast.owner;
-    // 传递 imports/using 到 Protocol
-    protocol.imports = ast.imports;
-    protocol.using_aliases = ast.using_aliases;
+    protocol.name = car_data["protocol"];
+    protocol.metadata.version = car_data["version"];
+    protocol.metadata.owner = car_data["cpl"]["owner"];
     
-    // 转换状态变量
-    for (const auto& state_var : ast.state_variables) {
+    // 解析状态变量
+    json state_json = car_data["cpl"]["state"];
+    for (auto it = state_json.begin(); it != state_json.end(); ++it) {
         StateVariable var;
-        var.name = state_var.name;
-        var.type = state_var.type;
-        var.default_value = state_var.default_value;
+        var.name = it.key();
+        var.type = it.value()["type"];
+        var.default_value = it.value()["default"];
         protocol.state.variables.push_back(var);
     }
     
-    // 转换方法
-    for (const auto& method_ast : ast.methods) {
+    // 解析方法
+    json methods_json = car_data["cpl"]["methods"];
+    for (auto it = methods_json.begin(); it != methods_json.end(); ++it) {
         Method method;
-        method.name = method_ast.name;
-        method.params = method_ast.params;
-        method.param_types = method_ast.param_types;
-        method.logic_lines.push_back(method_ast.logic);
-        // 传递可选返回定义
-        method.return_expr = method_ast.return_expr;
-        method.return_type = method_ast.return_type;
+        method.name = it.key();
+        method.params = it.value()["params"].get<std::vector<std::string>>();
+        method.logic_lines.push_back(it.value()["logic"]);
+        if (it.value().contains("returns")) {
+            if (it.value()["returns"].is_string()) {
+                method.return_expr = it.value()["returns"].get<std::string>();
+            } else if (it.value()["returns"].is_object()) {
+                method.return_expr = it.value()["returns"].value("expr", "");
+                method.return_type = it.value()["returns"].value("type", "");
+            }
+        }
         protocol.methods.push_back(method);
     }
-    
-    // 使用 CarGenerator 将 Protocol 转换为 JSON
-    json car_data = CarGenerator::compile_to_car(protocol);
-    
-    return car_data;
+    return protocol;
+}
+
+// 由 .car JSON 生成 ABI；失败时返回 null
+static json generate_abi_json(const json& car_data) {
+    try {
+        ABIGenerator abi_gen(car_data.value("protocol", ""), car_data.value("version", ""));
+        if (car_data.contains("cpl") && car_data["cpl"].contains("methods")) {
+            abi_gen.set_methods(car_data["cpl"]["methods"]);
+        }
+        // 如有事件定义可在此补充
+        return abi_gen.generate_abi();
+    } catch (...) {
+        // 忽略 ABI 生成失败
+        return json();
+    }
 }
 
 struct ModuleSignature {
@@ -123,77 +220,46 @@ static std::vector<std::string> list_car_files(const std::string& root){
     return files;
 }
 
-static void scan_external_calls(const std::string& logic, std::vector<std::tuple<std::string,std::string,int>>& outCalls){
-    // find alias . method ( ... ) with spaces tolerated
-    std::regex re(R"(([A-Za-z_][A-Za-z0-9_]*)\s*\.\s*([A-Za-z_][A-Za-z0-9_]*)\s*\()");
-    auto begin = std::sregex_iterator(logic.begin(), logic.end(), re);
-    auto end = std::sregex_iterator();
-    for (auto it = begin; it != end; ++it) {
-        auto m = *it;
-        std::string alias = m.str(1);
-        std::string method = m.str(2);
-        // count args by scanning from m.position()+m.length()-1 to matching ')'
-        size_t pos = m.position() + m.length() - 1; // at '('
-        int depth = 0; int argCount = 0; bool inToken = false; bool anyChar=false;
-        for (size_t i = pos; i < logic.size(); ++i) {
-            char c = logic[i];
-            if (c == '(') { depth++; anyChar=true; }
-            else if (c == ')') { if (depth==1) { if (inToken||anyChar) argCount++; } depth--; if (depth<=0) { break; } }
-            else if (c == ',' && depth==1) { argCount++; inToken=false; anyChar=false; }
-            else if (!isspace(static_cast<unsigned char>(c)) && depth>=1) { inToken=true; anyChar=true; }
-        }
-        outCalls.emplace_back(alias, method, argCount);
-    }
-}
-
-static int package_check(const std::string& dir){
-    std::vector<std::string> files = list_car_files(dir);
-    if (files.empty()) {
-        std::cerr << "No .car files found in " << dir << std::endl; return 2;
-    }
-    std::map<std::string, ModuleSignature> registry;
-    std::vector<FileSemanticInfo> fileInfos;
-
-    for (const auto& f : files) {
-        std::string content = read_file_all(f);
-        json car = parse_programming_language_format(content);
-        FileSemanticInfo info; info.path = f; info.moduleName = car.value("protocol", std::string(""));
-        // using aliases
-        if (car.contains("cpl") && car["cpl"].contains("using")) {
-            for (const auto& ua : car["cpl"]["using"]) {
-                std::string mod = ua.value("module", "");
-                std::string alias = ua.value("alias", mod);
-                info.aliasToModule[alias] = mod;
-            }
+// 从编译结果提取模块签名与跨模块调用所需信息
+static FileSemanticInfo collect_semantic_info(const std::string& path, const json& car, ModuleSignature& sig){
+    FileSemanticInfo info; info.path = path; info.moduleName = car.value("protocol", std::string(""));
+    // using aliases
+    if (car.contains("cpl") && car["cpl"].contains("using")) {
+        for (const auto& ua : car["cpl"]["using"]) {
+            std::string mod = ua.value("module", "");
+            std::string alias = ua.value("alias", mod);
+            info.aliasToModule[alias] = mod;
         }
-        // imports
-        if (car.contains("cpl") && car["cpl"].contains("imports")) {
-            for (const auto& im : car["cpl"]["imports"]) {
-                info.imports.insert(im.get<std::string>());
-            }
+    }
+    // imports
+    if (car.contains("cpl") && car["cpl"].contains("imports")) {
+        for (const auto& im : car["cpl"]["imports"]) {
+            info.imports.insert(im.get<std::string>());
         }
-        // own methods
-        if (car.contains("cpl") && car["cpl"].contains("methods")) {
-            ModuleSignature sig;
-            for (auto it = car["cpl"]["methods"].begin(); it != car["cpl"]["methods"].end(); ++it) {
-                std::string mname = it.key();
-                int pc = 0;
-                if (it.value().contains("params") && it.value()["params"].is_array()) pc = static_cast<int>(it.value()["params"].size());
-                sig.methodParamCount[mname] = pc;
-                std::string logicStr;
-                if (it.value().contains("logic")) {
-                    if (it.value()["logic"].is_string()) logicStr = it.value()["logic"].get<std::string>();
-                    else if (it.value()["logic"].is_array()) {
-                        for (const auto& ln : it.value()["logic"]) { logicStr += ln.get<std::string>(); logicStr += '\n'; }
-                    }
+    }
+    // own methods
+    if (car.contains("cpl") && car["cpl"].contains("methods")) {
+        for (auto it = car["cpl"]["methods"].begin(); it != car["cpl"]["methods"].end(); ++it) {
+            std::string mname = it.key();
+            int pc = 0;
+            if (it.value().contains("params") && it.value()["params"].is_array()) pc = static_cast<int>(it.value()["params"].size());
+            sig.methodParamCount[mname] = pc;
+            std::string logicStr;
+            if (it.value().contains("logic")) {
+                if (it.value()["logic"].is_string()) logicStr = it.value()["logic"].get<std::string>();
+                else if (it.value()["logic"].is_array()) {
+                    for (const auto& ln : it.value()["logic"]) { logicStr += ln.get<std::string>(); logicStr += '\n'; }
                 }
-                info.methodLogic.emplace_back(mname, logicStr);
             }
-            registry[info.moduleName] = sig;
+            info.methodLogic.emplace_back(mname, logicStr);
         }
-        fileInfos.push_back(std::move(info));
     }
+    return info;
+}
 
+// 校验跨模块调用：别名/模块/方法存在且参数个数匹配
+static std::vector<std::string> check_external_calls(const std::vector<FileSemanticInfo>& fileInfos,
+                                                     const std::map<std::string, ModuleSignature>& registry){
     std::vector<std::string> errors;
     for (const auto& fi : fileInfos) {
         for (const auto& ml : fi.methodLogic) {
@@ -213,18 +279,39 @@ static int package_check(const std::string& dir){
                     errors.push_back(fi.path + ":" + ml.first + ": Unknown module '" + module + "'");
                     continue;
                 }
-                if (!registry[module].methodParamCount.count(method)) {
+                const auto& counts = registry.at(module).methodParamCount;
+                if (!counts.count(method)) {
                     errors.push_back(fi.path + ":" + ml.first + ": Unknown method '" + module + "." + method + "'");
                     continue;
                 }
-                int expected = registry[module].methodParamCount.at(method);
+                int expected = counts.at(method);
                 if (expected != argc) {
                     errors.push_back(fi.path + ":" + ml.first + ": Argument count mismatch for '" + module + "." + method + "' (expected " + std::to_string(expected) + ", got " + std::to_string(argc) + ")");
                 }
             }
         }
     }
+    return errors;
+}
+
+static int package_check(const std::string& dir){
+    std::vector<std::string> files = list_car_files(dir);
+    if (files.empty()) {
+        std::cerr << "No .car files found in " << dir << std::endl; return 2;
+    }
+    std::map<std::string, ModuleSignature> registry;
+    std::vector<FileSemanticInfo> fileInfos;
+
+    for (const auto& f : files) {
+        std::string content = read_file_all(f);
+        json car = parse_programming_language_format(content);
+        ModuleSignature sig;
+        FileSemanticInfo info = collect_semantic_info(f, car, sig);
+        if (car.contains("cpl") && car["cpl"].contains("methods")) registry[info.moduleName] = sig;
+        fileInfos.push_back(std::move(info));
+    }
 
+    std::vector<std::string> errors = check_external_calls(fileInfos, registry);
     if (!errors.empty()) {
         std::cerr << "❌ Import/using semantic check failed:" << std::endl;
         for (const auto& e : errors) std::cerr << " - " << e << std::endl;
@@ -234,6 +321,516 @@ static int package_check(const std::string& dir){
     return 0;
 }
 
+// ---- 批量编译（cardityc --batch <dir|list> --out-dir <dir> -j N）----
+
+struct BatchJob {
+    std::string input;
+    std::string output_base;   // 不含扩展名
+};
+
+// 收集批量输入：目录（递归 .car，输出保留相对路径）或列表文件（每行一个路径，# 开头为注释）
+static std::vector<BatchJob> collect_batch_jobs(const std::string& source, const std::string& out_dir) {
+    namespace fs = std::filesystem;
+    std::vector<BatchJob> jobs;
+    auto base_for = [&](const fs::path& input, const fs::path& rel) {
+        fs::path base = out_dir.empty() ? input : fs::path(out_dir) / rel;
+        return base.replace_extension().string();
+    };
+
+    if (fs::is_directory(source)) {
+        std::vector<std::string> files = list_car_files(source);
+        std::sort(files.begin(), files.end());
+        for (const auto& f : files) {
+            jobs.push_back({f, base_for(f, fs::relative(f, source))});
+        }
+    } else {
+        std::ifstream ifs(source);
+        if (!ifs.is_open()) throw std::runtime_error("Failed to open batch list: " + source);
+        fs::path list_dir = fs::path(source).parent_path();
+        std::string line;
+        while (std::getline(ifs, line)) {
+            line.erase(0, line.find_first_not_of(" \t\r"));
+            line.erase(line.find_last_not_of(" \t\r") + 1);
+            if (line.empty() || line[0] == '#') continue;
+            fs::path input = fs::path(line).is_absolute() ? fs::path(line) : list_dir / line;
+            jobs.push_back({input.string(), base_for(input, input.filename())});
+        }
+    }
+
+    // 不同输入映射到同一输出时报错，避免互相覆盖
+    std::map<std::string, std::string> seen;
+    for (const auto& job : jobs) {
+        auto [it, inserted] = seen.emplace(job.output_base, job.input);
+        if (!inserted) {
+            throw std::runtime_error("Output collision: " + it->second + " and " + job.input +
+                                     " both map to " + job.output_base);
+        }
+    }
+    return jobs;
+}
+
+// 编译单个模块并写出 .carc / .json / .abi.json；解析日志写入该任务自己的 log
+static json compile_batch_job(const BatchJob& job, bool optimize, bool compress, std::ostream& log) {
+    auto started = std::chrono::steady_clock::now();
+    json result = {{"input", job.input}, {"ok", false}};
+    try {
+        std::ifstream ifs(job.input);
+        if (!ifs.is_open()) throw std::runtime_error("Failed to open input file: " + job.input);
+        std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+        Protocol protocol = parse_protocol_source(content, optimize, log);
+        json car_data = CarGenerator::compile_to_car(protocol);
+        if (!CarDeployer::validate_car_format(car_data)) {
+            throw std::runtime_error("Invalid .car file format");
+        }
+        result["protocol"] = protocol.name;
+
+        std::filesystem::path parent = std::filesystem::path(job.output_base).parent_path();
+        if (!parent.empty()) std::filesystem::create_directories(parent);
+
+        std::string json_path = job.output_base + ".json";
+        write_json_file(json_path, [&](JsonWriter& writer) { CarGenerator::write_car(protocol, writer); });
+
+        std::string carc_path = job.output_base + ".carc";
+        std::vector<uint8_t> carc_data = maybe_compress_carc(
+            CarcGenerator::compile_to_carc(CarGenerator::normalize(protocol)), compress);
+        if (!CarcGenerator::write_to_file(carc_data, carc_path)) {
+            throw std::runtime_error("Failed to write .carc file");
+        }
+
+        json outputs = {{"json", json_path}, {"carc", carc_path}};
+        json abi_json = generate_abi_json(car_data);
+        if (!abi_json.is_null()) {
+            std::string abi_path = job.output_base + ".abi.json";
+            write_json_file(abi_path, abi_json);
+            outputs["abi"] = abi_path;
+        }
+        result["outputs"] = outputs;
+        result["carc_size"] = carc_data.size();
+        result["ok"] = true;
+    } catch (const std::exception& e) {
+        result["error"] = e.what();
+    }
+    result["elapsed_ms"] = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - started).count();
+    return result;
+}
+
+static int batch_compile(const std::string& source, const std::string& out_dir, unsigned jobs_count,
+                         bool optimize, bool compress) {
+    std::vector<BatchJob> jobs;
+    try {
+        jobs = collect_batch_jobs(source, out_dir);
+    } catch (const std::exception& e) {
+        std::cerr << "❌ " << e.what() << std::endl;
+        return 1;
+    }
+    if (jobs.empty()) {
+        std::cerr << "No .car files found in " << source << std::endl;
+        return 2;
+    }
+    if (jobs_count == 0) jobs_count = std::max(1u, std::thread::hardware_concurrency());
+    jobs_count = std::min<unsigned>(jobs_count, static_cast<unsigned>(jobs.size()));
+
+    // 解析器会逐行打印调试信息：每个任务写入自己的缓冲，成功时丢弃，失败时随错误输出到 stderr，
+    // stdout 只留给最终的 JSON 汇总
+    auto started = std::chrono::steady_clock::now();
+    std::vector<json> results(jobs.size());
+    std::atomic<size_t> next{0};
+    std::mutex log_mutex;
+    auto worker = [&]() {
+        for (size_t i = next++; i < jobs.size(); i = next++) {
+            std::ostringstream log;
+            results[i] = compile_batch_job(jobs[i], optimize, compress, log);
+            std::lock_guard<std::mutex> lock(log_mutex);
+            if (results[i]["ok"].get<bool>()) {
+                std::cerr << "✅ " << jobs[i].input << std::endl;
+            } else {
+                std::cerr << log.str() << "❌ " << jobs[i].input << ": " << results[i]["error"].get<std::string>() << std::endl;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < jobs_count; ++t) pool.emplace_back(worker);
+    for (auto& th : pool) th.join();
+
+    size_t failed = 0;
+    for (const auto& r : results) failed += r["ok"].get<bool>() ? 0 : 1;
+    json summary = {
+        {"total", results.size()},
+        {"succeeded", results.size() - failed},
+        {"failed", failed},
+        {"jobs", jobs_count},
+        {"optimize", optimize},
+        {"compress", compress},
+        {"elapsed_ms", std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - started).count()},
+        {"modules", results}
+    };
+    OstreamSink sink(std::cout);
+    CanonicalJson::write_pretty(summary, sink);
+    std::cout << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
+// ---- 常驻编译服务（cardityc --serve <socket>）----
+// Unix 域套接字，每行一个 JSON 请求、每行一个 JSON 响应：
+//   {"cmd":"compile","path":"a.car","optimize":false,"format":"json|carc","compress":false,"output":"a.carc"}
+//   {"cmd":"compile","content":"protocol ..."}      编辑器未保存的缓冲区
+//   {"cmd":"validate","path":"a.car"}
+//   {"cmd":"package-check","dir":"pkg/"}
+//   {"cmd":"stats"} / {"cmd":"shutdown"}
+
+struct CachedModule {
+    bool loaded = false;
+    std::filesystem::file_time_type mtime{};
+    uintmax_t size = 0;
+    std::string sha256;              // 内容的 SHA-256（hex）
+    std::map<bool, json> compiled;   // optimize -> .car JSON
+    bool has_semantics = false;      // 以下签名信息由未优化的编译结果得出
+    bool has_methods = false;
+    ModuleSignature signature;
+    FileSemanticInfo semantics;
+};
+
+class CompileCache {
+public:
+    // 按路径取编译结果：mtime/大小未变直接命中；变化时比较内容的 SHA-256，不同才重新解析。
+    // 解析器的输出写入 log（每个请求一份）
+    const json& compile_file(const std::string& path, bool optimize, bool& cached, std::ostream& log) {
+        std::string content;
+        CachedModule& entry = refresh(path, content);
+        auto it = entry.compiled.find(optimize);
+        cached = it != entry.compiled.end();
+        if (cached) { hits_++; return it->second; }
+        misses_++;
+        if (content.empty()) content = read_file_all(path);
+        return entry.compiled[optimize] = parse_programming_language_format(content, optimize, log);
+    }
+
+    // 未落盘的内容按内容的 SHA-256 缓存（std::hash 碰撞会返回其他缓冲区的编译结果）
+    const json& compile_content(const std::string& content, bool optimize, bool& cached, std::ostream& log) {
+        std::string key = content_sha256(content);
+        auto& slot = contents_[key];
+        auto it = slot.find(optimize);
+        cached = it != slot.end();
+        if (cached) { hits_++; return it->second; }
+        misses_++;
+        if (contents_.size() > MAX_CONTENT_ENTRIES) {
+            // 简单限流：超出上限时整体丢弃，只保留当前条目
+            auto keep = std::move(slot);
+            contents_.clear();
+            contents_[key] = std::move(keep);
+            return contents_[key][optimize] = parse_programming_language_format(content, optimize, log);
+        }
+        return slot[optimize] = parse_programming_language_format(content, optimize, log);
+    }
+
+    // 跨模块签名（package-check 用），与编译结果一同失效
+    const CachedModule& semantics(const std::string& path, std::ostream& log) {
+        bool cached = false;
+        const json& car = compile_file(path, false, cached, log);
+        CachedModule& entry = files_[path];
+        if (!entry.has_semantics) {
+            entry.signature = ModuleSignature();
+            entry.semantics = collect_semantic_info(path, car, entry.signature);
+            entry.has_methods = car.contains("cpl") && car["cpl"].contains("methods");
+            entry.has_semantics = true;
+        }
+        return entry;
+    }
+
+    json stats() const {
+        return {
+            {"modules", files_.size()},
+            {"buffers", contents_.size()},
+            {"hits", hits_},
+            {"misses", misses_},
+            {"invalidations", invalidations_}
+        };
+    }
+
+private:
+    static constexpr size_t MAX_CONTENT_ENTRIES = 256;
+
+    static std::string content_sha256(const std::string& content) {
+        Sha256 hasher;
+        hasher.update(content);
+        return hasher.hex_digest();
+    }
+
+    CachedModule& refresh(const std::string& path, std::string& content) {
+        std::error_code ec;
+        auto mtime = std::filesystem::last_write_time(path, ec);
+        uintmax_t size = ec ? 0 : std::filesystem::file_size(path, ec);
+        if (ec) {
+            files_.erase(path);
+            throw std::runtime_error("Failed to open input file: " + path);
+        }
+        CachedModule& entry = files_[path];
+        if (entry.loaded && entry.mtime == mtime && entry.size == size) return entry;
+
+        content = read_file_all(path);
+        std::string sha256 = content_sha256(content);
+        if (!entry.loaded || sha256 != entry.sha256) {
+            if (entry.loaded) invalidations_++;
+            entry.compiled.clear();
+            entry.has_semantics = false;
+        }
+        entry.loaded = true;
+        entry.mtime = mtime;
+        entry.size = size;
+        entry.sha256 = std::move(sha256);
+        return entry;
+    }
+
+    std::map<std::string, CachedModule> files_;
+    std::map<std::string, std::map<bool, json>> contents_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+    size_t invalidations_ = 0;
+};
+
+static json handle_serve_request(CompileCache& cache, const json& req, bool& shutdown, std::ostream& log) {
+    std::string cmd = req.value("cmd", "");
+    json resp = {{"ok", true}};
+
+    if (cmd == "compile" || cmd == "validate") {
+        bool optimize = req.value("optimize", false);
+        bool cached = false;
+        const json& car = req.contains("content")
+            ? cache.compile_content(req["content"].get<std::string>(), optimize, cached, log)
+            : cache.compile_file(req.value("path", ""), optimize, cached, log);
+        resp["cached"] = cached;
+        if (cmd == "validate") {
+            resp["valid"] = CarDeployer::validate_car_format(car);
+            return resp;
+        }
+        if (!req.contains("output")) {
+            resp["car"] = car;
+            return resp;
+        }
+        std::string output = req["output"].get<std::string>();
+        std::string format = req.value("format", "json");
+        if (format == "json") {
+            write_json_file(output, car);
+        } else if (format == "carc") {
+            std::vector<uint8_t> carc_data = maybe_compress_carc(
+                CarcGenerator::compile_to_carc(protocol_from_car_json(car)), req.value("compress", false));
+            if (!CarcGenerator::write_to_file(carc_data, output)) {
+                throw std::runtime_error("Failed to write .carc file");
+            }
+            resp["size"] = carc_data.size();
+        } else {
+            throw std::runtime_error("Unsupported format: " + format);
+        }
+        resp["output"] = output;
+    } else if (cmd == "package-check") {
+        std::string dir = req.value("dir", "");
+        std::vector<std::string> files = list_car_files(dir);
+        if (files.empty()) throw std::runtime_error("No .car files found in " + dir);
+        std::map<std::string, ModuleSignature> registry;
+        std::vector<FileSemanticInfo> fileInfos;
+        for (const auto& f : files) {
+            const CachedModule& entry = cache.semantics(f, log);
+            if (entry.has_methods) registry[entry.semantics.moduleName] = entry.signature;
+            fileInfos.push_back(entry.semantics);
+        }
+        std::vector<std::string> errors = check_external_calls(fileInfos, registry);
+        resp["ok"] = errors.empty();
+        resp["modules"] = files.size();
+        resp["errors"] = errors;
+    } else if (cmd == "stats") {
+        resp["stats"] = cache.stats();
+    } else if (cmd == "shutdown") {
+        shutdown = true;
+    } else {
+        throw std::runtime_error("Unknown command: " + cmd);
+    }
+    return resp;
+}
+
+static volatile std::sig_atomic_t g_serve_stop = 0;
+
+static void handle_serve_signal(int) {
+    g_serve_stop = 1;
+}
+
+static bool send_all(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static int serve(const std::string& socket_path) {
+    sockaddr_un addr{};
+    if (socket_path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "❌ Socket path too long: " << socket_path << std::endl;
+        return 1;
+    }
+    int listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        std::cerr << "❌ Failed to create socket: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socket_path.c_str(), sizeof(addr.sun_path) - 1);
+    // 只替换残留的套接字文件：路径上是普通文件等时拒绝，已有守护进程在监听时也拒绝
+    struct stat st;
+    if (::lstat(socket_path.c_str(), &st) == 0) {
+        if (!S_ISSOCK(st.st_mode)) {
+            std::cerr << "❌ Refusing to replace " << socket_path << ": not a socket" << std::endl;
+            ::close(listen_fd);
+            return 1;
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = probe >= 0 && ::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+        if (probe >= 0) ::close(probe);
+        if (live) {
+            std::cerr << "❌ A daemon is already listening on " << socket_path << std::endl;
+            ::close(listen_fd);
+            return 1;
+        }
+        ::unlink(socket_path.c_str());
+    }
+    if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        ::listen(listen_fd, 16) < 0) {
+        std::cerr << "❌ Failed to listen on " << socket_path << ": " << std::strerror(errno) << std::endl;
+        ::close(listen_fd);
+        return 1;
+    }
+
+    struct sigaction sa{};
+    sa.sa_handler = handle_serve_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, nullptr);
+    sigaction(SIGTERM, &sa, nullptr);
+
+    std::cout << "🛰️  cardityc daemon listening on " << socket_path << std::endl;
+
+    CompileCache cache;
+    std::vector<pollfd> fds = {{listen_fd, POLLIN, 0}};
+    std::map<int, std::string> buffers;
+    bool shutdown = false;
+
+    while (!shutdown && !g_serve_stop) {
+        if (::poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "❌ poll failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+        std::vector<int> closed;
+        for (size_t i = 1; i < fds.size() && !shutdown; ++i) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            int fd = fds[i].fd;
+            char chunk[4096];
+            ssize_t n = ::read(fd, chunk, sizeof(chunk));
+            if (n <= 0) {
+                if (n < 0 && errno == EINTR) continue;
+                closed.push_back(fd);
+                continue;
+            }
+            std::string& buffer = buffers[fd];
+            buffer.append(chunk, static_cast<size_t>(n));
+            size_t nl;
+            while (!shutdown && (nl = buffer.find('\n')) != std::string::npos) {
+                std::string line = buffer.substr(0, nl);
+                buffer.erase(0, nl + 1);
+                if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+                // 解析器的警告与调试信息不进守护进程的 stdout：成功时丢弃，失败时随错误返回
+                json resp;
+                std::ostringstream log;
+                try {
+                    resp = handle_serve_request(cache, json::parse(line), shutdown, log);
+                } catch (const std::exception& e) {
+                    resp = {{"ok", false}, {"error", e.what()}};
+                    if (!log.str().empty()) resp["log"] = log.str();
+                }
+                if (!send_all(fd, resp.dump() + "\n")) {
+                    closed.push_back(fd);
+                    break;
+                }
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            int client = ::accept(listen_fd, nullptr, nullptr);
+            if (client >= 0) fds.push_back({client, POLLIN, 0});
+        }
+        for (int fd : closed) {
+            ::close(fd);
+            buffers.erase(fd);
+            fds.erase(std::remove_if(fds.begin(), fds.end(), [fd](const pollfd& p) { return p.fd == fd; }),
+                      fds.end());
+        }
+    }
+
+    for (size_t i = 1; i < fds.size(); ++i) ::close(fds[i].fd);
+    ::close(listen_fd);
+    ::unlink(socket_path.c_str());
+    std::cout << "👋 cardityc daemon stopped" << std::endl;
+    return 0;
+}
+
+// 批量验证已签名的部署文件（export_to_file 格式）
+int verify_signatures(const std::vector<std::string>& inputs, const std::string& key, unsigned jobs_count) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> files;
+    for (const auto& input : inputs) {
+        if (fs::is_directory(input)) {
+            for (const auto& entry : fs::directory_iterator(input)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".json") {
+                    files.push_back(entry.path().string());
+                }
+            }
+        } else {
+            files.push_back(input);
+        }
+    }
+    std::sort(files.begin(), files.end());
+    
+    std::vector<CarFile> car_files;
+    std::vector<std::string> loaded;
+    int failed = 0;
+    for (const auto& file : files) {
+        try {
+            std::ifstream ifs(file);
+            if (!ifs.is_open()) {
+                throw std::runtime_error("Failed to open file");
+            }
+            car_files.push_back(CarDeployer::load_deployment(json::parse(ifs)));
+            loaded.push_back(file);
+        } catch (const std::exception& e) {
+            std::cerr << "❌ " << file << ": " << e.what() << std::endl;
+            ++failed;
+        }
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    SignatureVerifier verifier(jobs_count);
+    std::vector<bool> results = verifier.verify_batch(
+        car_files, key.empty() ? std::vector<std::string>{} : std::vector<std::string>(car_files.size(), key));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i]) {
+            std::cout << "✅ " << loaded[i] << std::endl;
+        } else {
+            std::cout << "❌ " << loaded[i] << ": invalid or missing signature" << std::endl;
+            ++failed;
+        }
+    }
+    std::cout << "📊 Verified " << files.size() << " deployment(s), " << failed << " failed, "
+              << elapsed.count() << " ms" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         print_usage(argv[0]);
@@ -247,6 +844,67 @@ int main(int argc, char* argv[]) {
         print_usage(argv[0]);
         return 0;
     }
+
+    // 常驻编译服务
+    if (input_file == "--serve") {
+        return serve(argc > 2 ? argv[2] : "/tmp/cardityc.sock");
+    }
+
+    // 批量编译：cardityc --batch <dir|list> [--out-dir <dir>] [-j N] [-O] [--compress]
+    if (input_file == "--batch") {
+        if (argc < 3) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        std::string out_dir;
+        unsigned jobs_count = 0;
+        bool batch_optimize = false;
+        bool batch_compress = false;
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--out-dir" && i + 1 < argc) {
+                out_dir = argv[++i];
+            } else if (arg == "-j" && i + 1 < argc) {
+                jobs_count = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg.rfind("-j", 0) == 0 && arg.size() > 2) {
+                jobs_count = static_cast<unsigned>(std::strtoul(arg.c_str() + 2, nullptr, 10));
+            } else if (arg == "-O" || arg == "--optimize") {
+                batch_optimize = true;
+            } else if (arg == "--compress") {
+                batch_compress = true;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                print_usage(argv[0]);
+                return 1;
+            }
+        }
+        return batch_compile(argv[2], out_dir, jobs_count, batch_optimize, batch_compress);
+    }
+
+    // 批量验签：cardityc --verify-sig <dir|file...> [--key <pubkey|addr>] [-j N]
+    if (input_file == "--verify-sig") {
+        std::vector<std::string> inputs;
+        std::string key;
+        unsigned jobs_count = 0;
+        for (int i = 2; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--key" && i + 1 < argc) {
+                key = argv[++i];
+            } else if (arg == "-j" && i + 1 < argc) {
+                jobs_count = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            } else if (arg.rfind("-j", 0) == 0 && arg.size() > 2) {
+                jobs_count = static_cast<unsigned>(std::strtoul(arg.c_str() + 2, nullptr, 10));
+            } else {
+                inputs.push_back(arg);
+            }
+        }
+        if (inputs.empty()) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        return verify_signatures(inputs, key, jobs_count);
+    }
+
     std::string output_file = "";
     std::string owner_address = "";
     std::string private_key = "";
@@ -254,6 +912,8 @@ int main(int argc, char* argv[]) {
     bool generate_inscription = false;
     bool generate_wasm = false;
     bool validate_only = false;
+    bool optimize = false;
+    bool compress = false;
     std::string package_check_dir = "";
     
     // 解析命令行参数
@@ -276,6 +936,10 @@ int main(int argc, char* argv[]) {
             generate_wasm = true;
         } else if (arg == "--validate") {
             validate_only = true;
+        } else if (arg == "-O" || arg == "--optimize") {
+            optimize = true;
+        } else if (arg == "--compress") {
+            compress = true;
         } else if (arg == "--package-check" && i + 1 < argc) {
             package_check_dir = argv[++i];
         } else if (arg == "-h" || arg == "--help") {
@@ -327,7 +991,8 @@ int main(int argc, char* argv[]) {
                            std::istreambuf_iterator<char>());
         
         // 解析编程语言格式
-        json car_data = parse_programming_language_format(content);
+        Protocol parsed = parse_protocol_source(content, optimize);
+        json car_data = CarGenerator::compile_to_car(parsed);
         
         // 验证格式
         std::cout << "✅ Validating protocol format..." << std::endl;
@@ -341,33 +1006,23 @@ int main(int argc, char* argv[]) {
         }
         
         // 预生成 ABI JSON（供后续写文件）
-        nlohmann::json abi_json;
-        try {
-            ABIGenerator abi_gen(car_data.value("protocol", ""), car_data.value("version", ""));
-            if (car_data.contains("cpl") && car_data["cpl"].contains("methods")) {
-                abi_gen.set_methods(car_data["cpl"]["methods"]);
-            }
-            // 如有事件定义可在此补充
-            abi_json = abi_gen.generate_abi();
-        } catch (...) {
-            // 忽略 ABI 生成失败
-        }
+        nlohmann::json abi_json = generate_abi_json(car_data);
 
         auto write_abi_file = [&](const std::string& base_path){
             if (abi_json.is_null()) return;
             std::string abi_path = base_path + ".abi.json";
-            std::ofstream aofs(abi_path);
-            if (aofs.is_open()) {
-                aofs << abi_json.dump(2) << std::endl;
+            try {
+                write_json_file(abi_path, abi_json);
                 std::cout << "🧾 ABI saved to: " << abi_path << std::endl;
+            } catch (const std::exception&) {
+                // ABI 写入失败不影响主输出
             }
         };
 
         // 如果输出格式是 JSON，直接输出
         if (output_format == "json") {
             std::cout << "📝 Outputting JSON format..." << std::endl;
-            std::ofstream ofs(output_file);
-            ofs << car_data.dump(2) << std::endl;
+            write_json_file(output_file, [&](JsonWriter& writer) { CarGenerator::write_car(parsed, writer); });
             std::cout << "✅ JSON output saved to: " << output_file << std::endl;
             // 写 ABI 文件（与 JSON 同名 base）
             std::string base = output_file;
@@ -381,47 +1036,26 @@ int main(int argc, char* argv[]) {
         if (output_format == "carc") {
             std::cout << "🔧 Generating .carc binary format..." << std::endl;
             
-            // 将 JSON 数据转换回 Protocol 对象
-            Protocol protocol;
-            protocol.name = car_data["protocol"];
-            protocol.metadata.version = car_data["version"];
-            protocol.metadata.owner = car_data["cpl"]["owner"];
-            
-            // 解析状态变量
-            json state_json = car_data["cpl"]["state"];
-            for (auto it = state_json.begin(); it != state_json.end(); ++it) {
-                StateVariable var;
-                var.name = it.key();
-                var.type = it.value()["type"];
-                var.default_value = it.value()["default"];
-                protocol.state.variables.push_back(var);
-            }
-            
-            // 解析方法
-            json methods_json = car_data["cpl"]["methods"];
-            for (auto it = methods_json.begin(); it != methods_json.end(); ++it) {
-                Method method;
-                method.name = it.key();
-                method.params = it.value()["params"].get<std::vector<std::string>>();
-                method.logic_lines.push_back(it.value()["logic"]);
-                if (it.value().contains("returns")) {
-                    if (it.value()["returns"].is_string()) {
-                        method.return_expr = it.value()["returns"].get<std::string>();
-                    } else if (it.value()["returns"].is_object()) {
-                        method.return_expr = it.value()["returns"].value("expr", "");
-                        method.return_type = it.value()["returns"].value("type", "");
-                    }
-                }
-                protocol.methods.push_back(method);
-            }
+            // 按 .car 语义规整 Protocol（排序、去重），无需经 JSON 往返
+            Protocol protocol = CarGenerator::normalize(parsed);
             
             // 生成 .carc 二进制数据
-            std::vector<uint8_t> carc_data = CarcGenerator::compile_to_carc(protocol);
+            std::vector<uint8_t> raw_carc = CarcGenerator::compile_to_carc(protocol);
+            std::vector<uint8_t> carc_data = maybe_compress_carc(raw_carc, compress);
             
             // 写入文件
             if (CarcGenerator::write_to_file(carc_data, output_file)) {
                 std::cout << "✅ .carc binary file saved to: " << output_file << std::endl;
                 std::cout << "📊 Binary size: " << carc_data.size() << " bytes" << std::endl;
+                if (compress) {
+                    if (CarcGenerator::is_compressed(carc_data)) {
+                        std::cout << "🗜️  Compressed: " << raw_carc.size() << " -> " << carc_data.size()
+                                  << " bytes (v" << CarcGenerator::VERSION_COMPRESSED << ", dictionary "
+                                  << CarcGenerator::DICT_ID << ")" << std::endl;
+                    } else {
+                        std::cout << "⚠️  Compressed form is not smaller, kept uncompressed .carc" << std::endl;
+                    }
+                }
                 std::cout << "📋 Protocol: " << protocol.name << std::endl;
                 std::cout << "📋 Version: " << protocol.metadata.version << std::endl;
                 std::cout << "📋 Owner: " << protocol.metadata.owner << std::endl;
@@ -440,8 +1074,7 @@ int main(int argc, char* argv[]) {
                         CarFile cf = CarDeployer::create_deployment_package_from_json(car_data);
                         json ins = CarDeployer::generate_inscription_format(cf);
                         std::string inscription_file = std::string(output_file) + ".inscription";
-                        std::ofstream ofs(inscription_file);
-                        ofs << ins.dump(2) << std::endl;
+                        write_json_file(inscription_file, ins);
                         std::cout << "📝 Inscription saved to: " << inscription_file << std::endl;
                     } catch (const std::exception& ex) {
                         std::cerr << "⚠️  Failed to generate inscription: " << ex.what() << std::endl;
@@ -466,6 +1099,7 @@ int main(int argc, char* argv[]) {
         // 签名（如果提供）
         if (!private_key.empty()) {
             car_file.signature = CarDeployer::sign_car_file(car_file, private_key);
+            car_file.signer = CarDeployer::public_key_from_private(private_key);
             std::cout << "🔐 Protocol signed" << std::endl;
         }
         
@@ -475,12 +1109,13 @@ int main(int argc, char* argv[]) {
             json inscription = CarDeployer::generate_inscription_format(car_file);
             
             std::string inscription_file = output_file + ".inscription";
-            std::ofstream ofs(inscription_file);
-            ofs << inscription.dump(2) << std::endl;
+            write_json_file(inscription_file, inscription);
             
             std::cout << "✅ Inscription saved to: " << inscription_file << std::endl;
             std::cout << "📋 Inscription content:" << std::endl;
-            std::cout << inscription.dump(2) << std::endl;
+            OstreamSink sink(std::cout);
+            CanonicalJson::write_pretty(inscription, sink);
+            std::cout << std::endl;
         }
         
         // 生成 WASM 模块
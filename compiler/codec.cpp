@@ -0,0 +1,190 @@
+#include "codec.h"
+#include <array>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace cardity {
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789abcdef";
+const char B64_ALPHABET[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+    "abcdefghijklmnopqrstuvwxyz"
+    "0123456789+/";
+
+// 字节 -> 两个 hex 字符
+struct HexTable {
+    std::array<char, 512> pairs{};
+    HexTable() {
+        for (int i = 0; i < 256; ++i) {
+            pairs[i * 2] = HEX_DIGITS[i >> 4];
+            pairs[i * 2 + 1] = HEX_DIGITS[i & 0x0F];
+        }
+    }
+};
+
+// 12 位 -> 两个 base64 字符，每 3 字节只需两次查表
+struct Base64Table {
+    std::array<char, 4096 * 2> pairs{};
+    Base64Table() {
+        for (int i = 0; i < 4096; ++i) {
+            pairs[i * 2] = B64_ALPHABET[i >> 6];
+            pairs[i * 2 + 1] = B64_ALPHABET[i & 0x3F];
+        }
+    }
+};
+
+// 字符 -> 取值；非法字符为 -1，空白为 -2
+struct DecodeTables {
+    std::array<int8_t, 256> hex{};
+    std::array<int8_t, 256> b64{};
+    DecodeTables() {
+        hex.fill(-1);
+        b64.fill(-1);
+        for (int i = 0; i < 10; ++i) hex['0' + i] = static_cast<int8_t>(i);
+        for (int i = 0; i < 6; ++i) {
+            hex['a' + i] = static_cast<int8_t>(10 + i);
+            hex['A' + i] = static_cast<int8_t>(10 + i);
+        }
+        for (int i = 0; i < 64; ++i) b64[static_cast<uint8_t>(B64_ALPHABET[i])] = static_cast<int8_t>(i);
+        for (char ws : {' ', '\t', '\r', '\n'}) b64[static_cast<uint8_t>(ws)] = -2;
+    }
+};
+
+const HexTable HEX_TABLE;
+const Base64Table B64_TABLE;
+const DecodeTables DECODE_TABLES;
+
+} // namespace
+
+void Codec::hex_append(std::string& out, const uint8_t* data, size_t size) {
+    size_t offset = out.size();
+    out.resize(offset + size * 2);
+    char* dst = &out[offset];
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    // 每次 16 字节：拆出高/低半字节，0-9 加 '0'，a-f 再额外加 ('a' - '0' - 10)
+    const __m128i low_mask = _mm_set1_epi8(0x0F);
+    const __m128i nine = _mm_set1_epi8(9);
+    const __m128i ascii_zero = _mm_set1_epi8('0');
+    const __m128i alpha_offset = _mm_set1_epi8('a' - '0' - 10);
+    for (; i + 16 <= size; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), low_mask);
+        __m128i lo = _mm_and_si128(bytes, low_mask);
+        hi = _mm_add_epi8(_mm_add_epi8(hi, ascii_zero), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), alpha_offset));
+        lo = _mm_add_epi8(_mm_add_epi8(lo, ascii_zero), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), alpha_offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2 + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+
+    for (; i < size; ++i) {
+        const char* pair = &HEX_TABLE.pairs[data[i] * 2];
+        dst[i * 2] = pair[0];
+        dst[i * 2 + 1] = pair[1];
+    }
+}
+
+std::string Codec::hex_encode(const uint8_t* data, size_t size) {
+    std::string out;
+    hex_append(out, data, size);
+    return out;
+}
+
+std::string Codec::hex_encode(const std::vector<uint8_t>& data) {
+    return hex_encode(data.data(), data.size());
+}
+
+bool Codec::hex_decode(const std::string& hex, std::vector<uint8_t>& out) {
+    if (hex.size() % 2 != 0) return false;
+    out.resize(hex.size() / 2);
+    const auto& table = DECODE_TABLES.hex;
+    for (size_t i = 0; i < out.size(); ++i) {
+        int8_t hi = table[static_cast<uint8_t>(hex[i * 2])];
+        int8_t lo = table[static_cast<uint8_t>(hex[i * 2 + 1])];
+        if (hi < 0 || lo < 0) {
+            out.clear();
+            return false;
+        }
+        out[i] = static_cast<uint8_t>((hi << 4) | lo);
+    }
+    return true;
+}
+
+std::string Codec::base64_encode(const uint8_t* data, size_t size) {
+    std::string out((size + 2) / 3 * 4, '=');
+    char* dst = &out[0];
+    const char* pairs = B64_TABLE.pairs.data();
+    size_t i = 0;
+    for (; i + 3 <= size; i += 3) {
+        uint32_t v = (uint32_t(data[i]) << 16) | (uint32_t(data[i + 1]) << 8) | data[i + 2];
+        const char* a = pairs + ((v >> 12) * 2);
+        const char* b = pairs + ((v & 0x0FFF) * 2);
+        dst[0] = a[0];
+        dst[1] = a[1];
+        dst[2] = b[0];
+        dst[3] = b[1];
+        dst += 4;
+    }
+    size_t rest = size - i;
+    if (rest) {
+        uint32_t v = uint32_t(data[i]) << 16;
+        if (rest == 2) v |= uint32_t(data[i + 1]) << 8;
+        dst[0] = B64_ALPHABET[(v >> 18) & 0x3F];
+        dst[1] = B64_ALPHABET[(v >> 12) & 0x3F];
+        if (rest == 2) dst[2] = B64_ALPHABET[(v >> 6) & 0x3F];
+    }
+    return out;
+}
+
+std::string Codec::base64_encode(const std::vector<uint8_t>& data) {
+    return base64_encode(data.data(), data.size());
+}
+
+std::string Codec::base64_encode(const std::string& data) {
+    return base64_encode(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+}
+
+bool Codec::base64_decode(const std::string& b64, std::vector<uint8_t>& out) {
+    out.resize(b64.size() / 4 * 3 + 3);
+    uint8_t* dst = out.data();
+    const auto& table = DECODE_TABLES.b64;
+    uint32_t acc = 0;
+    int bits = 0;
+    size_t chars = 0, padding = 0;
+    for (unsigned char c : b64) {
+        int8_t v = table[c];
+        if (v == -2) continue;
+        if (c == '=') {
+            padding++;
+            continue;
+        }
+        // 非法字符，或 '=' 之后还有数据
+        if (v < 0 || padding) {
+            out.clear();
+            return false;
+        }
+        chars++;
+        acc = (acc << 6) | static_cast<uint32_t>(v);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            *dst++ = static_cast<uint8_t>((acc >> bits) & 0xFF);
+        }
+    }
+    // 末组只能剩 2 或 3 个字符；有填充时必须恰好补齐到 4 的倍数
+    size_t rest = chars % 4;
+    if (rest == 1 || (padding && (rest == 0 || rest + padding != 4))) {
+        out.clear();
+        return false;
+    }
+    out.resize(static_cast<size_t>(dst - out.data()));
+    return true;
+}
+
+} // namespace cardity
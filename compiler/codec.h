@@ -0,0 +1,35 @@
+#ifndef CARDITY_CODEC_H
+#define CARDITY_CODEC_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace cardity {
+
+// 部署/铭文路径共用的 hex 与 base64 编解码
+// hex 编码在 x86-64 上使用 SSE2 每次处理 16 字节，其余为查表实现
+class Codec {
+public:
+    // 小写 hex 编码
+    static std::string hex_encode(const uint8_t* data, size_t size);
+    static std::string hex_encode(const std::vector<uint8_t>& data);
+    // 追加到已有字符串末尾，避免中间拷贝
+    static void hex_append(std::string& out, const uint8_t* data, size_t size);
+
+    // hex 解码（大小写均可）；长度为奇数或含非法字符时返回 false
+    static bool hex_decode(const std::string& hex, std::vector<uint8_t>& out);
+
+    // 标准 base64（RFC 4648，带 '=' 填充）
+    static std::string base64_encode(const uint8_t* data, size_t size);
+    static std::string base64_encode(const std::vector<uint8_t>& data);
+    static std::string base64_encode(const std::string& data);
+
+    // base64 解码：忽略空白，'=' 填充可省略；含非法字符、填充不匹配或填充后仍有数据时返回 false
+    static bool base64_decode(const std::string& b64, std::vector<uint8_t>& out);
+};
+
+} // namespace cardity
+
+#endif // CARDITY_CODEC_H
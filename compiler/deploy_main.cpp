@@ -1,7 +1,13 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <algorithm>
 #include "dogecoin_deployer.h"
+#include "codec.h"
+#include "part_planner.h"
+#include "inscription_planner.h"
 
 using namespace cardity;
 
@@ -15,19 +21,55 @@ void print_usage(const std::string& program_name) {
     std::cout << "  validate <carc_file>       - Validate .carc file format" << std::endl;
     std::cout << "  deploy <carc_file> [options] - Deploy protocol to Dogecoin" << std::endl;
     std::cout << "  inscription <carc_file> [options] - Create inscription transaction" << std::endl;
+    std::cout << "  split <carc_file> <package_id> <module> [options] - Split into deploy_part envelopes" << std::endl;
+    std::cout << "  verify-parts <part.json...|dir> [--output <file>] - Reassemble parts and check bundle hash" << std::endl;
+    std::cout << "  sign-batch <batch.json> [options] - Build and sign many raw transactions offline" << std::endl;
+    std::cout << "  inscribe <carc_file> <package_id> <module> [options] - Plan and sign the commit/reveal chain" << std::endl;
     std::cout << std::endl;
     std::cout << "Deploy Options:" << std::endl;
     std::cout << "  --address <addr>           - Dogecoin address" << std::endl;
     std::cout << "  --private-key <key>        - Private key" << std::endl;
-    std::cout << "  --amount <satoshis>        - Amount in satoshis (default: 1000)" << std::endl;
+    std::cout << "  --amount <koinu>           - Payment amount in koinu (default: 1000000, the dust limit)" << std::endl;
     std::cout << "  --output <file>            - Output script file" << std::endl;
     std::cout << "  --rpc                      - Generate RPC commands" << std::endl;
+    std::cout << "  --utxo <txid:vout:amount>  - Spend this UTXO and emit a signed raw transaction (repeatable)" << std::endl;
+    std::cout << "  --change <addr>            - Change address (default: the key's own address)" << std::endl;
+    std::cout << "  --fee-rate <koinu/kB>      - Fee rate (default: 1000000)" << std::endl;
+    std::cout << "  --testnet                  - Use testnet address/WIF prefixes" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Sign-batch Options:" << std::endl;
+    std::cout << "  -j, --jobs <n>             - Parallel signers (default: hardware threads)" << std::endl;
+    std::cout << "  --output <file>            - Write signed transactions JSON (default: stdout)" << std::endl;
+    std::cout << "  --testnet                  - Use testnet address/WIF prefixes" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Split Options:" << std::endl;
+    std::cout << "  --version <v>              - Package version (default: 1.0.0)" << std::endl;
+    std::cout << "  --max-bytes <n>            - Max bytes per part envelope (default: 50000)" << std::endl;
+    std::cout << "  -o, --out <dir>            - Output directory (default: next to .carc)" << std::endl;
+    std::cout << "  -j, --jobs <n>             - Parallel encoders (default: hardware threads)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Inscribe Options:" << std::endl;
+    std::cout << "  --utxos <file>             - UTXO set JSON (txid/vout/amount[/address|scriptPubKey]; listunspent works)" << std::endl;
+    std::cout << "  --private-key <wif>        - Key that owns the UTXOs and signs the chain" << std::endl;
+    std::cout << "  --address <addr>           - Inscription receive address" << std::endl;
+    std::cout << "  --version/--max-bytes      - Same as split" << std::endl;
+    std::cout << "  --content-type <type>      - Inscription content type (default: application/json)" << std::endl;
+    std::cout << "  --fee-rate <koinu/kB>      - Fee rate (default: 1000000)" << std::endl;
+    std::cout << "  --postage <koinu>          - Value of each inscription output (default: 1000000)" << std::endl;
+    std::cout << "  --change <addr>            - Change address (default: the key's own address)" << std::endl;
+    std::cout << "  --output <file>            - Write the chain JSON (default: stdout)" << std::endl;
+    std::cout << "  --testnet                  - Use testnet address/WIF prefixes" << std::endl;
     std::cout << std::endl;
     std::cout << "Examples:" << std::endl;
     std::cout << "  " << program_name << " info protocol.carc" << std::endl;
     std::cout << "  " << program_name << " validate protocol.carc" << std::endl;
     std::cout << "  " << program_name << " deploy protocol.carc --address doge1abc... --private-key xyz..." << std::endl;
+    std::cout << "  " << program_name << " deploy protocol.carc --address D... --private-key <wif> --utxo <txid>:0:500000000" << std::endl;
     std::cout << "  " << program_name << " inscription protocol.carc --address doge1abc... --output deploy.sh" << std::endl;
+    std::cout << "  " << program_name << " split protocol.carc my.pkg token --version 1.2.0 -o parts/" << std::endl;
+    std::cout << "  " << program_name << " verify-parts parts/ --output protocol.carc" << std::endl;
+    std::cout << "  " << program_name << " sign-batch batch.json -j 8 --output signed.json" << std::endl;
+    std::cout << "  " << program_name << " inscribe protocol.carc my.pkg token --utxos utxos.json --private-key <wif> --address D... --output chain.json" << std::endl;
 }
 
 int cmd_info(const std::string& carc_file) {
@@ -48,6 +90,7 @@ int cmd_info(const std::string& carc_file) {
         std::cout << "State Variables: " << info["state_variables"] << std::endl;
         std::cout << "Methods: " << info["methods"] << std::endl;
         std::cout << "File Size: " << info["file_size"] << " bytes" << std::endl;
+        std::cout << "Compressed: " << (info.value("compressed", false) ? "yes" : "no") << std::endl;
         std::cout << "Hash: " << info["hash"] << std::endl;
         
         return 0;
@@ -74,25 +117,42 @@ int cmd_deploy(int argc, char* argv[]) {
     std::string carc_file = argv[2];
     std::string address = "";
     std::string private_key = "";
-    uint64_t amount = 1000;
+    uint64_t amount = DogecoinDeployer::DEFAULT_AMOUNT;
     std::string output_file = "";
     bool generate_rpc = false;
+    std::vector<std::string> utxo_specs;
+    std::string change_address = "";
+    TxBuildOptions build_options;
+    bool testnet = false;
     
     // 解析参数
-    for (int i = 3; i < argc; ++i) {
-        std::string arg = argv[i];
-        
-        if (arg == "--address" && i + 1 < argc) {
-            address = argv[++i];
-        } else if (arg == "--private-key" && i + 1 < argc) {
-            private_key = argv[++i];
-        } else if (arg == "--amount" && i + 1 < argc) {
-            amount = std::stoull(argv[++i]);
-        } else if (arg == "--output" && i + 1 < argc) {
-            output_file = argv[++i];
-        } else if (arg == "--rpc") {
-            generate_rpc = true;
+    try {
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            
+            if (arg == "--address" && i + 1 < argc) {
+                address = argv[++i];
+            } else if (arg == "--private-key" && i + 1 < argc) {
+                private_key = argv[++i];
+            } else if (arg == "--amount" && i + 1 < argc) {
+                amount = std::stoull(argv[++i]);
+            } else if (arg == "--output" && i + 1 < argc) {
+                output_file = argv[++i];
+            } else if (arg == "--rpc") {
+                generate_rpc = true;
+            } else if (arg == "--utxo" && i + 1 < argc) {
+                utxo_specs.push_back(argv[++i]);
+            } else if (arg == "--change" && i + 1 < argc) {
+                change_address = argv[++i];
+            } else if (arg == "--fee-rate" && i + 1 < argc) {
+                build_options.fee_per_kb = std::stoull(argv[++i]);
+            } else if (arg == "--testnet") {
+                testnet = true;
+            }
         }
+    } catch (const std::exception&) {
+        std::cerr << "❌ Error: invalid numeric option" << std::endl;
+        return 1;
     }
     
     if (address.empty() || private_key.empty()) {
@@ -110,6 +170,50 @@ int cmd_deploy(int argc, char* argv[]) {
         std::cout << "📋 Address: " << tx.address << std::endl;
         std::cout << "💰 Amount: " << tx.amount << " satoshis" << std::endl;
         std::cout << "📝 OP_RETURN: " << tx.op_return_data << std::endl;
+        if (utxo_specs.empty() && tx.carc_data.size() > DogecoinDeployer::MAX_OP_RETURN_BYTES) {
+            std::cerr << "⚠️  .carc is " << tx.carc_data.size() << " bytes; OP_RETURN relays at most "
+                      << DogecoinDeployer::MAX_OP_RETURN_BYTES << " bytes. Use `inscribe` for this module." << std::endl;
+        }
+        
+        // 给出 UTXO 时直接构建并签名原始交易
+        if (!utxo_specs.empty()) {
+            const DogecoinNetwork& network = testnet ? DogecoinNetwork::testnet() : DogecoinNetwork::mainnet();
+            std::vector<TxInput> utxos;
+            uint64_t total_in = 0;
+            for (const auto& spec : utxo_specs) {
+                utxos.push_back(DogecoinDeployer::parse_utxo(spec));
+                total_in += utxos.back().amount;
+            }
+            if (!change_address.empty()) {
+                build_options.change_script = Script::for_address(change_address, network);
+            }
+            
+            RawTransaction raw = DogecoinDeployer::build_signed_deployment(tx, utxos, build_options, network);
+            std::string raw_hex = TxSerializer::to_hex(raw);
+            uint64_t total_out = 0;
+            for (const auto& o : raw.outputs) total_out += o.value;
+            
+            std::cout << "🔐 Signed transaction: " << TxSerializer::txid(raw) << std::endl;
+            std::cout << "📊 Size: " << raw_hex.size() / 2 << " bytes, fee " << (total_in - total_out) << " koinu" << std::endl;
+            
+            if (generate_rpc) {
+                json send_tx;
+                send_tx["method"] = "sendrawtransaction";
+                send_tx["params"] = {raw_hex};
+                std::cout << "\n🔧 RPC Commands:" << std::endl;
+                std::cout << json{{"send_transaction", send_tx}}.dump(2) << std::endl;
+            }
+            
+            if (!output_file.empty()) {
+                std::ofstream ofs(output_file);
+                ofs << raw_hex << "\n";
+                ofs.close();
+                std::cout << "📄 Raw transaction saved to: " << output_file << std::endl;
+            } else {
+                std::cout << raw_hex << std::endl;
+            }
+            return 0;
+        }
         
         if (generate_rpc) {
             std::cout << "\n🔧 RPC Commands:" << std::endl;
@@ -185,6 +289,316 @@ int cmd_inscription(int argc, char* argv[]) {
     }
 }
 
+int cmd_split(int argc, char* argv[]) {
+    std::string carc_file = argv[2];
+    PartOptions options;
+    options.package_id = argv[3];
+    options.module = argv[4];
+    
+    // 解析参数
+    try {
+        for (int i = 5; i < argc; ++i) {
+            std::string arg = argv[i];
+            
+            if (arg == "--version" && i + 1 < argc) {
+                options.version = argv[++i];
+            } else if (arg == "--max-bytes" && i + 1 < argc) {
+                options.max_bytes = std::stoull(argv[++i]);
+            } else if ((arg == "-o" || arg == "--out") && i + 1 < argc) {
+                options.out_dir = argv[++i];
+            } else if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
+                options.jobs = static_cast<unsigned>(std::stoul(argv[++i]));
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "❌ Error: invalid numeric option" << std::endl;
+        return 1;
+    }
+    
+    try {
+        std::cout << "✂️  Splitting " << carc_file << " into deploy_part envelopes..." << std::endl;
+        PartPlan plan = PartPlanner::split_file(carc_file, options);
+        
+        for (const auto& part : plan.parts) {
+            std::cout << "✅ Wrote " << part.path << " (" << part.size << " bytes, envelope "
+                      << part.envelope_size << " bytes)" << std::endl;
+        }
+        std::cout << "📋 Bundle: " << plan.bundle_id << std::endl;
+        std::cout << "📋 Parts: " << plan.parts.size() << " (max " << options.max_bytes << " bytes per envelope)" << std::endl;
+        std::cout << "🔐 SHA-256: " << plan.sha256 << std::endl;
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int cmd_verify_parts(int argc, char* argv[]) {
+    std::vector<std::string> inputs;
+    std::string output_file = "";
+    
+    // 解析参数
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        
+        if (arg == "--output" && i + 1 < argc) {
+            output_file = argv[++i];
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    
+    try {
+        // 目录参数展开为其中的 *.part.json
+        std::vector<std::string> part_files;
+        for (const auto& input : inputs) {
+            if (std::filesystem::is_directory(input)) {
+                for (const auto& f : PartPlanner::list_part_files(input)) part_files.push_back(f);
+            } else {
+                part_files.push_back(input);
+            }
+        }
+        
+        std::cout << "🔍 Verifying " << part_files.size() << " part file(s)..." << std::endl;
+        PartVerifyResult result = PartPlanner::verify(part_files, output_file);
+        
+        if (!result.ok) {
+            for (const auto& err : result.errors) {
+                std::cerr << "❌ " << err << std::endl;
+            }
+            return 1;
+        }
+        
+        std::cout << "✅ Bundle " << result.bundle_id << " is complete and matches its hash" << std::endl;
+        std::cout << "📋 Parts: " << result.total << std::endl;
+        std::cout << "📊 Size: " << result.size << " bytes" << std::endl;
+        std::cout << "🔐 SHA-256: " << result.sha256 << std::endl;
+        if (!output_file.empty()) {
+            std::cout << "📄 Reassembled .carc saved to: " << output_file << std::endl;
+        }
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+// 批量请求格式：
+// {
+//   "keys": ["<wif>", ...],
+//   "fee_per_kb": 1000000, "change": "<addr>",          // 可选，作为各交易默认值
+//   "transactions": [{
+//     "inputs":  [{"txid": "...", "vout": 0, "amount": 100000000, "address": "<addr>" | "script_pubkey": "<hex>"}],
+//     "outputs": [{"address": "<addr>", "amount": 1000000} | {"data": "<hex>"} | {"script": "<hex>", "amount": 0}],
+//     "change": "<addr>", "fee_per_kb": 1000000          // 可选
+//   }]
+// }
+static std::vector<uint8_t> hex_field(const json& obj, const char* key) {
+    std::vector<uint8_t> bytes;
+    if (!Codec::hex_decode(obj.at(key).get<std::string>(), bytes)) {
+        throw std::runtime_error(std::string("Invalid hex in \"") + key + "\"");
+    }
+    return bytes;
+}
+
+static RawTransaction build_batch_transaction(const json& spec, const json& defaults, const DogecoinNetwork& network,
+                                              size_t pubkey_size) {
+    std::vector<TxInput> inputs;
+    for (const auto& in : spec.at("inputs")) {
+        TxInput input;
+        input.prev_txid = in.at("txid").get<std::string>();
+        input.vout = in.at("vout").get<uint32_t>();
+        input.amount = in.at("amount").get<uint64_t>();
+        input.prev_script = in.contains("script_pubkey") ? hex_field(in, "script_pubkey")
+                                                         : Script::for_address(in.at("address").get<std::string>(), network);
+        inputs.push_back(std::move(input));
+    }
+    std::vector<TxOutput> outputs;
+    for (const auto& out : spec.at("outputs")) {
+        if (out.contains("data")) {
+            outputs.push_back(TxOutput{0, Script::op_return(hex_field(out, "data"))});
+        } else if (out.contains("script")) {
+            outputs.push_back(TxOutput{out.value("amount", uint64_t(0)), hex_field(out, "script")});
+        } else {
+            outputs.push_back(TxOutput{out.at("amount").get<uint64_t>(),
+                                       Script::for_address(out.at("address").get<std::string>(), network)});
+        }
+    }
+    TxBuildOptions options;
+    options.fee_per_kb = spec.value("fee_per_kb", defaults.value("fee_per_kb", options.fee_per_kb));
+    std::string change = spec.value("change", defaults.value("change", std::string()));
+    if (!change.empty()) options.change_script = Script::for_address(change, network);
+    options.pubkey_size = pubkey_size;
+    return TxBuilder::build(inputs, outputs, options);
+}
+
+int cmd_sign_batch(int argc, char* argv[]) {
+    std::string batch_file = argv[2];
+    std::string output_file = "";
+    unsigned jobs = 0;
+    bool testnet = false;
+    
+    // 解析参数
+    try {
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            
+            if ((arg == "-j" || arg == "--jobs") && i + 1 < argc) {
+                jobs = static_cast<unsigned>(std::stoul(argv[++i]));
+            } else if (arg == "--output" && i + 1 < argc) {
+                output_file = argv[++i];
+            } else if (arg == "--testnet") {
+                testnet = true;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "❌ Error: invalid numeric option" << std::endl;
+        return 1;
+    }
+    
+    try {
+        const DogecoinNetwork& network = testnet ? DogecoinNetwork::testnet() : DogecoinNetwork::mainnet();
+        std::ifstream ifs(batch_file);
+        if (!ifs.is_open()) {
+            throw std::runtime_error("Cannot open file: " + batch_file);
+        }
+        json batch = json::parse(ifs);
+        
+        // 每个私钥只解析一次，所有交易共享；有未压缩公钥时按最长的公钥估算手续费
+        TxSigner signer;
+        size_t pubkey_size = 33;
+        for (const auto& wif : batch.at("keys")) {
+            Secp256k1Key key = Secp256k1Key::from_wif(wif.get<std::string>(), network);
+            pubkey_size = std::max(pubkey_size, key.public_key().size());
+            signer.add_key(std::move(key));
+        }
+        
+        std::vector<RawTransaction> txs;
+        const json& specs = batch.at("transactions");
+        txs.reserve(specs.size());
+        for (size_t i = 0; i < specs.size(); ++i) {
+            try {
+                txs.push_back(build_batch_transaction(specs[i], batch, network, pubkey_size));
+            } catch (const std::exception& e) {
+                throw std::runtime_error("Transaction " + std::to_string(i) + ": " + e.what());
+            }
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        signer.sign_batch(txs, jobs);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        
+        json result = json::array();
+        for (const auto& tx : txs) {
+            result.push_back({{"txid", TxSerializer::txid(tx)}, {"hex", TxSerializer::to_hex(tx)}});
+        }
+        
+        if (!output_file.empty()) {
+            std::ofstream ofs(output_file);
+            ofs << result.dump(2) << "\n";
+            ofs.close();
+            std::cout << "✅ Signed " << txs.size() << " transaction(s) with " << signer.key_count()
+                      << " key(s) in " << elapsed.count() << " ms" << std::endl;
+            std::cout << "📄 Signed transactions saved to: " << output_file << std::endl;
+        } else {
+            std::cout << result.dump(2) << std::endl;
+        }
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
+int cmd_inscribe(int argc, char* argv[]) {
+    std::string carc_file = argv[2];
+    InscriptionOptions options;
+    options.parts.package_id = argv[3];
+    options.parts.module = argv[4];
+    std::string utxo_file = "";
+    std::string private_key = "";
+    std::string output_file = "";
+    
+    // 解析参数
+    try {
+        for (int i = 5; i < argc; ++i) {
+            std::string arg = argv[i];
+            
+            if (arg == "--utxos" && i + 1 < argc) {
+                utxo_file = argv[++i];
+            } else if (arg == "--private-key" && i + 1 < argc) {
+                private_key = argv[++i];
+            } else if (arg == "--address" && i + 1 < argc) {
+                options.destination = argv[++i];
+            } else if (arg == "--version" && i + 1 < argc) {
+                options.parts.version = argv[++i];
+            } else if (arg == "--max-bytes" && i + 1 < argc) {
+                options.parts.max_bytes = std::stoull(argv[++i]);
+            } else if (arg == "--content-type" && i + 1 < argc) {
+                options.content_type = argv[++i];
+            } else if (arg == "--fee-rate" && i + 1 < argc) {
+                options.fee_per_kb = std::stoull(argv[++i]);
+            } else if (arg == "--postage" && i + 1 < argc) {
+                options.postage = std::stoull(argv[++i]);
+            } else if (arg == "--change" && i + 1 < argc) {
+                options.change_address = argv[++i];
+            } else if (arg == "--output" && i + 1 < argc) {
+                output_file = argv[++i];
+            } else if (arg == "--testnet") {
+                options.testnet = true;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "❌ Error: invalid numeric option" << std::endl;
+        return 1;
+    }
+    
+    if (utxo_file.empty() || private_key.empty() || options.destination.empty()) {
+        std::cerr << "❌ Error: --utxos, --private-key and --address are required" << std::endl;
+        return 1;
+    }
+    
+    try {
+        const DogecoinNetwork& network = options.testnet ? DogecoinNetwork::testnet() : DogecoinNetwork::mainnet();
+        Secp256k1Key key = Secp256k1Key::from_wif(private_key, network);
+        
+        std::ifstream ifs(utxo_file);
+        if (!ifs.is_open()) {
+            throw std::runtime_error("Cannot open file: " + utxo_file);
+        }
+        std::vector<TxInput> utxos = InscriptionPlanner::parse_utxos(
+            json::parse(ifs), Script::p2pkh(key.pubkey_hash()), network);
+        
+        auto start = std::chrono::steady_clock::now();
+        InscriptionChain chain = InscriptionPlanner::plan_file(carc_file, utxos, key, options);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        json result = InscriptionPlanner::to_json(chain);
+        
+        if (!output_file.empty()) {
+            std::ofstream ofs(output_file);
+            ofs << result.dump(2) << "\n";
+            ofs.close();
+            std::cout << "✅ Planned " << chain.transactions.size() << " transaction(s) for bundle "
+                      << chain.bundle_id << " in " << elapsed.count() << " ms" << std::endl;
+            std::cout << "💰 Total fee: " << chain.total_fee << " koinu" << std::endl;
+            for (const auto& id : chain.inscription_ids) {
+                std::cout << "🏷️  Inscription: " << id << std::endl;
+            }
+            std::cout << "📄 Chain saved to: " << output_file << " (broadcast in order)" << std::endl;
+        } else {
+            std::cout << result.dump(2) << std::endl;
+        }
+        return 0;
+        
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
+
 int main(int argc, char* argv[]) {
     if (argc < 2) {
         print_usage(argv[0]);
@@ -230,6 +644,38 @@ int main(int argc, char* argv[]) {
         return cmd_inscription(argc, argv);
     }
     
+    if (command == "split") {
+        if (argc < 5) {
+            std::cerr << "❌ Error: .carc file, package id and module name required" << std::endl;
+            return 1;
+        }
+        return cmd_split(argc, argv);
+    }
+    
+    if (command == "verify-parts") {
+        if (argc < 3) {
+            std::cerr << "❌ Error: part files or directory required" << std::endl;
+            return 1;
+        }
+        return cmd_verify_parts(argc, argv);
+    }
+    
+    if (command == "sign-batch") {
+        if (argc < 3) {
+            std::cerr << "❌ Error: batch file required" << std::endl;
+            return 1;
+        }
+        return cmd_sign_batch(argc, argv);
+    }
+    
+    if (command == "inscribe") {
+        if (argc < 5) {
+            std::cerr << "❌ Error: .carc file, package id and module name required" << std::endl;
+            return 1;
+        }
+        return cmd_inscribe(argc, argv);
+    }
+    
     std::cerr << "❌ Unknown command: " << command << std::endl;
     print_usage(argv[0]);
     return 1;
@@ -1,10 +1,12 @@
 #include "dogecoin_deployer.h"
 #include "carc_generator.h"
+#include "codec.h"
+#include "sha256.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
-#include <openssl/sha.h>
+#include <cstdio>
 
 namespace cardity {
 
@@ -27,6 +29,7 @@ DogecoinTransaction DogecoinDeployer::create_deployment_transaction(
     
     // 生成铭文数据
     tx.inscription_data = generate_inscription_data(carc_data);
+    tx.carc_data = std::move(carc_data);
     
     return tx;
 }
@@ -36,16 +39,13 @@ std::string DogecoinDeployer::generate_op_return_data(const std::vector<uint8_t>
     std::string op_return = "6a"; // OP_RETURN
     
     // 添加数据长度（十六进制）
-    std::stringstream ss;
-    ss << std::hex << std::setw(2) << std::setfill('0') << carc_data.size();
-    op_return += ss.str();
+    char len_hex[20];
+    std::snprintf(len_hex, sizeof(len_hex), "%02zx", carc_data.size());
+    op_return += len_hex;
     
     // 添加数据（十六进制）
-    for (uint8_t byte : carc_data) {
-        ss.str("");
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
-        op_return += ss.str();
-    }
+    op_return.reserve(op_return.size() + carc_data.size() * 2);
+    Codec::hex_append(op_return, carc_data.data(), carc_data.size());
     
     return op_return;
 }
@@ -87,7 +87,7 @@ DogecoinTransaction DogecoinDeployer::create_inscription_transaction(
     inscription_data.insert(inscription_data.end(), header.begin(), header.end());
     inscription_data.insert(inscription_data.end(), carc_data.begin(), carc_data.end());
     
-    tx.inscription_data = base64_encode(inscription_data);
+    tx.inscription_data = Codec::base64_encode(inscription_data);
     
     return tx;
 }
@@ -114,8 +114,9 @@ json DogecoinDeployer::get_carc_info(const std::string& carc_file) {
     json info;
     
     try {
-        // 解析 .carc 文件
-        Protocol protocol = CarcGenerator::parse_from_carc(carc_file);
+        // 解析 .carc 文件（压缩格式自动解压）
+        std::vector<uint8_t> carc_data = read_carc_file(carc_file);
+        Protocol protocol = CarcGenerator::parse_carc_data(carc_data);
         
         info["protocol"] = protocol.name;
         info["version"] = protocol.metadata.version;
@@ -124,14 +125,10 @@ json DogecoinDeployer::get_carc_info(const std::string& carc_file) {
         info["methods"] = protocol.methods.size();
         
         // 文件信息
-        std::ifstream file(carc_file, std::ios::binary | std::ios::ate);
-        if (file.is_open()) {
-            info["file_size"] = static_cast<int64_t>(file.tellg());
-            file.close();
-        }
+        info["file_size"] = static_cast<int64_t>(carc_data.size());
+        info["compressed"] = CarcGenerator::is_compressed(carc_data);
         
-        // 计算哈希
-        std::vector<uint8_t> carc_data = read_carc_file(carc_file);
+        // 计算哈希（按链上字节）
         info["hash"] = calculate_file_hash(carc_data);
         
     } catch (const std::exception& e) {
@@ -200,6 +197,65 @@ json DogecoinDeployer::generate_rpc_commands(const DogecoinTransaction& tx) {
     return commands;
 }
 
+RawTransaction DogecoinDeployer::build_signed_deployment(
+    const DogecoinTransaction& tx,
+    const std::vector<TxInput>& utxos,
+    TxBuildOptions options,
+    const DogecoinNetwork& network) {
+    
+    if (tx.carc_data.size() > MAX_OP_RETURN_BYTES) {
+        throw std::runtime_error("OP_RETURN payload is " + std::to_string(tx.carc_data.size()) +
+                                 " bytes, over the " + std::to_string(MAX_OP_RETURN_BYTES) +
+                                 "-byte standard limit; use `inscribe` (commit/reveal) instead");
+    }
+    if (tx.amount < options.dust_limit) {
+        throw std::runtime_error("Amount " + std::to_string(tx.amount) + " koinu is below the dust limit (" +
+                                 std::to_string(options.dust_limit) + " koinu)");
+    }
+    
+    Secp256k1Key key = Secp256k1Key::from_wif(tx.private_key, network);
+    std::vector<uint8_t> own_script = Script::p2pkh(key.pubkey_hash());
+    
+    std::vector<TxInput> inputs = utxos;
+    for (auto& in : inputs) {
+        if (in.prev_script.empty()) in.prev_script = own_script;
+    }
+    if (options.change_script.empty()) options.change_script = own_script;
+    options.pubkey_size = key.public_key().size();
+    
+    // 输出：OP_RETURN(.carc) + 支付到目标地址
+    std::vector<TxOutput> outputs;
+    outputs.push_back(TxOutput{0, Script::op_return(tx.carc_data)});
+    outputs.push_back(TxOutput{tx.amount, Script::for_address(tx.address, network)});
+    
+    RawTransaction raw = TxBuilder::build(inputs, outputs, options);
+    TxSigner signer;
+    signer.add_key(std::move(key));
+    signer.sign(raw);
+    return raw;
+}
+
+TxInput DogecoinDeployer::parse_utxo(const std::string& spec) {
+    size_t first = spec.find(':');
+    size_t second = first == std::string::npos ? std::string::npos : spec.find(':', first + 1);
+    if (second == std::string::npos) {
+        throw std::runtime_error("Invalid UTXO (expected txid:vout:amount): " + spec);
+    }
+    TxInput in;
+    in.prev_txid = spec.substr(0, first);
+    try {
+        in.vout = static_cast<uint32_t>(std::stoul(spec.substr(first + 1, second - first - 1)));
+        in.amount = std::stoull(spec.substr(second + 1));
+    } catch (const std::exception&) {
+        throw std::runtime_error("Invalid UTXO (expected txid:vout:amount): " + spec);
+    }
+    std::vector<uint8_t> txid;
+    if (in.prev_txid.size() != 64 || !Codec::hex_decode(in.prev_txid, txid)) {
+        throw std::runtime_error("Invalid UTXO txid: " + in.prev_txid);
+    }
+    return in;
+}
+
 std::vector<uint8_t> DogecoinDeployer::read_carc_file(const std::string& filename) {
     std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
@@ -218,47 +274,7 @@ std::vector<uint8_t> DogecoinDeployer::read_carc_file(const std::string& filenam
 }
 
 std::string DogecoinDeployer::calculate_file_hash(const std::vector<uint8_t>& data) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256_CTX sha256;
-    SHA256_Init(&sha256);
-    SHA256_Update(&sha256, data.data(), data.size());
-    SHA256_Final(hash, &sha256);
-    
-    std::stringstream ss;
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++) {
-        ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(hash[i]);
-    }
-    
-    return ss.str();
-}
-
-std::string DogecoinDeployer::base64_encode(const std::vector<uint8_t>& data) {
-    const std::string base64_chars = 
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-        "abcdefghijklmnopqrstuvwxyz"
-        "0123456789+/";
-    
-    std::string result;
-    int val = 0, valb = -6;
-    
-    for (uint8_t c : data) {
-        val = (val << 8) + c;
-        valb += 8;
-        while (valb >= 0) {
-            result.push_back(base64_chars[(val >> valb) & 0x3F]);
-            valb -= 6;
-        }
-    }
-    
-    if (valb > -6) {
-        result.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
-    }
-    
-    while (result.size() % 4) {
-        result.push_back('=');
-    }
-    
-    return result;
+    return Sha256::hex(data);
 }
 
 std::string DogecoinDeployer::create_inscription_header(const std::string& content_type) {
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <nlohmann/json.hpp>
+#include "dogecoin_tx.h"
 
 namespace cardity {
 
@@ -18,17 +19,23 @@ struct DogecoinTransaction {
     uint64_t amount;  // satoshis
     std::string op_return_data;
     std::string inscription_data;
+    std::vector<uint8_t> carc_data;  // 原始 .carc 字节（构建原始交易时使用）
 };
 
 // Dogecoin 部署器
 class DogecoinDeployer {
 public:
+    // 标准交易中 OP_RETURN 可携带的数据上限（字节）；更大的 .carc 需走铭文（commit/reveal）
+    static constexpr size_t MAX_OP_RETURN_BYTES = 80;
+    // 默认支付金额：0.01 DOGE，不低于 Dogecoin Core 的 dust 下限
+    static constexpr uint64_t DEFAULT_AMOUNT = 1000000;
+    
     // 从 .carc 文件创建 Dogecoin 交易
     static DogecoinTransaction create_deployment_transaction(
         const std::string& carc_file,
         const std::string& address,
         const std::string& private_key,
-        uint64_t amount = 1000  // 默认 1000 satoshis
+        uint64_t amount = DEFAULT_AMOUNT
     );
     
     // 生成 OP_RETURN 数据
@@ -57,6 +64,19 @@ public:
     // 生成 RPC 命令
     static json generate_rpc_commands(const DogecoinTransaction& tx);
     
+    // 构建并签名部署交易（OP_RETURN + 支付输出 + 找零），无需节点参与；
+    // tx.private_key 为 WIF，未给出 prev_script 的 UTXO 视为该私钥的 P2PKH 输出。
+    // .carc 超过 MAX_OP_RETURN_BYTES 或支付金额低于 options.dust_limit 时抛出异常（节点不会转发这样的交易）
+    static RawTransaction build_signed_deployment(
+        const DogecoinTransaction& tx,
+        const std::vector<TxInput>& utxos,
+        TxBuildOptions options,
+        const DogecoinNetwork& network = DogecoinNetwork::mainnet()
+    );
+    
+    // 解析 "txid:vout:amount" 形式的 UTXO
+    static TxInput parse_utxo(const std::string& spec);
+    
 private:
     // 读取 .carc 文件
     static std::vector<uint8_t> read_carc_file(const std::string& filename);
@@ -64,9 +84,6 @@ private:
     // 计算文件哈希
     static std::string calculate_file_hash(const std::vector<uint8_t>& data);
     
-    // 编码为 Base64
-    static std::string base64_encode(const std::vector<uint8_t>& data);
-    
     // 创建铭文头部
     static std::string create_inscription_header(const std::string& content_type);
 };
@@ -0,0 +1,801 @@
+#include "dogecoin_tx.h"
+#include "codec.h"
+#include "sha256.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <openssl/bn.h>
+#include <openssl/crypto.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/obj_mac.h>
+
+namespace cardity {
+
+namespace {
+
+const char* BASE58_ALPHABET = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+
+// 全进程共享的 secp256k1 曲线参数（只读，可跨线程使用）
+struct Curve {
+    EC_GROUP* group = nullptr;
+    const BIGNUM* order = nullptr;
+    BIGNUM* half_order = nullptr;
+
+    Curve() {
+        group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+        if (!group) {
+            throw std::runtime_error("secp256k1 is not available in this OpenSSL build");
+        }
+        order = EC_GROUP_get0_order(group);
+        half_order = BN_dup(order);
+        BN_rshift1(half_order, half_order);
+    }
+    ~Curve() {
+        BN_free(half_order);
+        EC_GROUP_free(group);
+    }
+};
+
+const Curve& curve() {
+    static Curve instance;
+    return instance;
+}
+
+// 每个线程一个 BN_CTX，批量签名时避免反复分配
+BN_CTX* bn_ctx() {
+    struct Holder {
+        BN_CTX* ctx = BN_CTX_new();
+        ~Holder() { BN_CTX_free(ctx); }
+    };
+    thread_local Holder holder;
+    if (!holder.ctx) throw std::bad_alloc();
+    return holder.ctx;
+}
+
+struct BnDeleter {
+    void operator()(BIGNUM* bn) const { BN_clear_free(bn); }
+};
+struct PointDeleter {
+    void operator()(EC_POINT* p) const { EC_POINT_free(p); }
+};
+struct SigDeleter {
+    void operator()(ECDSA_SIG* s) const { ECDSA_SIG_free(s); }
+};
+using BnPtr = std::unique_ptr<BIGNUM, BnDeleter>;
+using PointPtr = std::unique_ptr<EC_POINT, PointDeleter>;
+using SigPtr = std::unique_ptr<ECDSA_SIG, SigDeleter>;
+
+BnPtr new_bn() {
+    BnPtr bn(BN_new());
+    if (!bn) throw std::bad_alloc();
+    return bn;
+}
+
+void check(int ok, const char* what) {
+    if (ok != 1) throw std::runtime_error(std::string("secp256k1: ") + what + " failed");
+}
+
+std::vector<uint8_t> bn_to_32(const BIGNUM* bn) {
+    std::vector<uint8_t> out(32);
+    check(BN_bn2binpad(bn, out.data(), 32) == 32 ? 1 : 0, "BN_bn2binpad");
+    return out;
+}
+
+void hmac_sha256(const uint8_t* key, const std::vector<uint8_t>& data, uint8_t* out) {
+    unsigned int len = 32;
+    if (!HMAC(EVP_sha256(), key, 32, data.data(), data.size(), out, &len)) {
+        throw std::runtime_error("secp256k1: HMAC-SHA256 failed");
+    }
+}
+
+void write_le32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void write_le64(std::vector<uint8_t>& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void write_bytes(std::vector<uint8_t>& out, const std::vector<uint8_t>& bytes) {
+    TxSerializer::write_varint(out, bytes.size());
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+// txid 以显示顺序（大端）给出，序列化时按内部字节序（反序）写入
+void write_txid(std::vector<uint8_t>& out, const std::string& txid) {
+    std::vector<uint8_t> bytes;
+    if (txid.size() != 64 || !Codec::hex_decode(txid, bytes)) {
+        throw std::runtime_error("Invalid txid: " + txid);
+    }
+    out.insert(out.end(), bytes.rbegin(), bytes.rend());
+}
+
+size_t varint_size(uint64_t v) {
+    if (v < 0xfd) return 1;
+    if (v <= 0xffff) return 3;
+    if (v <= 0xffffffffULL) return 5;
+    return 9;
+}
+
+class Reader {
+public:
+    Reader(const std::vector<uint8_t>& data) : data_(data) {}
+    bool read(void* out, size_t n) {
+        if (n > data_.size() - pos_) return false;
+        std::memcpy(out, data_.data() + pos_, n);
+        pos_ += n;
+        return true;
+    }
+    bool le32(uint32_t& v) {
+        uint8_t b[4];
+        if (!read(b, 4)) return false;
+        v = uint32_t(b[0]) | uint32_t(b[1]) << 8 | uint32_t(b[2]) << 16 | uint32_t(b[3]) << 24;
+        return true;
+    }
+    bool le64(uint64_t& v) {
+        uint32_t lo, hi;
+        if (!le32(lo) || !le32(hi)) return false;
+        v = uint64_t(hi) << 32 | lo;
+        return true;
+    }
+    bool varint(uint64_t& v) {
+        uint8_t b;
+        if (!read(&b, 1)) return false;
+        if (b < 0xfd) { v = b; return true; }
+        if (b == 0xfd) {
+            uint8_t x[2];
+            if (!read(x, 2)) return false;
+            v = uint64_t(x[0]) | uint64_t(x[1]) << 8;
+            return true;
+        }
+        if (b == 0xfe) {
+            uint32_t x;
+            if (!le32(x)) return false;
+            v = x;
+            return true;
+        }
+        return le64(v);
+    }
+    bool bytes(std::vector<uint8_t>& out) {
+        uint64_t n;
+        if (!varint(n) || n > data_.size() - pos_) return false;
+        out.assign(data_.begin() + pos_, data_.begin() + pos_ + n);
+        pos_ += n;
+        return true;
+    }
+    bool done() const { return pos_ == data_.size(); }
+
+private:
+    const std::vector<uint8_t>& data_;
+    size_t pos_ = 0;
+};
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// 网络参数
+
+const DogecoinNetwork& DogecoinNetwork::mainnet() {
+    static const DogecoinNetwork net{0x1e, 0x16, 0x9e};
+    return net;
+}
+
+const DogecoinNetwork& DogecoinNetwork::testnet() {
+    static const DogecoinNetwork net{0x71, 0xc4, 0xf1};
+    return net;
+}
+
+// ---------------------------------------------------------------------------
+// Base58
+
+std::string Base58::encode(const uint8_t* data, size_t size) {
+    size_t zeros = 0;
+    while (zeros < size && data[zeros] == 0) ++zeros;
+
+    // 以 58 进制大数逐字节累加（log(256)/log(58) ≈ 1.37）
+    std::vector<uint8_t> digits((size - zeros) * 138 / 100 + 1);
+    size_t length = 0;
+    for (size_t i = zeros; i < size; ++i) {
+        int carry = data[i];
+        size_t j = 0;
+        for (auto it = digits.rbegin(); (carry != 0 || j < length) && it != digits.rend(); ++it, ++j) {
+            carry += 256 * (*it);
+            *it = static_cast<uint8_t>(carry % 58);
+            carry /= 58;
+        }
+        length = j;
+    }
+    auto it = digits.begin() + (digits.size() - length);
+    std::string out(zeros, '1');
+    out.reserve(zeros + length);
+    for (; it != digits.end(); ++it) out += BASE58_ALPHABET[*it];
+    return out;
+}
+
+bool Base58::decode(const std::string& str, std::vector<uint8_t>& out) {
+    size_t zeros = 0;
+    while (zeros < str.size() && str[zeros] == '1') ++zeros;
+
+    std::vector<uint8_t> bytes((str.size() - zeros) * 733 / 1000 + 1);
+    size_t length = 0;
+    for (size_t i = zeros; i < str.size(); ++i) {
+        const char* p = std::strchr(BASE58_ALPHABET, str[i]);
+        if (!p || str[i] == '\0') return false;
+        int carry = static_cast<int>(p - BASE58_ALPHABET);
+        size_t j = 0;
+        for (auto it = bytes.rbegin(); (carry != 0 || j < length) && it != bytes.rend(); ++it, ++j) {
+            carry += 58 * (*it);
+            *it = static_cast<uint8_t>(carry % 256);
+            carry /= 256;
+        }
+        length = j;
+    }
+    out.assign(zeros, 0);
+    out.insert(out.end(), bytes.end() - length, bytes.end());
+    return true;
+}
+
+std::string Base58::encode_check(const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> data = payload;
+    std::vector<uint8_t> checksum = TxHash::hash256(payload);
+    data.insert(data.end(), checksum.begin(), checksum.begin() + 4);
+    return encode(data);
+}
+
+bool Base58::decode_check(const std::string& str, std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> data;
+    if (!decode(str, data) || data.size() < 4) return false;
+    std::vector<uint8_t> checksum = TxHash::hash256(data.data(), data.size() - 4);
+    if (!std::equal(checksum.begin(), checksum.begin() + 4, data.end() - 4)) return false;
+    payload.assign(data.begin(), data.end() - 4);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 哈希
+
+std::vector<uint8_t> TxHash::hash256(const uint8_t* data, size_t size) {
+    Sha256 hasher;
+    hasher.update(data, size);
+    std::vector<uint8_t> first = hasher.digest();
+    hasher.update(first);
+    return hasher.digest();
+}
+
+std::vector<uint8_t> TxHash::hash160(const uint8_t* data, size_t size) {
+    Sha256 hasher;
+    hasher.update(data, size);
+    std::vector<uint8_t> sha = hasher.digest();
+    std::vector<uint8_t> out(20);
+    unsigned int len = 0;
+    if (!EVP_Digest(sha.data(), sha.size(), out.data(), &len, EVP_ripemd160(), nullptr) || len != 20) {
+        throw std::runtime_error("RIPEMD-160 is not available in this OpenSSL build");
+    }
+    return out;
+}
+
+// ---------------------------------------------------------------------------
+// 脚本
+
+void Script::push_data(std::vector<uint8_t>& script, const uint8_t* data, size_t size) {
+    if (size < OP_PUSHDATA1) {
+        script.push_back(static_cast<uint8_t>(size));
+    } else if (size <= 0xff) {
+        script.push_back(OP_PUSHDATA1);
+        script.push_back(static_cast<uint8_t>(size));
+    } else if (size <= 0xffff) {
+        script.push_back(OP_PUSHDATA2);
+        script.push_back(static_cast<uint8_t>(size));
+        script.push_back(static_cast<uint8_t>(size >> 8));
+    } else {
+        script.push_back(OP_PUSHDATA4);
+        write_le32(script, static_cast<uint32_t>(size));
+    }
+    script.insert(script.end(), data, data + size);
+}
+
+void Script::push_int(std::vector<uint8_t>& script, int64_t value) {
+    if (value == 0) {
+        script.push_back(OP_0);
+        return;
+    }
+    if (value >= 1 && value <= 16) {
+        script.push_back(static_cast<uint8_t>(OP_1 + value - 1));
+        return;
+    }
+    // 脚本数字：小端绝对值，最高字节的最高位为符号位
+    std::vector<uint8_t> bytes;
+    bool negative = value < 0;
+    uint64_t abs = negative ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+    while (abs) {
+        bytes.push_back(static_cast<uint8_t>(abs & 0xff));
+        abs >>= 8;
+    }
+    if (bytes.back() & 0x80) {
+        bytes.push_back(negative ? 0x80 : 0x00);
+    } else if (negative) {
+        bytes.back() |= 0x80;
+    }
+    push_data(script, bytes);
+}
+
+std::vector<uint8_t> Script::p2pkh(const std::vector<uint8_t>& pubkey_hash) {
+    if (pubkey_hash.size() != 20) throw std::runtime_error("P2PKH requires a 20-byte hash");
+    std::vector<uint8_t> script = {OP_DUP, OP_HASH160};
+    push_data(script, pubkey_hash);
+    script.push_back(OP_EQUALVERIFY);
+    script.push_back(OP_CHECKSIG);
+    return script;
+}
+
+std::vector<uint8_t> Script::p2sh(const std::vector<uint8_t>& script_hash) {
+    if (script_hash.size() != 20) throw std::runtime_error("P2SH requires a 20-byte hash");
+    std::vector<uint8_t> script = {OP_HASH160};
+    push_data(script, script_hash);
+    script.push_back(OP_EQUAL);
+    return script;
+}
+
+std::vector<uint8_t> Script::op_return(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> script = {OP_RETURN};
+    push_data(script, data);
+    return script;
+}
+
+std::vector<uint8_t> Script::p2pkh_script_sig(const std::vector<uint8_t>& signature,
+                                              const std::vector<uint8_t>& public_key) {
+    std::vector<uint8_t> script;
+    script.reserve(signature.size() + public_key.size() + 2);
+    push_data(script, signature);
+    push_data(script, public_key);
+    return script;
+}
+
+std::vector<uint8_t> Script::for_address(const std::string& address, const DogecoinNetwork& network) {
+    std::vector<uint8_t> payload;
+    if (!Base58::decode_check(address, payload) || payload.size() != 21) {
+        throw std::runtime_error("Invalid Dogecoin address: " + address);
+    }
+    std::vector<uint8_t> hash(payload.begin() + 1, payload.end());
+    if (payload[0] == network.p2pkh_prefix) return p2pkh(hash);
+    if (payload[0] == network.p2sh_prefix) return p2sh(hash);
+    throw std::runtime_error("Address is for a different network: " + address);
+}
+
+bool Script::extract_pubkey_hash(const std::vector<uint8_t>& script, std::vector<uint8_t>& pubkey_hash) {
+    if (script.size() != 25 || script[0] != OP_DUP || script[1] != OP_HASH160 || script[2] != 20 ||
+        script[23] != OP_EQUALVERIFY || script[24] != OP_CHECKSIG) {
+        return false;
+    }
+    pubkey_hash.assign(script.begin() + 3, script.begin() + 23);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// 私钥上下文
+
+struct Secp256k1Key::Impl {
+    BnPtr secret;
+    uint8_t secret_bytes[32];
+    std::vector<uint8_t> public_key;
+    std::vector<uint8_t> pubkey_hash;
+
+    ~Impl() { OPENSSL_cleanse(secret_bytes, sizeof(secret_bytes)); }
+};
+
+Secp256k1Key::Secp256k1Key(const std::vector<uint8_t>& secret, bool compressed) : impl_(new Impl) {
+    const Curve& c = curve();
+    if (secret.size() != 32) {
+        throw std::runtime_error("Private key must be 32 bytes");
+    }
+    std::memcpy(impl_->secret_bytes, secret.data(), 32);
+    impl_->secret.reset(BN_bin2bn(secret.data(), 32, nullptr));
+    if (!impl_->secret) throw std::bad_alloc();
+    BN_set_flags(impl_->secret.get(), BN_FLG_CONSTTIME);
+    if (BN_is_zero(impl_->secret.get()) || BN_cmp(impl_->secret.get(), c.order) >= 0) {
+        throw std::runtime_error("Private key is out of range");
+    }
+
+    BN_CTX* ctx = bn_ctx();
+    PointPtr point(EC_POINT_new(c.group));
+    if (!point) throw std::bad_alloc();
+    check(EC_POINT_mul(c.group, point.get(), impl_->secret.get(), nullptr, nullptr, ctx), "EC_POINT_mul");
+    point_conversion_form_t form = compressed ? POINT_CONVERSION_COMPRESSED : POINT_CONVERSION_UNCOMPRESSED;
+    size_t len = EC_POINT_point2oct(c.group, point.get(), form, nullptr, 0, ctx);
+    impl_->public_key.resize(len);
+    check(EC_POINT_point2oct(c.group, point.get(), form, impl_->public_key.data(), len, ctx) == len ? 1 : 0,
+          "EC_POINT_point2oct");
+    impl_->pubkey_hash = TxHash::hash160(impl_->public_key);
+}
+
+Secp256k1Key::~Secp256k1Key() = default;
+Secp256k1Key::Secp256k1Key(Secp256k1Key&&) noexcept = default;
+Secp256k1Key& Secp256k1Key::operator=(Secp256k1Key&&) noexcept = default;
+
+Secp256k1Key Secp256k1Key::from_wif(const std::string& wif, const DogecoinNetwork& network) {
+    std::vector<uint8_t> payload;
+    if (!Base58::decode_check(wif, payload)) {
+        throw std::runtime_error("Invalid WIF private key (bad checksum)");
+    }
+    bool compressed = payload.size() == 34 && payload[33] == 0x01;
+    if (payload.size() != 33 && !compressed) {
+        throw std::runtime_error("Invalid WIF private key (bad length)");
+    }
+    if (payload[0] != network.wif_prefix) {
+        throw std::runtime_error("WIF private key is for a different network");
+    }
+    std::vector<uint8_t> secret(payload.begin() + 1, payload.begin() + 33);
+    OPENSSL_cleanse(payload.data(), payload.size());
+    Secp256k1Key key(secret, compressed);
+    OPENSSL_cleanse(secret.data(), secret.size());
+    return key;
+}
+
+const std::vector<uint8_t>& Secp256k1Key::public_key() const {
+    return impl_->public_key;
+}
+
+const std::vector<uint8_t>& Secp256k1Key::pubkey_hash() const {
+    return impl_->pubkey_hash;
+}
+
+std::string Secp256k1Key::address(const DogecoinNetwork& network) const {
+    std::vector<uint8_t> payload;
+    payload.reserve(21);
+    payload.push_back(network.p2pkh_prefix);
+    payload.insert(payload.end(), impl_->pubkey_hash.begin(), impl_->pubkey_hash.end());
+    return Base58::encode_check(payload);
+}
+
+std::vector<uint8_t> Secp256k1Key::sign(const uint8_t* digest32) const {
+    const Curve& c = curve();
+    BN_CTX* ctx = bn_ctx();
+
+    BnPtr z(BN_bin2bn(digest32, 32, nullptr));
+    if (!z) throw std::bad_alloc();
+    // RFC 6979 的 bits2octets：摘要对 n 取模后的 32 字节
+    BnPtr z_mod = new_bn();
+    check(BN_nnmod(z_mod.get(), z.get(), c.order, ctx), "BN_nnmod");
+    std::vector<uint8_t> h1 = bn_to_32(z_mod.get());
+
+    // RFC 6979 3.2：由私钥与摘要派生确定性 nonce
+    uint8_t v[32], k_mac[32];
+    std::memset(v, 0x01, sizeof(v));
+    std::memset(k_mac, 0x00, sizeof(k_mac));
+    std::vector<uint8_t> buf;
+    buf.reserve(32 + 1 + 32 + 32);
+    auto seed = [&](uint8_t marker) {
+        buf.assign(v, v + 32);
+        buf.push_back(marker);
+        buf.insert(buf.end(), impl_->secret_bytes, impl_->secret_bytes + 32);
+        buf.insert(buf.end(), h1.begin(), h1.end());
+        hmac_sha256(k_mac, buf, k_mac);
+        buf.assign(v, v + 32);
+        hmac_sha256(k_mac, buf, v);
+    };
+    seed(0x00);
+    seed(0x01);
+
+    BnPtr k = new_bn(), r = new_bn(), s = new_bn(), x = new_bn(), tmp = new_bn();
+    PointPtr point(EC_POINT_new(c.group));
+    if (!point) throw std::bad_alloc();
+    BN_set_flags(k.get(), BN_FLG_CONSTTIME);
+    for (;;) {
+        buf.assign(v, v + 32);
+        hmac_sha256(k_mac, buf, v);
+        if (!BN_bin2bn(v, 32, k.get())) throw std::bad_alloc();
+        if (!BN_is_zero(k.get()) && BN_cmp(k.get(), c.order) < 0) {
+            // r = (kG).x mod n；s = k⁻¹(z + r·d) mod n
+            check(EC_POINT_mul(c.group, point.get(), k.get(), nullptr, nullptr, ctx), "EC_POINT_mul");
+            check(EC_POINT_get_affine_coordinates(c.group, point.get(), x.get(), nullptr, ctx),
+                  "EC_POINT_get_affine_coordinates");
+            check(BN_nnmod(r.get(), x.get(), c.order, ctx), "BN_nnmod");
+            if (!BN_is_zero(r.get())) {
+                check(BN_mod_mul(tmp.get(), r.get(), impl_->secret.get(), c.order, ctx), "BN_mod_mul");
+                check(BN_mod_add(tmp.get(), tmp.get(), z_mod.get(), c.order, ctx), "BN_mod_add");
+                if (!BN_mod_inverse(s.get(), k.get(), c.order, ctx)) check(0, "BN_mod_inverse");
+                check(BN_mod_mul(s.get(), s.get(), tmp.get(), c.order, ctx), "BN_mod_mul");
+                if (!BN_is_zero(s.get())) break;
+            }
+        }
+        buf.assign(v, v + 32);
+        buf.push_back(0x00);
+        hmac_sha256(k_mac, buf, k_mac);
+        buf.assign(v, v + 32);
+        hmac_sha256(k_mac, buf, v);
+    }
+    OPENSSL_cleanse(v, sizeof(v));
+    OPENSSL_cleanse(k_mac, sizeof(k_mac));
+
+    // low-S：s > n/2 时取 n - s（Dogecoin Core 标准性规则）
+    if (BN_cmp(s.get(), c.half_order) > 0) {
+        check(BN_sub(s.get(), c.order, s.get()), "BN_sub");
+    }
+
+    SigPtr sig(ECDSA_SIG_new());
+    if (!sig) throw std::bad_alloc();
+    check(ECDSA_SIG_set0(sig.get(), r.release(), s.release()), "ECDSA_SIG_set0");
+    int len = i2d_ECDSA_SIG(sig.get(), nullptr);
+    std::vector<uint8_t> der(static_cast<size_t>(len > 0 ? len : 0));
+    uint8_t* p = der.data();
+    check(len > 0 && i2d_ECDSA_SIG(sig.get(), &p) == len ? 1 : 0, "i2d_ECDSA_SIG");
+    return der;
+}
+
+bool Secp256k1Key::verify(const std::vector<uint8_t>& public_key, const uint8_t* digest32,
+                          const std::vector<uint8_t>& signature) {
+    const Curve& c = curve();
+    BN_CTX* ctx = bn_ctx();
+
+    PointPtr q(EC_POINT_new(c.group));
+    if (!q) throw std::bad_alloc();
+    if (public_key.empty() ||
+        EC_POINT_oct2point(c.group, q.get(), public_key.data(), public_key.size(), ctx) != 1) {
+        return false;
+    }
+
+    // 只接受严格 DER（重新编码后与输入一致）
+    const uint8_t* p = signature.data();
+    SigPtr sig(d2i_ECDSA_SIG(nullptr, &p, static_cast<long>(signature.size())));
+    if (!sig || p != signature.data() + signature.size()) return false;
+    if (i2d_ECDSA_SIG(sig.get(), nullptr) != static_cast<int>(signature.size())) return false;
+
+    const BIGNUM* r = ECDSA_SIG_get0_r(sig.get());
+    const BIGNUM* s = ECDSA_SIG_get0_s(sig.get());
+    if (BN_is_zero(r) || BN_is_negative(r) || BN_cmp(r, c.order) >= 0 ||
+        BN_is_zero(s) || BN_is_negative(s) || BN_cmp(s, c.order) >= 0) {
+        return false;
+    }
+
+    // R = (z·w)G + (r·w)Q，w = s⁻¹；校验 R.x mod n == r
+    BnPtr z(BN_bin2bn(digest32, 32, nullptr));
+    BnPtr w = new_bn(), u1 = new_bn(), u2 = new_bn(), x = new_bn();
+    if (!z) throw std::bad_alloc();
+    if (!BN_mod_inverse(w.get(), s, c.order, ctx)) return false;
+    check(BN_mod_mul(u1.get(), z.get(), w.get(), c.order, ctx), "BN_mod_mul");
+    check(BN_mod_mul(u2.get(), r, w.get(), c.order, ctx), "BN_mod_mul");
+
+    PointPtr point(EC_POINT_new(c.group));
+    if (!point) throw std::bad_alloc();
+    check(EC_POINT_mul(c.group, point.get(), u1.get(), q.get(), u2.get(), ctx), "EC_POINT_mul");
+    if (EC_POINT_is_at_infinity(c.group, point.get())) return false;
+    check(EC_POINT_get_affine_coordinates(c.group, point.get(), x.get(), nullptr, ctx),
+          "EC_POINT_get_affine_coordinates");
+    check(BN_nnmod(x.get(), x.get(), c.order, ctx), "BN_nnmod");
+    return BN_cmp(x.get(), r) == 0;
+}
+
+// ---------------------------------------------------------------------------
+// 序列化
+
+void TxSerializer::write_varint(std::vector<uint8_t>& out, uint64_t value) {
+    if (value < 0xfd) {
+        out.push_back(static_cast<uint8_t>(value));
+    } else if (value <= 0xffff) {
+        out.push_back(0xfd);
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    } else if (value <= 0xffffffffULL) {
+        out.push_back(0xfe);
+        write_le32(out, static_cast<uint32_t>(value));
+    } else {
+        out.push_back(0xff);
+        write_le64(out, value);
+    }
+}
+
+std::vector<uint8_t> TxSerializer::serialize(const RawTransaction& tx) {
+    std::vector<uint8_t> out;
+    out.reserve(TxBuilder::estimate_signed_size(tx));
+    write_le32(out, static_cast<uint32_t>(tx.version));
+    write_varint(out, tx.inputs.size());
+    for (const auto& in : tx.inputs) {
+        write_txid(out, in.prev_txid);
+        write_le32(out, in.vout);
+        write_bytes(out, in.script_sig);
+        write_le32(out, in.sequence);
+    }
+    write_varint(out, tx.outputs.size());
+    for (const auto& o : tx.outputs) {
+        write_le64(out, o.value);
+        write_bytes(out, o.script);
+    }
+    write_le32(out, tx.locktime);
+    return out;
+}
+
+std::string TxSerializer::to_hex(const RawTransaction& tx) {
+    return Codec::hex_encode(serialize(tx));
+}
+
+bool TxSerializer::parse(const std::vector<uint8_t>& data, RawTransaction& tx) {
+    Reader reader(data);
+    RawTransaction result;
+    uint32_t version;
+    uint64_t count;
+    if (!reader.le32(version) || !reader.varint(count) || count > data.size()) return false;
+    result.version = static_cast<int32_t>(version);
+    result.inputs.resize(count);
+    for (auto& in : result.inputs) {
+        uint8_t hash[32];
+        if (!reader.read(hash, 32) || !reader.le32(in.vout) || !reader.bytes(in.script_sig) ||
+            !reader.le32(in.sequence)) {
+            return false;
+        }
+        std::reverse(hash, hash + 32);
+        in.prev_txid = Codec::hex_encode(hash, 32);
+    }
+    if (!reader.varint(count) || count > data.size()) return false;
+    result.outputs.resize(count);
+    for (auto& o : result.outputs) {
+        if (!reader.le64(o.value) || !reader.bytes(o.script)) return false;
+    }
+    if (!reader.le32(result.locktime) || !reader.done()) return false;
+    tx = std::move(result);
+    return true;
+}
+
+std::string TxSerializer::txid(const RawTransaction& tx) {
+    std::vector<uint8_t> hash = TxHash::hash256(serialize(tx));
+    std::reverse(hash.begin(), hash.end());
+    return Codec::hex_encode(hash);
+}
+
+std::vector<uint8_t> TxSerializer::signature_hash(const RawTransaction& tx, size_t input_index,
+                                                  const std::vector<uint8_t>& script_code,
+                                                  uint32_t sighash_type) {
+    if (input_index >= tx.inputs.size()) {
+        throw std::runtime_error("Signature hash input index out of range");
+    }
+    if ((sighash_type & 0x1f) != SIGHASH_ALL) {
+        throw std::runtime_error("Only SIGHASH_ALL is supported");
+    }
+    // 直接写出修改后的序列化，不复制整笔交易
+    std::vector<uint8_t> out;
+    out.reserve(TxBuilder::estimate_signed_size(tx) + script_code.size() + 4);
+    write_le32(out, static_cast<uint32_t>(tx.version));
+    write_varint(out, tx.inputs.size());
+    for (size_t i = 0; i < tx.inputs.size(); ++i) {
+        const TxInput& in = tx.inputs[i];
+        write_txid(out, in.prev_txid);
+        write_le32(out, in.vout);
+        if (i == input_index) {
+            write_bytes(out, script_code);
+        } else {
+            out.push_back(0x00);
+        }
+        write_le32(out, in.sequence);
+    }
+    write_varint(out, tx.outputs.size());
+    for (const auto& o : tx.outputs) {
+        write_le64(out, o.value);
+        write_bytes(out, o.script);
+    }
+    write_le32(out, tx.locktime);
+    write_le32(out, sighash_type);
+    return TxHash::hash256(out);
+}
+
+// ---------------------------------------------------------------------------
+// 组装
+
+size_t TxBuilder::estimate_signed_size(const RawTransaction& tx, size_t pubkey_size) {
+    // 未签名的输入按 P2PKH 最大 scriptSig 计：签名推送 1+72（DER 71 + sighash）+ 公钥推送 1+pubkey_size
+    const size_t p2pkh_script_sig = 1 + 72 + 1 + pubkey_size;
+    size_t size = 4 + varint_size(tx.inputs.size()) + varint_size(tx.outputs.size()) + 4;
+    for (const auto& in : tx.inputs) {
+        size_t script = in.script_sig.empty() ? p2pkh_script_sig : in.script_sig.size();
+        size += 32 + 4 + varint_size(script) + script + 4;
+    }
+    for (const auto& o : tx.outputs) {
+        size += 8 + varint_size(o.script.size()) + o.script.size();
+    }
+    return size;
+}
+
+uint64_t TxBuilder::fee_for_size(size_t size, uint64_t fee_per_kb) {
+    return (static_cast<uint64_t>(size) * fee_per_kb + 999) / 1000;
+}
+
+RawTransaction TxBuilder::build(const std::vector<TxInput>& utxos,
+                                const std::vector<TxOutput>& outputs,
+                                const TxBuildOptions& options) {
+    if (utxos.empty()) {
+        throw std::runtime_error("Transaction needs at least one input");
+    }
+    RawTransaction tx;
+    tx.inputs = utxos;
+    tx.outputs = outputs;
+
+    uint64_t total_in = 0, total_out = 0;
+    for (const auto& in : utxos) total_in += in.amount;
+    for (const auto& o : outputs) total_out += o.value;
+
+    uint64_t fee = fee_for_size(estimate_signed_size(tx, options.pubkey_size), options.fee_per_kb);
+    if (total_in < total_out + fee) {
+        throw std::runtime_error("Insufficient funds: inputs " + std::to_string(total_in) + " koinu, outputs " +
+                                 std::to_string(total_out) + " koinu + fee " + std::to_string(fee) + " koinu");
+    }
+
+    // 找零低于 dust 时并入手续费
+    if (!options.change_script.empty()) {
+        tx.outputs.push_back(TxOutput{0, options.change_script});
+        uint64_t fee_with_change = fee_for_size(estimate_signed_size(tx, options.pubkey_size), options.fee_per_kb);
+        if (total_in >= total_out + fee_with_change + options.dust_limit) {
+            tx.outputs.back().value = total_in - total_out - fee_with_change;
+        } else {
+            tx.outputs.pop_back();
+        }
+    }
+    return tx;
+}
+
+// ---------------------------------------------------------------------------
+// 签名
+
+void TxSigner::add_key(Secp256k1Key key) {
+    const std::vector<uint8_t>& hash = key.pubkey_hash();
+    std::string id(hash.begin(), hash.end());
+    keys_.erase(id);
+    keys_.emplace(std::move(id), std::move(key));
+}
+
+void TxSigner::sign(RawTransaction& tx) const {
+    std::vector<uint8_t> hash;
+    for (size_t i = 0; i < tx.inputs.size(); ++i) {
+        const TxInput& in = tx.inputs[i];
+        if (!Script::extract_pubkey_hash(in.prev_script, hash)) {
+            throw std::runtime_error("Input " + std::to_string(i) + " does not spend a P2PKH output");
+        }
+        auto it = keys_.find(std::string(hash.begin(), hash.end()));
+        if (it == keys_.end()) {
+            throw std::runtime_error("No private key for input " + std::to_string(i) +
+                                     " (pubkey hash " + Codec::hex_encode(hash) + ")");
+        }
+        sign_input(tx, i, it->second);
+    }
+}
+
+void TxSigner::sign_input(RawTransaction& tx, size_t index, const Secp256k1Key& key) {
+    TxInput& in = tx.inputs.at(index);
+    std::vector<uint8_t> digest = TxSerializer::signature_hash(tx, index, in.prev_script);
+    std::vector<uint8_t> sig = key.sign(digest.data());
+    sig.push_back(static_cast<uint8_t>(TxSerializer::SIGHASH_ALL));
+    in.script_sig = Script::p2pkh_script_sig(sig, key.public_key());
+}
+
+void TxSigner::sign_batch(std::vector<RawTransaction>& txs, unsigned jobs) const {
+    // 每笔交易互不依赖：按下标分发给工作线程，私钥上下文只读共享
+    unsigned workers = jobs ? jobs : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<size_t>(workers, txs.size()));
+    std::atomic<size_t> next{0};
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    auto worker = [&]() {
+        for (size_t i = next++; i < txs.size(); i = next++) {
+            try {
+                sign(txs[i]);
+            } catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                if (!failure) {
+                    failure = std::make_exception_ptr(
+                        std::runtime_error("Transaction " + std::to_string(i) + ": " + e.what()));
+                }
+                next = txs.size();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < workers; ++t) threads.emplace_back(worker);
+    worker();
+    for (auto& th : threads) th.join();
+    if (failure) std::rethrow_exception(failure);
+}
+
+} // namespace cardity
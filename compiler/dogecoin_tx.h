@@ -0,0 +1,203 @@
+#ifndef CARDITY_DOGECOIN_TX_H
+#define CARDITY_DOGECOIN_TX_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace cardity {
+
+// 网络参数：地址与 WIF 的版本字节
+struct DogecoinNetwork {
+    uint8_t p2pkh_prefix;
+    uint8_t p2sh_prefix;
+    uint8_t wif_prefix;
+
+    static const DogecoinNetwork& mainnet();
+    static const DogecoinNetwork& testnet();
+};
+
+// 交易输入；amount/prev_script 为被花费输出的金额与锁定脚本（签名时需要）
+struct TxInput {
+    std::string prev_txid;              // 大端 hex（与区块浏览器/RPC 显示一致）
+    uint32_t vout = 0;
+    uint64_t amount = 0;                // koinu
+    std::vector<uint8_t> prev_script;
+    std::vector<uint8_t> script_sig;
+    uint32_t sequence = 0xffffffff;
+};
+
+struct TxOutput {
+    uint64_t value = 0;                 // koinu
+    std::vector<uint8_t> script;
+};
+
+// 传统（非隔离见证）交易，Dogecoin 只使用这种格式
+struct RawTransaction {
+    int32_t version = 1;
+    std::vector<TxInput> inputs;
+    std::vector<TxOutput> outputs;
+    uint32_t locktime = 0;
+};
+
+// Base58 / Base58Check
+class Base58 {
+public:
+    static std::string encode(const uint8_t* data, size_t size);
+    static std::string encode(const std::vector<uint8_t>& data) { return encode(data.data(), data.size()); }
+    static bool decode(const std::string& str, std::vector<uint8_t>& out);
+
+    // 末尾附加 HASH256 前 4 字节校验
+    static std::string encode_check(const std::vector<uint8_t>& payload);
+    static bool decode_check(const std::string& str, std::vector<uint8_t>& payload);
+};
+
+// 锁定/解锁脚本构造
+class Script {
+public:
+    enum Opcode : uint8_t {
+        OP_0 = 0x00,
+        OP_PUSHDATA1 = 0x4c,
+        OP_PUSHDATA2 = 0x4d,
+        OP_PUSHDATA4 = 0x4e,
+        OP_1 = 0x51,
+        OP_TRUE = 0x51,
+        OP_RETURN = 0x6a,
+        OP_DROP = 0x75,
+        OP_DUP = 0x76,
+        OP_EQUAL = 0x87,
+        OP_EQUALVERIFY = 0x88,
+        OP_HASH160 = 0xa9,
+        OP_CHECKSIG = 0xac,
+        OP_CHECKSIGVERIFY = 0xad,
+    };
+
+    // 按最短编码追加数据推送（直接长度 / PUSHDATA1/2/4）
+    static void push_data(std::vector<uint8_t>& script, const uint8_t* data, size_t size);
+    static void push_data(std::vector<uint8_t>& script, const std::vector<uint8_t>& data) {
+        push_data(script, data.data(), data.size());
+    }
+    // 最短编码的整数推送（OP_0 / OP_1..OP_16 / 小端脚本数字）
+    static void push_int(std::vector<uint8_t>& script, int64_t value);
+
+    static std::vector<uint8_t> p2pkh(const std::vector<uint8_t>& pubkey_hash);
+    static std::vector<uint8_t> p2sh(const std::vector<uint8_t>& script_hash);
+    static std::vector<uint8_t> op_return(const std::vector<uint8_t>& data);
+    static std::vector<uint8_t> p2pkh_script_sig(const std::vector<uint8_t>& signature,
+                                                 const std::vector<uint8_t>& public_key);
+
+    // 地址 -> 锁定脚本；地址无效或网络不符时抛异常
+    static std::vector<uint8_t> for_address(const std::string& address,
+                                            const DogecoinNetwork& network = DogecoinNetwork::mainnet());
+
+    // P2PKH 脚本中的公钥哈希；不是 P2PKH 时返回 false
+    static bool extract_pubkey_hash(const std::vector<uint8_t>& script, std::vector<uint8_t>& pubkey_hash);
+};
+
+// secp256k1 私钥上下文：公钥、HASH160 等在构造时计算一次，批量签名时复用
+// 签名使用 RFC 6979 确定性 nonce 并规范化为 low-S，同一输入总得到同一签名
+class Secp256k1Key {
+public:
+    explicit Secp256k1Key(const std::vector<uint8_t>& secret, bool compressed = true);
+    ~Secp256k1Key();
+    Secp256k1Key(Secp256k1Key&&) noexcept;
+    Secp256k1Key& operator=(Secp256k1Key&&) noexcept;
+    Secp256k1Key(const Secp256k1Key&) = delete;
+    Secp256k1Key& operator=(const Secp256k1Key&) = delete;
+
+    // WIF 私钥；校验和或网络不符时抛异常
+    static Secp256k1Key from_wif(const std::string& wif,
+                                 const DogecoinNetwork& network = DogecoinNetwork::mainnet());
+
+    const std::vector<uint8_t>& public_key() const;
+    const std::vector<uint8_t>& pubkey_hash() const;
+    std::string address(const DogecoinNetwork& network = DogecoinNetwork::mainnet()) const;
+
+    // 对 32 字节摘要签名，返回 DER 编码（不含 sighash 类型字节）
+    std::vector<uint8_t> sign(const uint8_t* digest32) const;
+
+    // 用序列化公钥（压缩或非压缩）校验 DER 签名
+    static bool verify(const std::vector<uint8_t>& public_key, const uint8_t* digest32,
+                       const std::vector<uint8_t>& signature);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// 哈希工具
+class TxHash {
+public:
+    static std::vector<uint8_t> hash256(const uint8_t* data, size_t size);
+    static std::vector<uint8_t> hash256(const std::vector<uint8_t>& data) { return hash256(data.data(), data.size()); }
+    static std::vector<uint8_t> hash160(const uint8_t* data, size_t size);
+    static std::vector<uint8_t> hash160(const std::vector<uint8_t>& data) { return hash160(data.data(), data.size()); }
+};
+
+// 交易序列化与签名哈希
+class TxSerializer {
+public:
+    static constexpr uint32_t SIGHASH_ALL = 0x01;
+
+    static std::vector<uint8_t> serialize(const RawTransaction& tx);
+    static std::string to_hex(const RawTransaction& tx);
+    static bool parse(const std::vector<uint8_t>& data, RawTransaction& tx);
+
+    // 交易 ID（HASH256 反序 hex）
+    static std::string txid(const RawTransaction& tx);
+
+    // 传统签名哈希：其他输入脚本置空，被签输入替换为 script_code
+    static std::vector<uint8_t> signature_hash(const RawTransaction& tx, size_t input_index,
+                                               const std::vector<uint8_t>& script_code,
+                                               uint32_t sighash_type = SIGHASH_ALL);
+
+    static void write_varint(std::vector<uint8_t>& out, uint64_t value);
+};
+
+// 建交易参数（Dogecoin Core 1.14 默认值：0.01 DOGE/kB 手续费，0.01 DOGE 找零下限）
+struct TxBuildOptions {
+    uint64_t fee_per_kb = 1000000;
+    uint64_t dust_limit = 1000000;
+    std::vector<uint8_t> change_script;    // 为空时不找零，余额全部作为手续费
+    size_t pubkey_size = 33;               // 签名公钥长度：压缩 33，未压缩 65
+};
+
+// 由 UTXO 与目标输出组装未签名交易：使用全部输入，按签名后大小估算手续费并添加找零
+class TxBuilder {
+public:
+    static RawTransaction build(const std::vector<TxInput>& utxos,
+                                const std::vector<TxOutput>& outputs,
+                                const TxBuildOptions& options);
+
+    // 所有未签名输入均为 P2PKH、公钥长 pubkey_size 字节时，签名后的交易字节数上限
+    static size_t estimate_signed_size(const RawTransaction& tx, size_t pubkey_size = 33);
+
+    // 按字节数计费（向上取整到 koinu）
+    static uint64_t fee_for_size(size_t size, uint64_t fee_per_kb);
+};
+
+// 批量签名器：按公钥哈希缓存私钥上下文，签名所有 P2PKH 输入
+class TxSigner {
+public:
+    void add_key(Secp256k1Key key);
+    size_t key_count() const { return keys_.size(); }
+
+    // 签名单笔交易；缺少某个输入对应的私钥时抛异常
+    void sign(RawTransaction& tx) const;
+
+    // 用指定私钥签名一个 P2PKH 输入（SIGHASH_ALL）
+    static void sign_input(RawTransaction& tx, size_t index, const Secp256k1Key& key);
+
+    // 并行签名一批交易（jobs 为 0 时使用硬件并发数）；任一失败则抛出第一个错误
+    void sign_batch(std::vector<RawTransaction>& txs, unsigned jobs = 0) const;
+
+private:
+    std::unordered_map<std::string, Secp256k1Key> keys_;  // HASH160 原始字节 -> 私钥
+};
+
+} // namespace cardity
+
+#endif // CARDITY_DOGECOIN_TX_H
@@ -1,7 +1,7 @@
 #include "drc20_compiler.h"
+#include "tokenizer.h"
 #include <fstream>
 #include <sstream>
-#include <regex>
 
 namespace cardity {
 
@@ -13,33 +13,20 @@ json Drc20Compiler::compile_drc20_protocol(const std::string& source) {
     
     json token_definition;
     
-    // 简单的正则表达式解析来提取 DRC-20 参数
-    std::regex tick_regex("tick:\\s*\"([^\"]+)\"");
-    std::regex max_supply_regex("max_supply:\\s*\"([^\"]+)\"");
-    std::regex mint_limit_regex("mint_limit:\\s*\"([^\"]+)\"");
-    std::regex decimals_regex("decimals:\\s*\"([^\"]+)\"");
-    std::regex deployer_regex("deployer:\\s*\"([^\"]+)\"");
-    
-    std::smatch matches;
-    
-    if (std::regex_search(source, matches, tick_regex)) {
-        token_definition["tick"] = matches[1].str();
-    }
-    
-    if (std::regex_search(source, matches, max_supply_regex)) {
-        token_definition["max_supply"] = matches[1].str();
-    }
-    
-    if (std::regex_search(source, matches, mint_limit_regex)) {
-        token_definition["mint_limit"] = matches[1].str();
-    }
-    
-    if (std::regex_search(source, matches, decimals_regex)) {
-        token_definition["decimals"] = matches[1].str();
-    }
-    
-    if (std::regex_search(source, matches, deployer_regex)) {
-        token_definition["deployer"] = matches[1].str();
+    // 单次扫描 token 流提取 DRC-20 参数：key: "value"（每个 key 取首次出现）
+    static const char* const keys[] = {"tick", "max_supply", "mint_limit", "decimals", "deployer"};
+    std::vector<Token> toks = tokenize_all(source, true);
+    for (size_t i = 0; i + 2 < toks.size(); ++i) {
+        if (!is_word_token(toks[i]) || toks[i + 1].type != TokenType::COLON ||
+            toks[i + 2].type != TokenType::STRING || toks[i + 2].value.empty()) {
+            continue;
+        }
+        for (const char* key : keys) {
+            if (toks[i].value == key && !token_definition.contains(key)) {
+                token_definition[key] = toks[i + 2].value;
+                break;
+            }
+        }
     }
     
     // 验证代币定义
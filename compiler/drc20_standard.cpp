@@ -1,5 +1,4 @@
 #include "drc20_standard.h"
-#include <regex>
 #include <chrono>
 #include <iomanip>
 #include <sstream>
@@ -166,13 +165,22 @@ bool Drc20Standard::is_valid_tick_length(const std::string& tick) {
 }
 
 bool Drc20Standard::is_valid_tick_chars(const std::string& tick) {
-    std::regex tick_regex("^[A-Za-z0-9]+$");
-    return std::regex_match(tick, tick_regex);
+    // ^[A-Za-z0-9]+$
+    if (tick.empty()) return false;
+    for (char c : tick) {
+        bool ok = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9');
+        if (!ok) return false;
+    }
+    return true;
 }
 
 bool Drc20Standard::is_valid_number(const std::string& num) {
-    std::regex number_regex("^[0-9]+$");
-    return std::regex_match(num, number_regex);
+    // ^[0-9]+$
+    if (num.empty()) return false;
+    for (char c : num) {
+        if (c < '0' || c > '9') return false;
+    }
+    return true;
 }
 
 bool Drc20Standard::is_valid_address(const std::string& address) {
@@ -1,8 +1,10 @@
 #include "event_system.h"
+#include "tokenizer.h"
+#include "invoke_codec.h"
 #include <iostream>
 #include <fstream>
-#include <regex>
 #include <algorithm>
+#include <cstdio>
 
 namespace cardity {
 
@@ -100,15 +102,26 @@ nlohmann::json ABIGenerator::generate_abi() const {
     for (auto& [method_name, method_data] : methods.items()) {
         nlohmann::json method_abi;
         
+        // 选择器：签名 name(type,...) 的 SHA-256 前 4 字节，运行时据此分派
+        char selector[16];
+        std::snprintf(selector, sizeof(selector), "0x%08x", InvokeCodec::method_selector(method_name, method_data));
+        method_abi["selector"] = selector;
+        
         // 参数
         if (method_data.contains("params")) {
             nlohmann::json params_abi = nlohmann::json::array();
-            auto params = method_data["params"];
+            const auto& params = method_data["params"];
+            const nlohmann::json param_types = method_data.value("param_types", nlohmann::json::array());
             
             for (size_t i = 0; i < params.size(); ++i) {
                 nlohmann::json param_abi;
                 param_abi["name"] = params[i];
-                param_abi["type"] = "string"; // 默认类型，可以从状态定义推断
+                // 与选择器签名一致：有类型标注用标注，否则默认 string
+                if (i < param_types.size() && param_types[i].is_string() && !param_types[i].get<std::string>().empty()) {
+                    param_abi["type"] = param_types[i];
+                } else {
+                    param_abi["type"] = "string";
+                }
                 params_abi.push_back(param_abi);
             }
             
@@ -224,48 +237,59 @@ nlohmann::json ABIGenerator::parse_programming_language_format(const std::string
     std::string protocol_name = "unknown";
     std::string version = "1.0.0";
     
-    // 使用正则表达式解析编程语言格式
-    std::regex protocol_regex("protocol\\s+(\\w+)\\s*\\{");
-    std::regex version_regex("version:\\s*\"([^\"]+)\"");
-    std::regex method_regex("method\\s+(\\w+)\\s*\\([^)]*\\)\\s*\\{");
-    std::regex event_regex("event\\s+(\\w+)\\s*\\{");
+    // 基于 token 流解析编程语言格式（tolerant 模式下跳过注释中的未知字符）
+    std::vector<Token> toks = tokenize_all(content, true);
+    auto is_type = [&](size_t i, TokenType t) { return i < toks.size() && toks[i].type == t; };
+    auto is_word = [&](size_t i) { return i < toks.size() && is_word_token(toks[i]); };
     
-    std::smatch matches;
-    
-    // 提取协议名
-    if (std::regex_search(content, matches, protocol_regex)) {
-        protocol_name = matches[1].str();
-    }
+    nlohmann::json methods;
+    std::vector<std::string> event_names;
+    bool found_protocol = false;
+    bool found_version = false;
     
-    // 提取版本
-    if (std::regex_search(content, matches, version_regex)) {
-        version = matches[1].str();
+    for (size_t i = 0; i < toks.size(); ++i) {
+        const std::string& v = toks[i].value;
+        if (!is_word(i)) continue;
+        
+        // 提取协议名：protocol Name {
+        if (!found_protocol && v == "protocol" && is_word(i + 1) && is_type(i + 2, TokenType::LBRACE)) {
+            protocol_name = toks[i + 1].value;
+            found_protocol = true;
+        }
+        // 提取版本：version: "x.y.z"
+        else if (!found_version && v == "version" && is_type(i + 1, TokenType::COLON) &&
+                 is_type(i + 2, TokenType::STRING) && !toks[i + 2].value.empty()) {
+            version = toks[i + 2].value;
+            found_version = true;
+        }
+        // 解析方法：method name(...) {
+        else if (v == "method" && is_word(i + 1) && is_type(i + 2, TokenType::LPAREN)) {
+            size_t j = i + 3;
+            while (j < toks.size() && toks[j].type != TokenType::RPAREN) ++j;
+            if (is_type(j + 1, TokenType::LBRACE)) {
+                std::string method_name = toks[i + 1].value;
+                nlohmann::json method;
+                method["name"] = method_name;
+                method["params"] = nlohmann::json::array();
+                method["returns"] = nullptr;
+                methods[method_name] = method;
+                i = j + 1;
+            }
+        }
+        // 解析事件：event Name {
+        else if (v == "event" && is_word(i + 1) && is_type(i + 2, TokenType::LBRACE)) {
+            event_names.push_back(toks[i + 1].value);
+            i += 2;
+        }
     }
     
     ABIGenerator generator(protocol_name, version);
     
-    // 解析方法
-    nlohmann::json methods;
-    std::string::const_iterator search_start(content.cbegin());
-    
-    while (std::regex_search(search_start, content.cend(), matches, method_regex)) {
-        std::string method_name = matches[1].str();
-        nlohmann::json method;
-        method["name"] = method_name;
-        method["params"] = nlohmann::json::array();
-        method["returns"] = nullptr;
-        methods[method_name] = method;
-        search_start = matches.suffix().first;
-    }
-    
     generator.set_methods(methods);
     
     // 解析事件（简化版本）
     std::unordered_map<std::string, EventDefinition> events;
-    search_start = content.cbegin();
-    
-    while (std::regex_search(search_start, content.cend(), matches, event_regex)) {
-        std::string event_name = matches[1].str();
+    for (const auto& event_name : event_names) {
         EventDefinition event_def(event_name);
         
         // 简单的事件参数解析
@@ -285,7 +309,6 @@ nlohmann::json ABIGenerator::parse_programming_language_format(const std::string
         }
         
         events[event_name] = event_def;
-        search_start = matches.suffix().first;
     }
     
     generator.set_events(events);
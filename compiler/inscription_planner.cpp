@@ -0,0 +1,346 @@
+#include "inscription_planner.h"
+#include "codec.h"
+#include "sha256.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace cardity {
+
+namespace {
+
+// 单个分片的 reveal 序列
+struct PartChain {
+    std::vector<InscriptionPartial> partials;
+    std::vector<std::vector<uint8_t>> locks;
+    std::vector<std::vector<uint8_t>> lock_outputs;    // P2SH(lock)
+};
+
+} // namespace
+
+std::vector<InscriptionPartial> InscriptionPlanner::split_partials(const std::vector<uint8_t>& body,
+                                                                   const std::string& content_type) {
+    if (body.empty()) {
+        throw std::runtime_error("Inscription body is empty");
+    }
+    size_t chunks = (body.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    // 推送按 (序号, 数据) 成对排列；头部 "ord" 之后的第一对为 (块数, content-type)
+    std::vector<std::vector<uint8_t>> items;
+    items.reserve(2 + chunks * 2);
+    std::vector<uint8_t> item;
+    Script::push_data(item, reinterpret_cast<const uint8_t*>("ord"), 3);
+    items.push_back(std::move(item));
+    item.clear();
+    Script::push_int(item, static_cast<int64_t>(chunks));
+    items.push_back(std::move(item));
+    item.clear();
+    Script::push_data(item, reinterpret_cast<const uint8_t*>(content_type.data()), content_type.size());
+    items.push_back(std::move(item));
+    for (size_t i = 0; i < chunks; ++i) {
+        item.clear();
+        Script::push_int(item, static_cast<int64_t>(chunks - i - 1));
+        items.push_back(std::move(item));
+        item.clear();
+        size_t offset = i * CHUNK_SIZE;
+        Script::push_data(item, body.data() + offset, std::min(CHUNK_SIZE, body.size() - offset));
+        items.push_back(std::move(item));
+    }
+
+    std::vector<InscriptionPartial> partials;
+    size_t next = 0;
+    while (next < items.size()) {
+        InscriptionPartial partial;
+        if (partials.empty()) {
+            partial.script = items[next++];
+            partial.pushes = 1;
+        }
+        // 成对加入，超过上限时退回最后一对（每笔至少一对）
+        while (next + 1 < items.size()) {
+            size_t pair = items[next].size() + items[next + 1].size();
+            if (partial.pushes >= 2 && partial.script.size() + pair > MAX_PARTIAL_SIZE) break;
+            partial.script.insert(partial.script.end(), items[next].begin(), items[next].end());
+            partial.script.insert(partial.script.end(), items[next + 1].begin(), items[next + 1].end());
+            partial.pushes += 2;
+            next += 2;
+        }
+        partials.push_back(std::move(partial));
+    }
+    return partials;
+}
+
+std::vector<uint8_t> InscriptionPlanner::lock_script(const std::vector<uint8_t>& public_key, size_t pushes) {
+    std::vector<uint8_t> script;
+    script.reserve(public_key.size() + pushes + 3);
+    Script::push_data(script, public_key);
+    script.push_back(Script::OP_CHECKSIGVERIFY);
+    script.insert(script.end(), pushes, Script::OP_DROP);
+    script.push_back(Script::OP_TRUE);
+    // P2SH 赎回脚本作为单个元素推送，不能超过 520 字节
+    if (script.size() > 520) {
+        throw std::runtime_error("Inscription lock script exceeds 520 bytes");
+    }
+    return script;
+}
+
+InscriptionChain InscriptionPlanner::plan(const std::vector<std::vector<uint8_t>>& bodies,
+                                          const std::vector<TxInput>& utxos,
+                                          const Secp256k1Key& key,
+                                          const InscriptionOptions& options) {
+    if (bodies.empty()) {
+        throw std::runtime_error("Nothing to inscribe");
+    }
+    if (options.destination.empty()) {
+        throw std::runtime_error("Inscription destination address is required");
+    }
+    if (options.postage < options.dust_limit) {
+        throw std::runtime_error("Inscription postage " + std::to_string(options.postage) +
+                                 " koinu is below the dust limit (" + std::to_string(options.dust_limit) + " koinu)");
+    }
+    const DogecoinNetwork& network = options.testnet ? DogecoinNetwork::testnet() : DogecoinNetwork::mainnet();
+    std::vector<uint8_t> destination = Script::for_address(options.destination, network);
+    std::vector<uint8_t> own_script = Script::p2pkh(key.pubkey_hash());
+    std::vector<uint8_t> change_script = options.change_address.empty()
+        ? own_script : Script::for_address(options.change_address, network);
+
+    // 每个分片的推送序列与锁定脚本与金额无关，只计算一次
+    std::vector<PartChain> parts(bodies.size());
+    size_t reveal_count = 0;
+    for (size_t p = 0; p < bodies.size(); ++p) {
+        parts[p].partials = split_partials(bodies[p], options.content_type);
+        for (const auto& partial : parts[p].partials) {
+            parts[p].locks.push_back(lock_script(key.public_key(), partial.pushes));
+            parts[p].lock_outputs.push_back(Script::p2sh(TxHash::hash160(parts[p].locks.back())));
+        }
+        reveal_count += parts[p].partials.size();
+    }
+    // 全部 reveal 都是 commit 的未确认后代；连同 commit 自身不能超过节点的默认上限
+    if (1 + reveal_count > MEMPOOL_DESCENDANT_LIMIT) {
+        throw std::runtime_error("Inscription chain needs " + std::to_string(reveal_count) +
+                                 " reveal transactions; nodes relay at most " +
+                                 std::to_string(MEMPOOL_DESCENDANT_LIMIT - 1) +
+                                 " unconfirmed descendants of the commit");
+    }
+
+    // 大额优先选币；未给脚本的 UTXO 视为私钥自己的 P2PKH 输出
+    std::vector<TxInput> candidates = utxos;
+    for (auto& in : candidates) {
+        if (in.prev_script.empty()) in.prev_script = own_script;
+        in.script_sig.clear();
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const TxInput& a, const TxInput& b) { return a.amount > b.amount; });
+
+    // 按给定的各交易字节数定价、组装并签名整条链；sizes[0] 为 commit，其后按广播顺序为各 reveal
+    auto assemble = [&](const std::vector<size_t>& sizes) {
+        InscriptionChain chain;
+        chain.transactions.reserve(1 + reveal_count);
+
+        // 从最后一笔 reveal 倒推每笔的输入金额：input_j = output_j + fee_j
+        std::vector<std::vector<uint64_t>> inputs(parts.size());
+        size_t index = 1;
+        for (size_t p = 0; p < parts.size(); ++p) {
+            size_t k = parts[p].partials.size();
+            inputs[p].resize(k);
+            uint64_t value = options.postage;
+            for (size_t j = k; j-- > 0;) {
+                value += TxBuilder::fee_for_size(sizes[index + j], options.fee_per_kb);
+                inputs[p][j] = value;
+            }
+            index += k;
+        }
+
+        // commit：每个分片一个 P2SH 输出，其后为找零
+        ChainTransaction commit;
+        commit.role = "commit";
+        uint64_t total_out = 0;
+        for (size_t p = 0; p < parts.size(); ++p) {
+            commit.tx.outputs.push_back(TxOutput{inputs[p][0], parts[p].lock_outputs[0]});
+            total_out += inputs[p][0];
+        }
+        commit.tx.outputs.push_back(TxOutput{0, change_script});
+        uint64_t total_in = 0;
+        for (const auto& in : candidates) {
+            uint64_t needed = total_out + TxBuilder::fee_for_size(
+                TxBuilder::estimate_signed_size(commit.tx, key.public_key().size()), options.fee_per_kb);
+            if (total_in >= needed) break;
+            commit.tx.inputs.push_back(in);
+            total_in += in.amount;
+        }
+        uint64_t commit_fee = TxBuilder::fee_for_size(
+            sizes[0] ? sizes[0] : TxBuilder::estimate_signed_size(commit.tx, key.public_key().size()),
+            options.fee_per_kb);
+        if (total_in < total_out + commit_fee) {
+            throw std::runtime_error("Insufficient funds: UTXOs total " + std::to_string(total_in) +
+                                     " koinu, inscription chain needs " + std::to_string(total_out) +
+                                     " koinu + commit fee " + std::to_string(commit_fee) + " koinu");
+        }
+        uint64_t change = total_in - total_out - commit_fee;
+        if (change >= options.dust_limit) {
+            commit.tx.outputs.back().value = change;
+        } else {
+            commit.tx.outputs.pop_back();
+        }
+        for (size_t i = 0; i < commit.tx.inputs.size(); ++i) {
+            TxSigner::sign_input(commit.tx, i, key);
+        }
+        commit.txid = TxSerializer::txid(commit.tx);
+        commit.size = TxSerializer::serialize(commit.tx).size();
+        uint64_t commit_out = 0;
+        for (const auto& o : commit.tx.outputs) commit_out += o.value;
+        commit.fee = total_in - commit_out;
+        chain.transactions.push_back(std::move(commit));
+
+        // reveal：逐笔花费上一笔的 P2SH 输出
+        for (size_t p = 0; p < parts.size(); ++p) {
+            const PartChain& part = parts[p];
+            std::string prev_txid = chain.transactions.front().txid;
+            uint32_t prev_vout = static_cast<uint32_t>(p);
+            for (size_t j = 0; j < part.partials.size(); ++j) {
+                ChainTransaction reveal;
+                reveal.role = "reveal";
+                reveal.part = p + 1;
+                reveal.step = j + 1;
+                reveal.depends_on = prev_txid;
+
+                TxInput in;
+                in.prev_txid = prev_txid;
+                in.vout = prev_vout;
+                in.amount = inputs[p][j];
+                in.prev_script = part.lock_outputs[j];
+                reveal.tx.inputs.push_back(std::move(in));
+                bool last = j + 1 == part.partials.size();
+                reveal.tx.outputs.push_back(last ? TxOutput{options.postage, destination}
+                                                 : TxOutput{inputs[p][j + 1], part.lock_outputs[j + 1]});
+
+                // scriptSig = 数据推送 + <sig> + <赎回脚本>；签名哈希的 script_code 为赎回脚本
+                std::vector<uint8_t> digest = TxSerializer::signature_hash(reveal.tx, 0, part.locks[j]);
+                std::vector<uint8_t> sig = key.sign(digest.data());
+                sig.push_back(static_cast<uint8_t>(TxSerializer::SIGHASH_ALL));
+                std::vector<uint8_t>& script_sig = reveal.tx.inputs[0].script_sig;
+                script_sig = part.partials[j].script;
+                Script::push_data(script_sig, sig);
+                Script::push_data(script_sig, part.locks[j]);
+
+                reveal.txid = TxSerializer::txid(reveal.tx);
+                reveal.size = TxSerializer::serialize(reveal.tx).size();
+                reveal.fee = inputs[p][j] - reveal.tx.outputs[0].value;
+                if (j == 0) chain.inscription_ids.push_back(reveal.txid + "i0");
+                prev_txid = reveal.txid;
+                prev_vout = 0;
+                chain.transactions.push_back(std::move(reveal));
+            }
+        }
+        return chain;
+    };
+
+    // 签名长度（DER 70~72 字节）影响交易大小，大小又影响金额与签名：
+    // 以上一轮的实际大小重新定价直到不动点；若长度来回跳动，改为只增不减，保证手续费不低于实际大小
+    std::vector<size_t> sizes(1 + reveal_count, 0);
+    InscriptionChain chain;
+    for (int round = 0;; ++round) {
+        chain = assemble(sizes);
+        std::vector<size_t> actual;
+        actual.reserve(sizes.size());
+        for (const auto& t : chain.transactions) actual.push_back(t.size);
+        if (actual == sizes) break;
+        if (round >= 8) {
+            bool covered = true;
+            for (size_t i = 0; i < sizes.size(); ++i) {
+                if (actual[i] > sizes[i]) covered = false;
+                sizes[i] = std::max(sizes[i], actual[i]);
+            }
+            if (covered) break;
+        } else {
+            sizes = std::move(actual);
+        }
+    }
+
+    for (const auto& t : chain.transactions) chain.total_fee += t.fee;
+    return chain;
+}
+
+InscriptionChain InscriptionPlanner::plan_file(const std::string& carc_file,
+                                               const std::vector<TxInput>& utxos,
+                                               const Secp256k1Key& key,
+                                               const InscriptionOptions& options) {
+    std::ifstream ifs(carc_file, std::ios::binary);
+    if (!ifs.is_open()) {
+        throw std::runtime_error("Cannot open file: " + carc_file);
+    }
+    std::vector<uint8_t> carc((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+
+    // 每个 deploy_part 信封是一个独立铭文
+    PartPlan part_plan = PartPlanner::plan(carc.size(), Sha256::hex(carc), carc_file, options.parts);
+    std::vector<std::vector<uint8_t>> bodies;
+    bodies.reserve(part_plan.parts.size());
+    for (const auto& slice : part_plan.parts) {
+        std::string envelope = PartPlanner::envelope_json(part_plan, options.parts, slice, carc.data());
+        bodies.emplace_back(envelope.begin(), envelope.end());
+    }
+
+    InscriptionChain chain = plan(bodies, utxos, key, options);
+    chain.bundle_id = part_plan.bundle_id;
+    return chain;
+}
+
+std::vector<TxInput> InscriptionPlanner::parse_utxos(const json& utxos, const std::vector<uint8_t>& default_script,
+                                                     const DogecoinNetwork& network) {
+    if (!utxos.is_array()) {
+        throw std::runtime_error("UTXO list must be a JSON array");
+    }
+    std::vector<TxInput> result;
+    result.reserve(utxos.size());
+    for (const auto& u : utxos) {
+        TxInput in;
+        in.prev_txid = u.at("txid").get<std::string>();
+        in.vout = u.at("vout").get<uint32_t>();
+        const json& amount = u.at("amount");
+        // listunspent 的 amount 为 DOGE 小数
+        in.amount = amount.is_number_float() ? static_cast<uint64_t>(std::llround(amount.get<double>() * 1e8))
+                                             : amount.get<uint64_t>();
+        std::vector<uint8_t> script;
+        if (u.contains("script_pubkey") || u.contains("scriptPubKey")) {
+            std::string hex = u.contains("script_pubkey") ? u["script_pubkey"].get<std::string>()
+                                                          : u["scriptPubKey"].get<std::string>();
+            if (!Codec::hex_decode(hex, script)) {
+                throw std::runtime_error("Invalid scriptPubKey for UTXO " + in.prev_txid);
+            }
+        } else if (u.contains("address")) {
+            script = Script::for_address(u["address"].get<std::string>(), network);
+        } else {
+            script = default_script;
+        }
+        in.prev_script = std::move(script);
+        result.push_back(std::move(in));
+    }
+    return result;
+}
+
+json InscriptionPlanner::to_json(const InscriptionChain& chain) {
+    json out;
+    out["bundle_id"] = chain.bundle_id;
+    out["total_fee"] = chain.total_fee;
+    out["inscriptions"] = chain.inscription_ids;
+    json txs = json::array();
+    for (const auto& t : chain.transactions) {
+        json item;
+        item["role"] = t.role;
+        if (t.role == "reveal") {
+            item["part"] = t.part;
+            item["step"] = t.step;
+            item["depends_on"] = t.depends_on;
+        }
+        item["txid"] = t.txid;
+        item["size"] = t.size;
+        item["fee"] = t.fee;
+        item["hex"] = TxSerializer::to_hex(t.tx);
+        txs.push_back(std::move(item));
+    }
+    out["transactions"] = std::move(txs);
+    return out;
+}
+
+} // namespace cardity
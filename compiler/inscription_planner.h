@@ -0,0 +1,92 @@
+#ifndef CARDITY_INSCRIPTION_PLANNER_H
+#define CARDITY_INSCRIPTION_PLANNER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include "dogecoin_tx.h"
+#include "part_planner.h"
+
+namespace cardity {
+
+using json = nlohmann::json;
+
+// 铭文链参数
+struct InscriptionOptions {
+    PartOptions parts;                         // package_id/module/version/max_bytes
+    std::string content_type = "application/json";
+    std::string destination;                   // 铭文接收地址
+    std::string change_address;                // 为空时找零到私钥地址
+    uint64_t fee_per_kb = 1000000;
+    uint64_t postage = 1000000;                // 每个铭文最终输出的金额（0.01 DOGE），不得低于 dust_limit
+    uint64_t dust_limit = 1000000;
+    bool testnet = false;
+};
+
+// 一段 reveal 携带的数据推送（doginals 格式）
+struct InscriptionPartial {
+    std::vector<uint8_t> script;               // 已序列化的推送序列
+    size_t pushes = 0;                         // 推送个数（锁定脚本需要等量 OP_DROP）
+};
+
+// 链中的单笔交易
+struct ChainTransaction {
+    std::string role;                          // "commit" 或 "reveal"
+    size_t part = 0;                           // deploy_part 序号（commit 为 0）
+    size_t step = 0;                           // 该分片内的 reveal 序号，从 1 开始
+    RawTransaction tx;
+    std::string txid;
+    std::string depends_on;                    // 父交易 txid（commit 为空）
+    size_t size = 0;
+    uint64_t fee = 0;
+};
+
+struct InscriptionChain {
+    std::string bundle_id;
+    std::vector<ChainTransaction> transactions;    // 广播顺序
+    std::vector<std::string> inscription_ids;      // 每个分片：首个 reveal txid + "i0"
+    uint64_t total_fee = 0;
+};
+
+// commit/reveal 铭文链规划器：一次性构建并签名全部依赖交易，不需要节点
+//   commit：花费钱包 UTXO，为每个分片输出一个 P2SH（锁定脚本 = 公钥校验 + OP_DROP×n + OP_TRUE）
+//   reveal：花费上一笔的 P2SH，scriptSig 携带数据推送；最后一笔把 postage 发到接收地址
+class InscriptionPlanner {
+public:
+    static constexpr size_t CHUNK_SIZE = 240;          // 单个数据推送的字节数
+    static constexpr size_t MAX_PARTIAL_SIZE = 1500;   // 单笔 reveal 的数据推送上限
+    static constexpr size_t MEMPOOL_DESCENDANT_LIMIT = 25;
+
+    // 内容拆分为各 reveal 的推送序列："ord" <块数> <content-type> (<剩余序号> <数据块>)*
+    static std::vector<InscriptionPartial> split_partials(const std::vector<uint8_t>& body,
+                                                          const std::string& content_type);
+
+    // <pubkey> OP_CHECKSIGVERIFY OP_DROP×pushes OP_TRUE
+    static std::vector<uint8_t> lock_script(const std::vector<uint8_t>& public_key, size_t pushes);
+
+    // 规划并签名整条链；手续费按签名后的实际字节数计算。
+    // postage 低于 dust_limit，或 reveal 总数超出内存池后代上限时抛出异常（节点不会转发整条链）
+    static InscriptionChain plan(const std::vector<std::vector<uint8_t>>& bodies,
+                                 const std::vector<TxInput>& utxos,
+                                 const Secp256k1Key& key,
+                                 const InscriptionOptions& options);
+
+    // 读取 .carc，按 deploy_part 信封切分后规划
+    static InscriptionChain plan_file(const std::string& carc_file,
+                                      const std::vector<TxInput>& utxos,
+                                      const Secp256k1Key& key,
+                                      const InscriptionOptions& options);
+
+    // UTXO 列表：[{"txid","vout","amount"(koinu 整数或 listunspent 的 DOGE 小数),
+    //             "address"|"script_pubkey"|"scriptPubKey"}]；未给脚本时使用 default_script
+    static std::vector<TxInput> parse_utxos(const json& utxos, const std::vector<uint8_t>& default_script,
+                                            const DogecoinNetwork& network);
+
+    static json to_json(const InscriptionChain& chain);
+};
+
+} // namespace cardity
+
+#endif // CARDITY_INSCRIPTION_PLANNER_H
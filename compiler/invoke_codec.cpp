@@ -0,0 +1,239 @@
+#include "invoke_codec.h"
+#include "codec.h"
+#include "sha256.h"
+#include <limits>
+#include <stdexcept>
+
+namespace cardity {
+
+namespace {
+
+bool is_integer_type(const std::string& type) {
+    return type == "int" || type == "uint" || type == "number";
+}
+
+// 仅接受规范十进制（无前导零/正号），保证解码后字符串与原值一致
+bool parse_canonical_int(const std::string& s, int64_t& out) {
+    if (s.empty() || s.size() > 20) return false;
+    size_t i = (s[0] == '-') ? 1 : 0;
+    if (i == s.size()) return false;
+    if (s[i] == '0' && (s.size() > i + 1 || i == 1)) return false;
+    for (size_t j = i; j < s.size(); ++j) {
+        if (s[j] < '0' || s[j] > '9') return false;
+    }
+    try {
+        size_t pos = 0;
+        long long v = std::stoll(s, &pos);
+        if (pos != s.size()) return false;
+        out = v;
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t v) {
+    return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+}
+
+} // namespace
+
+std::string InvokeCodec::method_signature(const std::string& name, const json& method) {
+    std::vector<std::string> params;
+    std::vector<std::string> types;
+    if (method.contains("params") && method["params"].is_array()) {
+        params = method["params"].get<std::vector<std::string>>();
+    }
+    if (method.contains("param_types") && method["param_types"].is_array()) {
+        types = method["param_types"].get<std::vector<std::string>>();
+    }
+    std::string sig = name + "(";
+    for (size_t i = 0; i < params.size(); ++i) {
+        if (i > 0) sig += ",";
+        sig += (i < types.size() && !types[i].empty()) ? types[i] : "string";
+    }
+    sig += ")";
+    return sig;
+}
+
+uint32_t InvokeCodec::selector(const std::string& signature) {
+    Sha256 hasher;
+    hasher.update(signature);
+    std::vector<uint8_t> digest = hasher.digest();
+    return (uint32_t(digest[0]) << 24) | (uint32_t(digest[1]) << 16) | (uint32_t(digest[2]) << 8) | digest[3];
+}
+
+uint32_t InvokeCodec::method_selector(const std::string& name, const json& method) {
+    return selector(method_signature(name, method));
+}
+
+void InvokeCodec::write_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t InvokeCodec::read_varint(const uint8_t* data, size_t size, size_t& offset) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (offset >= size) {
+            throw std::runtime_error("Invalid invoke payload: truncated varint");
+        }
+        uint8_t byte = data[offset++];
+        if (shift == 63 && byte > 1) {
+            throw std::runtime_error("Invalid invoke payload: varint overflow");
+        }
+        value |= uint64_t(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            // 最短编码才合法：末字节为 0 说明多写了高位的 0 组，同一数值会有多种编码
+            if (byte == 0 && shift > 0) {
+                throw std::runtime_error("Invalid invoke payload: non-canonical varint");
+            }
+            return value;
+        }
+    }
+    throw std::runtime_error("Invalid invoke payload: varint overflow");
+}
+
+std::vector<uint8_t> InvokeCodec::encode(uint32_t selector, const json& args,
+                                         const std::vector<std::string>& param_types) {
+    if (!args.is_array()) {
+        throw std::runtime_error("Invoke args must be a JSON array");
+    }
+    std::vector<uint8_t> out;
+    out.reserve(16 + args.size() * 8);
+    out.push_back(VERSION);
+    out.push_back(static_cast<uint8_t>(selector >> 24));
+    out.push_back(static_cast<uint8_t>(selector >> 16));
+    out.push_back(static_cast<uint8_t>(selector >> 8));
+    out.push_back(static_cast<uint8_t>(selector));
+    write_varint(out, args.size());
+
+    auto put_string = [&](const std::string& s) {
+        out.push_back(TAG_STRING);
+        write_varint(out, s.size());
+        out.insert(out.end(), s.begin(), s.end());
+    };
+    auto put_int = [&](int64_t v) {
+        out.push_back(TAG_INT);
+        write_varint(out, zigzag(v));
+    };
+
+    for (size_t i = 0; i < args.size(); ++i) {
+        const json& arg = args[i];
+        switch (arg.type()) {
+            case json::value_t::boolean:
+                out.push_back(arg.get<bool>() ? TAG_TRUE : TAG_FALSE);
+                break;
+            case json::value_t::number_integer:
+                put_int(arg.get<int64_t>());
+                break;
+            case json::value_t::number_unsigned: {
+                uint64_t v = arg.get<uint64_t>();
+                if (v <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                    put_int(static_cast<int64_t>(v));
+                } else {
+                    put_string(std::to_string(v));
+                }
+                break;
+            }
+            case json::value_t::string: {
+                const std::string& s = arg.get_ref<const std::string&>();
+                int64_t v = 0;
+                if (i < param_types.size() && is_integer_type(param_types[i]) && parse_canonical_int(s, v)) {
+                    put_int(v);
+                } else {
+                    put_string(s);
+                }
+                break;
+            }
+            default:
+                // 浮点/对象等按其 JSON 文本传递（与运行时字符串参数语义一致）
+                put_string(arg.dump());
+                break;
+        }
+    }
+    return out;
+}
+
+std::vector<uint8_t> InvokeCodec::encode(const json& car, const std::string& method_name, const json& args) {
+    if (!car.contains("cpl") || !car["cpl"].contains("methods") || !car["cpl"]["methods"].contains(method_name)) {
+        throw std::runtime_error("Method not found: " + method_name);
+    }
+    const json& method = car["cpl"]["methods"][method_name];
+    std::vector<std::string> types;
+    if (method.contains("param_types") && method["param_types"].is_array()) {
+        types = method["param_types"].get<std::vector<std::string>>();
+    }
+    size_t expected = method.contains("params") ? method["params"].size() : 0;
+    if (args.is_array() && args.size() != expected) {
+        throw std::runtime_error("Method " + method_name + " expects " + std::to_string(expected) +
+                                 " args, got " + std::to_string(args.size()));
+    }
+    return encode(method_selector(method_name, method), args, types);
+}
+
+DecodedInvoke InvokeCodec::decode(const uint8_t* data, size_t size) {
+    if (size < 5 || data[0] != VERSION) {
+        throw std::runtime_error("Invalid invoke payload: unknown format");
+    }
+    DecodedInvoke result;
+    result.selector = (uint32_t(data[1]) << 24) | (uint32_t(data[2]) << 16) | (uint32_t(data[3]) << 8) | data[4];
+    size_t offset = 5;
+    uint64_t argc = read_varint(data, size, offset);
+    // 每个参数至少 1 字节
+    if (argc > size - offset) {
+        throw std::runtime_error("Invalid invoke payload: bad argument count");
+    }
+    result.args.reserve(static_cast<size_t>(argc));
+    for (uint64_t i = 0; i < argc; ++i) {
+        if (offset >= size) {
+            throw std::runtime_error("Invalid invoke payload: truncated arguments");
+        }
+        uint8_t tag = data[offset++];
+        switch (tag) {
+            case TAG_FALSE:
+                result.args.emplace_back("false");
+                break;
+            case TAG_TRUE:
+                result.args.emplace_back("true");
+                break;
+            case TAG_INT:
+                result.args.push_back(std::to_string(unzigzag(read_varint(data, size, offset))));
+                break;
+            case TAG_STRING: {
+                uint64_t len = read_varint(data, size, offset);
+                if (len > size - offset) {
+                    throw std::runtime_error("Invalid invoke payload: truncated string");
+                }
+                result.args.emplace_back(reinterpret_cast<const char*>(data + offset), static_cast<size_t>(len));
+                offset += static_cast<size_t>(len);
+                break;
+            }
+            default:
+                throw std::runtime_error("Invalid invoke payload: unknown tag " + std::to_string(tag));
+        }
+    }
+    if (offset != size) {
+        throw std::runtime_error("Invalid invoke payload: trailing bytes");
+    }
+    return result;
+}
+
+DecodedInvoke InvokeCodec::decode_hex(const std::string& hex) {
+    std::string digits = hex;
+    if (digits.rfind("0x", 0) == 0 || digits.rfind("0X", 0) == 0) digits = digits.substr(2);
+    std::vector<uint8_t> bytes;
+    if (!Codec::hex_decode(digits, bytes)) {
+        throw std::runtime_error("Invalid invoke payload: bad hex");
+    }
+    return decode(bytes);
+}
+
+} // namespace cardity
@@ -0,0 +1,58 @@
+#ifndef CARDITY_INVOKE_CODEC_H
+#define CARDITY_INVOKE_CODEC_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+
+namespace cardity {
+
+using json = nlohmann::json;
+
+// 二进制调用格式（v1）：
+//   [0xC1][selector: 4 字节大端][argc: varint]{ [tag][payload] }*
+//   tag: 0 = false, 1 = true, 2 = 整数（zigzag varint，int64），3 = 字符串（varint 长度 + UTF-8）
+//   varint 为 LEB128 最短编码，同一调用只有一种合法编码
+// selector 为方法签名 "name(type,...)" 的 SHA-256 前 4 字节；未标注类型的参数按 string 计
+struct DecodedInvoke {
+    uint32_t selector = 0;
+    std::vector<std::string> args;  // 已转换为运行时使用的字符串形式
+};
+
+class InvokeCodec {
+public:
+    static constexpr uint8_t VERSION = 0xC1;
+
+    enum Tag : uint8_t {
+        TAG_FALSE = 0,
+        TAG_TRUE = 1,
+        TAG_INT = 2,
+        TAG_STRING = 3,
+    };
+
+    // 方法签名与选择器
+    static std::string method_signature(const std::string& name, const json& method);
+    static uint32_t selector(const std::string& signature);
+    static uint32_t method_selector(const std::string& name, const json& method);
+
+    // 编码：按 JSON 类型选择 tag；param_types 标注为整数的十进制字符串按整数编码
+    static std::vector<uint8_t> encode(uint32_t selector, const json& args,
+                                       const std::vector<std::string>& param_types = {});
+    // 从 .car JSON 查找方法并编码
+    static std::vector<uint8_t> encode(const json& car, const std::string& method_name, const json& args);
+
+    // 解码；格式错误（未知 tag、非最短 varint、尾随字节等）时抛异常
+    static DecodedInvoke decode(const uint8_t* data, size_t size);
+    static DecodedInvoke decode(const std::vector<uint8_t>& data) { return decode(data.data(), data.size()); }
+    static DecodedInvoke decode_hex(const std::string& hex);
+
+private:
+    static void write_varint(std::vector<uint8_t>& out, uint64_t value);
+    static uint64_t read_varint(const uint8_t* data, size_t size, size_t& offset);
+};
+
+} // namespace cardity
+
+#endif // CARDITY_INVOKE_CODEC_H
@@ -0,0 +1,558 @@
+#include "optimizer.h"
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <sstream>
+
+namespace cardity {
+
+namespace {
+
+const size_t NPOS = static_cast<size_t>(-1);
+
+bool same_tokens(const std::vector<Token>& a, const std::vector<Token>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].type != b[i].type || a[i].value != b[i].value) return false;
+    }
+    return true;
+}
+
+bool is_operand_start(const Token& t) {
+    return is_word_token(t) || t.type == TokenType::NUMBER || t.type == TokenType::STRING;
+}
+
+bool is_operand_end(const Token& t) {
+    return is_operand_start(t) || t.type == TokenType::RPAREN || t.type == TokenType::RBRACKET;
+}
+
+// 查找与 open 位置括号匹配的闭括号
+size_t find_matching(const std::vector<Token>& toks, size_t open, size_t end,
+                     TokenType open_type, TokenType close_type) {
+    int depth = 0;
+    for (size_t k = open; k < end; ++k) {
+        if (toks[k].type == open_type) depth++;
+        else if (toks[k].type == close_type) {
+            depth--;
+            if (depth == 0) return k;
+        }
+    }
+    return NPOS;
+}
+
+// 简单语句的结束位置：深度为 0 的 ';' / 花括号，或两个相邻操作数（源码省略了 ';'）
+size_t scan_simple_end(const std::vector<Token>& toks, size_t begin, size_t end) {
+    int depth = 0;
+    bool prev_operand = false;
+    for (size_t k = begin; k < end; ++k) {
+        const Token& t = toks[k];
+        if (depth == 0) {
+            if (t.type == TokenType::SEMICOLON || t.type == TokenType::LBRACE ||
+                t.type == TokenType::RBRACE) return k;
+            if (prev_operand && is_operand_start(t)) return k;
+        }
+        if (t.type == TokenType::LPAREN || t.type == TokenType::LBRACKET) depth++;
+        else if (t.type == TokenType::RPAREN || t.type == TokenType::RBRACKET) {
+            if (--depth < 0) return k;
+        }
+        prev_operand = is_operand_end(t);
+    }
+    return end;
+}
+
+bool parse_block(const std::vector<Token>& toks, size_t begin, size_t end,
+                 std::vector<IRStatement>& out) {
+    size_t i = begin;
+    while (i < end) {
+        const Token& t = toks[i];
+        IRStatement stmt;
+
+        if (t.type == TokenType::SEMICOLON) {
+            stmt.terminated = true;
+            out.push_back(std::move(stmt));
+            ++i;
+            continue;
+        }
+
+        if (t.type == TokenType::LBRACE || t.type == TokenType::RBRACE) {
+            return false; // 裸代码块不做优化
+        }
+
+        if (is_word_token(t) && t.value == "if") {
+            if (i + 1 >= end || toks[i + 1].type != TokenType::LPAREN) return false;
+            size_t rp = find_matching(toks, i + 1, end, TokenType::LPAREN, TokenType::RPAREN);
+            if (rp == NPOS || rp + 1 >= end || toks[rp + 1].type != TokenType::LBRACE) return false;
+            size_t rb = find_matching(toks, rp + 1, end, TokenType::LBRACE, TokenType::RBRACE);
+            if (rb == NPOS) return false;
+
+            stmt.kind = IRStatement::Kind::IF;
+            stmt.expr.assign(toks.begin() + i + 2, toks.begin() + rp);
+            if (!parse_block(toks, rp + 2, rb, stmt.body)) return false;
+            i = rb + 1;
+            if (i < end && is_word_token(toks[i]) && toks[i].value == "else") return false;
+        } else if (is_word_token(t) && t.value == "emit") {
+            size_t lp = i + 1;
+            while (lp < end && toks[lp].type != TokenType::LPAREN &&
+                   toks[lp].type != TokenType::SEMICOLON) ++lp;
+            if (lp >= end || toks[lp].type != TokenType::LPAREN) return false;
+            size_t rp = find_matching(toks, lp, end, TokenType::LPAREN, TokenType::RPAREN);
+            if (rp == NPOS) return false;
+            stmt.kind = IRStatement::Kind::EMIT;
+            stmt.expr.assign(toks.begin() + i, toks.begin() + rp + 1);
+            i = rp + 1;
+        } else {
+            // return 后紧跟表达式，不能按相邻操作数切分
+            size_t scan_from = (is_word_token(t) && t.value == "return") ? i + 1 : i;
+            size_t stop = scan_simple_end(toks, scan_from, end);
+            if (stop <= i) return false;
+
+            size_t eq = NPOS;
+            int depth = 0;
+            for (size_t k = i; k < stop; ++k) {
+                if (toks[k].type == TokenType::LPAREN || toks[k].type == TokenType::LBRACKET) depth++;
+                else if (toks[k].type == TokenType::RPAREN || toks[k].type == TokenType::RBRACKET) depth--;
+                else if (depth == 0 && toks[k].type == TokenType::EQUAL) { eq = k; break; }
+            }
+            if (eq != NPOS && eq > i) {
+                stmt.kind = IRStatement::Kind::ASSIGN;
+                stmt.target.assign(toks.begin() + i, toks.begin() + eq);
+                stmt.expr.assign(toks.begin() + eq + 1, toks.begin() + stop);
+            } else {
+                stmt.kind = IRStatement::Kind::OTHER;
+                stmt.expr.assign(toks.begin() + i, toks.begin() + stop);
+            }
+            i = stop;
+        }
+
+        if (i < end && toks[i].type == TokenType::SEMICOLON) {
+            stmt.terminated = true;
+            ++i;
+        }
+        out.push_back(std::move(stmt));
+    }
+    return true;
+}
+
+void flatten_into(const std::vector<IRStatement>& statements, std::vector<Token>& out) {
+    for (const auto& stmt : statements) {
+        switch (stmt.kind) {
+            case IRStatement::Kind::ASSIGN:
+                out.insert(out.end(), stmt.target.begin(), stmt.target.end());
+                out.emplace_back(TokenType::EQUAL, "=", 0, 0);
+                out.insert(out.end(), stmt.expr.begin(), stmt.expr.end());
+                break;
+            case IRStatement::Kind::IF:
+                out.emplace_back(TokenType::IDENTIFIER, "if", 0, 0);
+                out.emplace_back(TokenType::LPAREN, "(", 0, 0);
+                out.insert(out.end(), stmt.expr.begin(), stmt.expr.end());
+                out.emplace_back(TokenType::RPAREN, ")", 0, 0);
+                out.emplace_back(TokenType::LBRACE, "{", 0, 0);
+                flatten_into(stmt.body, out);
+                out.emplace_back(TokenType::RBRACE, "}", 0, 0);
+                break;
+            case IRStatement::Kind::EMIT:
+            case IRStatement::Kind::OTHER:
+                out.insert(out.end(), stmt.expr.begin(), stmt.expr.end());
+                break;
+        }
+        if (stmt.terminated) out.emplace_back(TokenType::SEMICOLON, ";", 0, 0);
+    }
+}
+
+// ---- 变量引用分析 ----
+
+// state . name / local . name 引用
+struct VarRef {
+    std::string scope;
+    std::string name;
+    bool indexed;
+};
+
+std::vector<VarRef> collect_refs(const std::vector<Token>& toks) {
+    std::vector<VarRef> refs;
+    for (size_t k = 0; k + 2 < toks.size(); ++k) {
+        if (!is_word_token(toks[k]) || (toks[k].value != "state" && toks[k].value != "local")) continue;
+        if (toks[k + 1].type != TokenType::DOT || !is_word_token(toks[k + 2])) continue;
+        if (k > 0 && toks[k - 1].type == TokenType::DOT) continue; // 例如 ctx.state.x
+        bool indexed = k + 3 < toks.size() && toks[k + 3].type == TokenType::LBRACKET;
+        refs.push_back({toks[k].value, toks[k + 2].value, indexed});
+    }
+    return refs;
+}
+
+void collect_reads(const std::vector<Token>& toks, const std::string& scope,
+                   std::set<std::string>& out) {
+    for (const auto& r : collect_refs(toks)) {
+        if (r.scope == scope) out.insert(r.name);
+    }
+}
+
+// 赋值目标是否为单个变量（state . x / local . x），返回变量名
+bool simple_target(const IRStatement& stmt, const std::string& scope, std::string& name) {
+    if (stmt.kind != IRStatement::Kind::ASSIGN || stmt.target.size() != 3) return false;
+    if (stmt.target[0].value != scope || stmt.target[1].type != TokenType::DOT ||
+        !is_word_token(stmt.target[2])) return false;
+    name = stmt.target[2].value;
+    return true;
+}
+
+// 表达式是否无副作用（不含调用）
+bool is_pure(const std::vector<Token>& toks) {
+    for (size_t k = 0; k < toks.size(); ++k) {
+        if (is_word_token(toks[k]) && toks[k].value == "emit") return false;
+        if (k + 1 < toks.size() && is_word_token(toks[k]) && toks[k + 1].type == TokenType::LPAREN) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool statement_has_call(const IRStatement& stmt) {
+    if (stmt.kind == IRStatement::Kind::EMIT) return true;
+    if (!is_pure(stmt.expr) || !is_pure(stmt.target)) return true;
+    for (const auto& s : stmt.body) {
+        if (statement_has_call(s)) return true;
+    }
+    return false;
+}
+
+// 语句（含嵌套）读取的变量：赋值左值中的下标表达式也算读取
+void statement_reads(const IRStatement& stmt, const std::string& scope, std::set<std::string>& out) {
+    collect_reads(stmt.expr, scope, out);
+    if (stmt.kind == IRStatement::Kind::ASSIGN) {
+        std::string name;
+        if (!simple_target(stmt, scope, name)) collect_reads(stmt.target, scope, out);
+    }
+    for (const auto& s : stmt.body) statement_reads(s, scope, out);
+}
+
+// ---- 常量折叠 ----
+
+bool parse_int64(const std::string& s, long long& out) {
+    if (s.empty()) return false;
+    long long v = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return false;
+        if (__builtin_mul_overflow(v, 10LL, &v) || __builtin_add_overflow(v, (long long)(c - '0'), &v)) {
+            return false;
+        }
+    }
+    out = v;
+    return true;
+}
+
+// 非负整数字面量，且在 std::stoi 的范围内（运行时 + - 与比较按 int 求值）
+bool parse_runtime_int(const std::string& s, long long& out) {
+    return parse_int64(s, out) && out <= std::numeric_limits<int>::max();
+}
+
+// 运行时的赋值右值只支持单个二元运算：+ - 按 int（stoi）计算，* / 按 long long（stoll）计算。
+// 只折叠 “数字 运算符 数字”，且要求运行时不会溢出、结果可用单个非负 NUMBER 表示；
+// 除数为 0 时运行时得 0，这里保持原样不折叠
+bool fold_binary(const std::vector<Token>& toks, long long& value) {
+    if (toks.size() != 3 || toks[0].type != TokenType::NUMBER || toks[2].type != TokenType::NUMBER) {
+        return false;
+    }
+    long long a, b;
+    switch (toks[1].type) {
+        case TokenType::PLUS:
+        case TokenType::MINUS:
+            if (!parse_runtime_int(toks[0].value, a) || !parse_runtime_int(toks[2].value, b)) return false;
+            value = toks[1].type == TokenType::PLUS ? a + b : a - b;
+            return value >= 0 && value <= std::numeric_limits<int>::max();
+        case TokenType::MULTIPLY:
+            return parse_int64(toks[0].value, a) && parse_int64(toks[2].value, b) &&
+                   !__builtin_mul_overflow(a, b, &value);
+        case TokenType::DIVIDE:
+            if (!parse_int64(toks[0].value, a) || !parse_int64(toks[2].value, b) || b == 0) return false;
+            value = a / b;
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool is_literal(const Token& t) {
+    return t.type == TokenType::NUMBER || t.type == TokenType::STRING ||
+           t.type == TokenType::KEYWORD_TRUE || t.type == TokenType::KEYWORD_FALSE;
+}
+
+// 条件为 “字面量 比较符 字面量” 时求值（单独的 true/false 运行时不支持，不折叠）
+bool evaluate_literal_condition(const std::vector<Token>& cond, bool& result) {
+    if (cond.size() != 3 || !is_literal(cond[0]) || !is_literal(cond[2])) return false;
+    const std::string& a = cond[0].value;
+    const std::string& b = cond[2].value;
+    switch (cond[1].type) {
+        // 运行时按解析后的字符串比较相等性
+        case TokenType::EQUAL_EQUAL: result = a == b; return true;
+        case TokenType::NOT_EQUAL: result = a != b; return true;
+        default: break;
+    }
+    long long x, y;
+    if (cond[0].type != TokenType::NUMBER || cond[2].type != TokenType::NUMBER ||
+        !parse_runtime_int(a, x) || !parse_runtime_int(b, y)) return false;
+    switch (cond[1].type) {
+        case TokenType::GREATER_THAN: result = x > y; return true;
+        case TokenType::LESS_THAN: result = x < y; return true;
+        case TokenType::GREATER_EQUAL: result = x >= y; return true;
+        case TokenType::LESS_EQUAL: result = x <= y; return true;
+        default: return false;
+    }
+}
+
+// 语句（含嵌套）写入的 state/local 变量名
+void collect_writes(const std::vector<IRStatement>& statements, std::set<std::string>& out) {
+    for (const auto& stmt : statements) {
+        if (stmt.kind == IRStatement::Kind::ASSIGN && stmt.target.size() >= 3 &&
+            (stmt.target[0].value == "state" || stmt.target[0].value == "local") &&
+            stmt.target[1].type == TokenType::DOT) {
+            out.insert(stmt.target[2].value);
+        }
+        collect_writes(stmt.body, out);
+    }
+}
+
+// 是否含 emit 以外的调用（外部协议调用可能修改状态）
+bool body_has_external_call(const std::vector<IRStatement>& statements) {
+    for (const auto& stmt : statements) {
+        if (stmt.kind != IRStatement::Kind::EMIT && (!is_pure(stmt.expr) || !is_pure(stmt.target))) return true;
+        if (body_has_external_call(stmt.body)) return true;
+    }
+    return false;
+}
+
+size_t count_tokens(const std::vector<IRStatement>& statements) {
+    return MethodIRBuilder::flatten(statements).size();
+}
+
+} // namespace
+
+// ---- MethodIRBuilder ----
+
+MethodIR MethodIRBuilder::build(const std::vector<Token>& tokens) {
+    MethodIR ir;
+    ir.valid = parse_block(tokens, 0, tokens.size(), ir.statements);
+    if (!ir.valid) ir.statements.clear();
+    return ir;
+}
+
+std::vector<Token> MethodIRBuilder::flatten(const std::vector<IRStatement>& statements) {
+    std::vector<Token> out;
+    flatten_into(statements, out);
+    return out;
+}
+
+std::string MethodIRBuilder::to_logic(const std::vector<Token>& tokens) {
+    std::string logic;
+    for (const auto& t : tokens) {
+        logic += t.value + " ";
+    }
+    if (!logic.empty() && logic.back() == ' ') logic.pop_back();
+    return logic;
+}
+
+std::string MethodIRBuilder::to_return_expr(const std::vector<Token>& tokens) {
+    std::string expr;
+    for (const auto& t : tokens) {
+        expr += t.value + " ";
+    }
+    return expr;
+}
+
+// ---- MethodOptimizationReport ----
+
+bool MethodOptimizationReport::changed() const {
+    return folded_constants || removed_self_assignments || removed_dead_stores ||
+           removed_noops || fused_guards;
+}
+
+std::string MethodOptimizationReport::summary() const {
+    std::ostringstream oss;
+    oss << method << ": ";
+    if (skipped) {
+        oss << "skipped (unsupported construct)";
+        return oss.str();
+    }
+    oss << "folded=" << folded_constants
+        << " self_assign=" << removed_self_assignments
+        << " dead_stores=" << removed_dead_stores
+        << " noops=" << removed_noops
+        << " fused_guards=" << fused_guards;
+    oss << " tokens " << tokens_before << " -> " << tokens_after;
+    return oss.str();
+}
+
+// ---- Optimizer ----
+
+int Optimizer::fold_expression(std::vector<Token>& tokens) {
+    long long value;
+    if (!fold_binary(tokens, value)) return 0;
+    tokens = {Token(TokenType::NUMBER, std::to_string(value), tokens[0].line, tokens[0].column)};
+    return 1;
+}
+
+int Optimizer::fold_constants(std::vector<IRStatement>& statements) {
+    // 只折叠赋值右值与 if 条件：下标、emit 参数与 returns 在运行时按原文处理，折叠会改变结果
+    int folded = 0;
+    std::vector<IRStatement> result;
+    result.reserve(statements.size());
+    for (auto& stmt : statements) {
+        if (stmt.kind == IRStatement::Kind::ASSIGN) {
+            folded += fold_expression(stmt.expr);
+        }
+
+        if (stmt.kind == IRStatement::Kind::IF) {
+            folded += fold_constants(stmt.body);
+            bool taken;
+            if (evaluate_literal_condition(stmt.expr, taken)) {
+                folded++;
+                // 条件恒真：主体并入外层；恒假：整条删除
+                if (taken) {
+                    for (auto& inner : stmt.body) result.push_back(std::move(inner));
+                }
+                continue;
+            }
+        }
+        result.push_back(std::move(stmt));
+    }
+    statements = std::move(result);
+    return folded;
+}
+
+int Optimizer::remove_self_assignments(std::vector<IRStatement>& statements) {
+    int removed = 0;
+    std::vector<IRStatement> result;
+    result.reserve(statements.size());
+    for (auto& stmt : statements) {
+        if (stmt.kind == IRStatement::Kind::ASSIGN && !stmt.target.empty() &&
+            (stmt.target[0].value == "state" || stmt.target[0].value == "local") &&
+            same_tokens(stmt.target, stmt.expr) && is_pure(stmt.target)) {
+            removed++;
+            continue;
+        }
+        removed += remove_self_assignments(stmt.body);
+        result.push_back(std::move(stmt));
+    }
+    statements = std::move(result);
+    return removed;
+}
+
+int Optimizer::remove_noops(std::vector<IRStatement>& statements) {
+    int removed = 0;
+    std::vector<IRStatement> result;
+    result.reserve(statements.size());
+    for (auto& stmt : statements) {
+        if (stmt.kind == IRStatement::Kind::OTHER && stmt.expr.empty()) {
+            removed++;
+            continue;
+        }
+        if (stmt.kind == IRStatement::Kind::IF) {
+            removed += remove_noops(stmt.body);
+            if (stmt.body.empty() && is_pure(stmt.expr)) {
+                removed++;
+                continue;
+            }
+        }
+        result.push_back(std::move(stmt));
+    }
+    statements = std::move(result);
+    return removed;
+}
+
+int Optimizer::fuse_guard_chains(std::vector<IRStatement>& statements) {
+    // if (c) { A } if (c) { B } => if (c) { A B }
+    // 要求 c 无副作用，且 A 不写入 c 读取的变量、不含外部调用（emit 除外）
+    int fused = 0;
+    std::vector<IRStatement> result;
+    result.reserve(statements.size());
+    for (auto& stmt : statements) {
+        if (stmt.kind == IRStatement::Kind::IF) {
+            fused += fuse_guard_chains(stmt.body);
+        }
+        if (stmt.kind == IRStatement::Kind::IF && !result.empty()) {
+            IRStatement& prev = result.back();
+            if (prev.kind == IRStatement::Kind::IF &&
+                same_tokens(prev.expr, stmt.expr) && is_pure(stmt.expr)) {
+                std::set<std::string> deps, written;
+                collect_reads(stmt.expr, "state", deps);
+                collect_reads(stmt.expr, "local", deps);
+                collect_writes(prev.body, written);
+                bool clobbers = false;
+                for (const auto& w : written) clobbers |= deps.count(w) > 0;
+                if (!clobbers && !body_has_external_call(prev.body)) {
+                    for (auto& inner : stmt.body) prev.body.push_back(std::move(inner));
+                    prev.terminated = stmt.terminated;
+                    fused++;
+                    continue;
+                }
+            }
+        }
+        result.push_back(std::move(stmt));
+    }
+    statements = std::move(result);
+    return fused;
+}
+
+int Optimizer::remove_overwritten_stores(std::vector<IRStatement>& statements) {
+    // 顶层无条件写入在被读取前又被无条件覆盖，则前一次写入无效
+    int removed = 0;
+    std::vector<bool> keep(statements.size(), true);
+    for (size_t i = 0; i < statements.size(); ++i) {
+        std::string name;
+        if (!simple_target(statements[i], "state", name) || !is_pure(statements[i].expr)) continue;
+        for (size_t j = i + 1; j < statements.size(); ++j) {
+            const auto& next = statements[j];
+            std::set<std::string> reads;
+            statement_reads(next, "state", reads);
+            if (reads.count(name) || statement_has_call(next) ||
+                next.kind == IRStatement::Kind::OTHER) break;
+            std::string next_name;
+            if (simple_target(next, "state", next_name) && next_name == name) {
+                keep[i] = false;
+                removed++;
+                break;
+            }
+        }
+    }
+    if (removed) {
+        std::vector<IRStatement> result;
+        for (size_t idx = 0; idx < statements.size(); ++idx) {
+            if (keep[idx]) result.push_back(std::move(statements[idx]));
+        }
+        statements = std::move(result);
+    }
+    return removed;
+}
+
+std::vector<MethodOptimizationReport> Optimizer::optimize_protocol(ProtocolAST& ast) {
+    // state {} 中声明的变量都是持久状态，即使没有方法读取也不能删除其写入或改为局部变量
+    std::vector<MethodOptimizationReport> reports;
+    for (auto& method : ast.methods) {
+        MethodOptimizationReport report;
+        report.method = method.name;
+        report.tokens_before = method.body_tokens.size();
+
+        MethodIR ir = MethodIRBuilder::build(method.body_tokens);
+        if (!ir.valid) {
+            report.skipped = true;
+            report.tokens_after = report.tokens_before;
+            reports.push_back(std::move(report));
+            continue;
+        }
+        report.folded_constants += fold_constants(ir.statements);
+        report.removed_self_assignments += remove_self_assignments(ir.statements);
+        report.removed_dead_stores += remove_overwritten_stores(ir.statements);
+        report.removed_noops += remove_noops(ir.statements);
+        report.fused_guards += fuse_guard_chains(ir.statements);
+        report.tokens_after = count_tokens(ir.statements);
+
+        if (report.changed()) {
+            method.body_tokens = MethodIRBuilder::flatten(ir.statements);
+            method.logic = MethodIRBuilder::to_logic(method.body_tokens);
+        }
+        reports.push_back(std::move(report));
+    }
+    return reports;
+}
+
+} // namespace cardity
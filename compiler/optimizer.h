@@ -0,0 +1,83 @@
+#ifndef CARDITY_OPTIMIZER_H
+#define CARDITY_OPTIMIZER_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include "tokenizer.h"
+#include "parser_ast.h"
+
+namespace cardity {
+
+// 方法体语句（IR）：由 Parser 保留的方法体 token 构建
+struct IRStatement {
+    enum class Kind {
+        ASSIGN,   // target = expr
+        IF,       // if ( expr ) { body }
+        EMIT,     // emit Name ( ... )
+        OTHER     // 其它语句（return / 外部调用 / 空语句），原样保留
+    };
+
+    Kind kind = Kind::OTHER;
+    std::vector<Token> target;          // ASSIGN: 左值 token
+    std::vector<Token> expr;            // ASSIGN: 右值；IF: 条件；EMIT/OTHER: 原始 token
+    std::vector<IRStatement> body;      // IF: 主体语句
+    bool terminated = false;            // 源码中是否以 ';' 结尾
+};
+
+struct MethodIR {
+    std::vector<IRStatement> statements;
+    bool valid = false;                 // 方法体是否能完整解析为 IR
+};
+
+// 方法体 IR 构建与还原
+class MethodIRBuilder {
+public:
+    // 从方法体 token 构建 IR；遇到不支持的结构（else、裸代码块等）时 valid = false
+    static MethodIR build(const std::vector<Token>& tokens);
+
+    // 将 IR 还原为 token 序列（未改动的语句与原始 token 完全一致）
+    static std::vector<Token> flatten(const std::vector<IRStatement>& statements);
+
+    // 与 Parser::parse_method_body 相同的拼接格式
+    static std::string to_logic(const std::vector<Token>& tokens);
+
+    // 与 Parser::parse_method 中 returns 表达式相同的拼接格式
+    static std::string to_return_expr(const std::vector<Token>& tokens);
+};
+
+// 单个方法的优化报告
+struct MethodOptimizationReport {
+    std::string method;
+    int folded_constants = 0;           // 折叠的常量表达式/条件
+    int removed_self_assignments = 0;   // 删除的自赋值（state.x = state.x）
+    int removed_dead_stores = 0;        // 删除的无效写入
+    int removed_noops = 0;              // 删除的空语句/空 if
+    int fused_guards = 0;               // 合并进前一条 if 的相同条件守卫
+    size_t tokens_before = 0;
+    size_t tokens_after = 0;
+    bool skipped = false;               // 方法体无法解析为 IR，未做优化
+
+    bool changed() const;
+    std::string summary() const;
+};
+
+// 方法 IR 优化器：常量折叠、自赋值/空操作消除、守卫链合并与无效写入消除。
+// 只做运行时语义不变的改写：常量折叠限于运行时按同样方式求值的表达式
+class Optimizer {
+public:
+    // 逐个方法优化，原地改写方法逻辑；状态定义保持不变
+    static std::vector<MethodOptimizationReport> optimize_protocol(ProtocolAST& ast);
+
+private:
+    static int fold_constants(std::vector<IRStatement>& statements);
+    static int fold_expression(std::vector<Token>& tokens);
+    static int remove_self_assignments(std::vector<IRStatement>& statements);
+    static int remove_noops(std::vector<IRStatement>& statements);
+    static int fuse_guard_chains(std::vector<IRStatement>& statements);
+    static int remove_overwritten_stores(std::vector<IRStatement>& statements);
+};
+
+} // namespace cardity
+
+#endif // CARDITY_OPTIMIZER_H
@@ -2,11 +2,13 @@
 #include "tokenizer.h"
 #include <stdexcept>
 #include <sstream>
-#include <iostream> // Added for std::cout
+#include <iostream>
 
 namespace cardity {
 
-Parser::Parser(Tokenizer& lex) : lexer(lex) {
+Parser::Parser(Tokenizer& lex) : Parser(lex, std::cout) {}
+
+Parser::Parser(Tokenizer& lex, std::ostream& log_stream) : lexer(lex), log(log_stream) {
     current = lexer.next_token();
 }
 
@@ -40,14 +42,14 @@ ProtocolAST Parser::parse_protocol() {
             ast.methods.push_back(parse_method());
         } else if (match("event")) {
             // 跳过整个 event 块
-            std::cout << "Warning: Skipping event block" << std::endl;
+            log << "Warning: Skipping event block" << std::endl;
             skip_event_block();
         } else if (current.value.empty() || current.value == " ") {
             // 跳过空字符串或空格
             advance();
         } else {
             // 跳过未知的 token，继续解析
-            std::cout << "Warning: Skipping unknown token: '" << current.value << "'" << std::endl;
+            log << "Warning: Skipping unknown token: '" << current.value << "'" << std::endl;
             advance();
         }
     }
@@ -139,10 +141,10 @@ std::vector<ParserStateVariable> Parser::parse_state_block() {
     std::vector<ParserStateVariable> vars;
     expect("{");
     
-    std::cout << "DEBUG: Starting state block parsing" << std::endl;
+    log << "DEBUG: Starting state block parsing" << std::endl;
     
     while (current.value != "}" && !is_at_end()) {
-        std::cout << "DEBUG: Current token: '" << current.value << "' at " << get_current_position() << std::endl;
+        log << "DEBUG: Current token: '" << current.value << "' at " << get_current_position() << std::endl;
         
         std::string name = expect_identifier();
         expect(":");
@@ -180,10 +182,10 @@ std::vector<ParserStateVariable> Parser::parse_state_block() {
         expect(";");
         vars.push_back({name, type, def});
         
-        std::cout << "DEBUG: Added state variable: " << name << ":" << type << std::endl;
+        log << "DEBUG: Added state variable: " << name << ":" << type << std::endl;
     }
     
-    std::cout << "DEBUG: State block parsing finished, current token: '" << current.value << "'" << std::endl;
+    log << "DEBUG: State block parsing finished, current token: '" << current.value << "'" << std::endl;
     
     if (current.value == "}") {
         advance(); // 消费结束的 }
@@ -218,12 +220,14 @@ ParserMethod Parser::parse_method() {
     expect(")");
     expect("{");
     
-    std::string logic = parse_method_body();
+    std::vector<Token> body_tokens;
+    std::string logic = parse_method_body(&body_tokens);
     // parse_method_body() 已经消费了结束的 }，所以这里不需要再消费
 
     // 可选 returns 解析：
     std::string return_expr = "";
     std::string return_type = "";
+    std::vector<Token> return_tokens;
     if (current.value == "returns") {
         advance();
         expect(":");
@@ -239,6 +243,7 @@ ParserMethod Parser::parse_method() {
         while (!is_at_end() && current.value != ";") {
             oss << current.value;
             if (current.type != TokenType::SEMICOLON) oss << " ";
+            return_tokens.push_back(current);
             advance();
         }
         expect(";");
@@ -250,8 +255,10 @@ ParserMethod Parser::parse_method() {
     m.params = params;
     m.param_types = param_types;
     m.logic = logic;
+    m.body_tokens = std::move(body_tokens);
     m.return_expr = return_expr;
     m.return_type = return_type;
+    m.return_tokens = std::move(return_tokens);
     return m;
 }
 
@@ -297,7 +304,7 @@ std::vector<std::string> Parser::parse_method_params(std::vector<std::string>& o
     return params;
 }
 
-std::string Parser::parse_method_body() {
+std::string Parser::parse_method_body(std::vector<Token>* out_tokens) {
     std::string logic;
     int brace_count = 1; // 已经有一个开始的 {
     
@@ -310,6 +317,7 @@ std::string Parser::parse_method_body() {
         
         if (brace_count > 0) {
             logic += current.value + " ";
+            if (out_tokens) out_tokens->push_back(current);
         }
         
         advance();
@@ -4,6 +4,7 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <iosfwd>
 #include "tokenizer.h"
 #include "parser_ast.h"
 
@@ -13,6 +14,8 @@ namespace cardity {
 class Parser {
 public:
     explicit Parser(Tokenizer& lexer);
+    // 警告与调试信息写入 log（默认 std::cout）；并行构建时每个任务传入自己的流
+    Parser(Tokenizer& lexer, std::ostream& log);
     
     // 主解析方法
     ProtocolAST parse_protocol();
@@ -23,6 +26,7 @@ public:
 
 private:
     Tokenizer& lexer;
+    std::ostream& log;
     Token current;
     
     // 辅助方法
@@ -37,7 +41,7 @@ private:
     std::vector<ParserMethod> parse_methods_block();
     ParserMethod parse_method();
     std::vector<std::string> parse_method_params(std::vector<std::string>& out_types);
-    std::string parse_method_body();
+    std::string parse_method_body(std::vector<Token>* out_tokens = nullptr);
     void parse_import_or_using(ProtocolAST& ast);
     
     // 跳过 event 块
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include "tokenizer.h"
 
 namespace cardity {
 
@@ -18,9 +19,11 @@ struct ParserMethod {
     std::vector<std::string> params;
     std::vector<std::string> param_types; // optional types for params
     std::string logic;
+    std::vector<Token> body_tokens;   // 方法体原始 token（供优化器构建 IR）
     // Optional return support
     std::string return_expr;   // e.g. "state.count" or literal/expr
     std::string return_type;   // optional type annotation (e.g. int/string/bool)
+    std::vector<Token> return_tokens; // returns 表达式原始 token
 };
 
 struct ProtocolAST {
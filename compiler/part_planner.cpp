@@ -0,0 +1,364 @@
+#include "part_planner.h"
+#include "canonical_json.h"
+#include "codec.h"
+#include "sha256.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cardity {
+
+namespace {
+
+class StringSink : public ByteSink {
+public:
+    std::string data;
+    void write(const char* bytes, size_t size) override { data.append(bytes, size); }
+};
+
+// 只读映射整个文件；分片线程直接从映射区读取各自区间
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            ::close(fd_);
+            throw std::runtime_error("Cannot stat file: " + path);
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd_);
+                throw std::runtime_error("Cannot map file: " + path);
+            }
+            data_ = static_cast<const uint8_t*>(p);
+            ::madvise(p, size_, MADV_SEQUENTIAL);
+        }
+    }
+    ~MappedFile() {
+        if (data_) ::munmap(const_cast<uint8_t*>(data_), size_);
+        if (fd_ >= 0) ::close(fd_);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    int fd_ = -1;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// 字段顺序与 cardity_split_parts.js 的 envelope 对象一致
+void write_envelope(JsonWriter& w, const std::string& bundle_id, const PartOptions& options,
+                    size_t idx, size_t total, const std::string& carc_b64) {
+    w.begin_object();
+    w.key("p");
+    w.value("cardity");
+    w.key("op");
+    w.value("deploy_part");
+    w.key("bundle_id");
+    w.value(bundle_id);
+    w.key("idx");
+    w.value(static_cast<uint64_t>(idx));
+    w.key("total");
+    w.value(static_cast<uint64_t>(total));
+    w.key("package_id");
+    w.value(options.package_id);
+    w.key("version");
+    w.value(options.version);
+    w.key("module");
+    w.value(options.module);
+    w.key("abi");
+    w.begin_object();
+    w.end_object();
+    w.key("carc_b64");
+    w.value(carc_b64);
+    w.end_object();
+}
+
+void write_file(const std::string& path, const std::string& content) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to write output file: " + path);
+    }
+    try {
+        FdSink(fd).write(content.data(), content.size());
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) {
+        throw std::runtime_error("Failed to write output file: " + path);
+    }
+}
+
+size_t base64_size(size_t n) {
+    return (n + 2) / 3 * 4;
+}
+
+} // namespace
+
+size_t PartPlanner::envelope_overhead(const std::string& bundle_id, const PartOptions& options,
+                                      size_t idx, size_t total) {
+    StringSink sink;
+    {
+        JsonWriter w(sink, 2);
+        write_envelope(w, bundle_id, options, idx, total, std::string());
+    }
+    return sink.data.size();
+}
+
+PartPlan PartPlanner::plan(size_t size, const std::string& sha256_hex,
+                           const std::string& source_name, const PartOptions& options) {
+    if (size == 0) {
+        throw std::runtime_error("Empty .carc file: " + source_name);
+    }
+
+    PartPlan plan;
+    plan.sha256 = sha256_hex;
+    plan.source_size = size;
+    plan.bundle_id = options.package_id + "-" + options.module + "-" + options.version + "-" +
+                     sha256_hex.substr(0, BUNDLE_HASH_CHARS);
+
+    // 信封开销随 idx/total 的位数增长；从 1 片开始迭代到不动点。
+    // total 只增不减、chunk 只减不增，因此必然收敛
+    size_t total = 1;
+    size_t chunk = 0;
+    for (;;) {
+        size_t overhead = envelope_overhead(plan.bundle_id, options, total, total);
+        if (overhead + 4 > options.max_bytes) {
+            throw std::runtime_error("--max-bytes " + std::to_string(options.max_bytes) +
+                                     " is too small for the part envelope (" +
+                                     std::to_string(overhead) + " bytes of metadata)");
+        }
+        chunk = (options.max_bytes - overhead) / 4 * 3;
+        size_t needed = (size + chunk - 1) / chunk;
+        if (needed <= total) break;
+        total = needed;
+    }
+    total = (size + chunk - 1) / chunk;
+    plan.chunk_size = chunk;
+
+    std::string base = std::filesystem::path(source_name).filename().string();
+    std::filesystem::path dir = options.out_dir.empty()
+        ? std::filesystem::path(source_name).parent_path()
+        : std::filesystem::path(options.out_dir);
+
+    plan.parts.reserve(total);
+    for (size_t i = 0; i < total; ++i) {
+        PartSlice slice;
+        slice.idx = i + 1;
+        slice.offset = i * chunk;
+        slice.size = std::min(chunk, size - slice.offset);
+        slice.envelope_size = envelope_overhead(plan.bundle_id, options, slice.idx, total) +
+                              base64_size(slice.size);
+        std::string name = base + "." + std::to_string(slice.idx) + "-of-" + std::to_string(total) + ".part.json";
+        slice.path = (dir / name).string();
+        plan.parts.push_back(slice);
+    }
+    return plan;
+}
+
+std::string PartPlanner::envelope_json(const PartPlan& plan, const PartOptions& options,
+                                       const PartSlice& slice, const uint8_t* data) {
+    StringSink sink;
+    {
+        JsonWriter w(sink, 2);
+        write_envelope(w, plan.bundle_id, options, slice.idx, plan.parts.size(),
+                       Codec::base64_encode(data + slice.offset, slice.size));
+    }
+    return std::move(sink.data);
+}
+
+PartPlan PartPlanner::split_file(const std::string& carc_file, const PartOptions& options) {
+    MappedFile file(carc_file);
+
+    // 源文件只哈希一次
+    Sha256 hasher;
+    hasher.update(file.data(), file.size());
+    PartPlan result = plan(file.size(), hasher.hex_digest(), carc_file, options);
+
+    if (!result.parts.empty()) {
+        std::filesystem::path dir = std::filesystem::path(result.parts.front().path).parent_path();
+        if (!dir.empty()) std::filesystem::create_directories(dir);
+    }
+
+    // 各分片互不依赖：并行编码并写出
+    unsigned workers = options.jobs ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<size_t>(workers, result.parts.size()));
+    std::atomic<size_t> next{0};
+    std::exception_ptr failure;
+    std::mutex failure_mutex;
+    auto worker = [&]() {
+        for (size_t i = next++; i < result.parts.size(); i = next++) {
+            try {
+                const PartSlice& slice = result.parts[i];
+                write_file(slice.path, envelope_json(result, options, slice, file.data()));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failure_mutex);
+                if (!failure) failure = std::current_exception();
+                next = result.parts.size();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < workers; ++t) threads.emplace_back(worker);
+    worker();
+    for (auto& th : threads) th.join();
+    if (failure) std::rethrow_exception(failure);
+
+    return result;
+}
+
+std::vector<std::string> PartPlanner::list_part_files(const std::string& dir) {
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        if (!entry.is_regular_file()) continue;
+        std::string name = entry.path().filename().string();
+        const std::string suffix = ".part.json";
+        if (name.size() > suffix.size() &&
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            files.push_back(entry.path().string());
+        }
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+PartVerifyResult PartPlanner::verify(const std::vector<std::string>& part_files, const std::string& output) {
+    PartVerifyResult result;
+    if (part_files.empty()) {
+        result.errors.push_back("No part files given");
+        return result;
+    }
+
+    // idx -> (文件, carc_b64)
+    std::map<size_t, std::pair<std::string, std::string>> parts;
+    std::string package_id, version, module;
+    for (const auto& path : part_files) {
+        std::ifstream ifs(path);
+        if (!ifs.is_open()) {
+            result.errors.push_back("Cannot open part file: " + path);
+            continue;
+        }
+        json envelope;
+        size_t idx = 0, total = 0;
+        std::string bundle_id;
+        try {
+            envelope = json::parse(ifs);
+            if (envelope.value("p", "") != "cardity" || envelope.value("op", "") != "deploy_part") {
+                result.errors.push_back(path + ": not a deploy_part envelope");
+                continue;
+            }
+            idx = envelope.value("idx", size_t(0));
+            total = envelope.value("total", size_t(0));
+            bundle_id = envelope.value("bundle_id", "");
+        } catch (const std::exception& e) {
+            result.errors.push_back(path + ": invalid envelope: " + e.what());
+            continue;
+        }
+        if (result.bundle_id.empty()) {
+            result.bundle_id = bundle_id;
+            result.total = total;
+            package_id = envelope.value("package_id", "");
+            version = envelope.value("version", "");
+            module = envelope.value("module", "");
+        } else if (bundle_id != result.bundle_id || total != result.total ||
+                   envelope.value("package_id", "") != package_id ||
+                   envelope.value("version", "") != version ||
+                   envelope.value("module", "") != module) {
+            result.errors.push_back(path + ": envelope does not belong to bundle " + result.bundle_id);
+            continue;
+        }
+        if (idx == 0 || idx > total) {
+            result.errors.push_back(path + ": idx " + std::to_string(idx) + " out of range 1.." + std::to_string(total));
+            continue;
+        }
+        if (!parts.emplace(idx, std::make_pair(path, envelope.value("carc_b64", ""))).second) {
+            result.errors.push_back(path + ": duplicate part " + std::to_string(idx) + " (also " + parts[idx].first + ")");
+        }
+    }
+    for (size_t idx = 1; idx <= result.total; ++idx) {
+        if (!parts.count(idx)) {
+            result.errors.push_back("Missing part " + std::to_string(idx) + " of " + std::to_string(result.total));
+        }
+    }
+    if (!result.errors.empty()) return result;
+
+    // bundle_id 必须以 plan() 生成的 16 位小写 hex 结尾，否则前缀比较形同虚设
+    size_t dash = result.bundle_id.find_last_of('-');
+    std::string expected = dash == std::string::npos ? std::string() : result.bundle_id.substr(dash + 1);
+    if (expected.size() != BUNDLE_HASH_CHARS ||
+        expected.find_first_not_of("0123456789abcdef") != std::string::npos) {
+        result.errors.push_back("Invalid bundle_id (expected a " + std::to_string(BUNDLE_HASH_CHARS) +
+                                "-character hex hash suffix): " + result.bundle_id);
+        return result;
+    }
+
+    // 按 idx 顺序解码，边解码边哈希；输出先写到临时文件，校验通过后再改名
+    std::string temp = output.empty() ? std::string() : output + ".tmp";
+    std::ofstream ofs;
+    if (!temp.empty()) {
+        ofs.open(temp, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            result.errors.push_back("Failed to write output file: " + output);
+            return result;
+        }
+    }
+    auto fail = [&](const std::string& error) {
+        result.errors.push_back(error);
+        if (ofs.is_open()) ofs.close();
+        if (!temp.empty()) std::remove(temp.c_str());
+        return result;
+    };
+    Sha256 hasher;
+    std::vector<uint8_t> bytes;
+    for (const auto& entry : parts) {
+        if (!Codec::base64_decode(entry.second.second, bytes)) {
+            return fail(entry.second.first + ": invalid base64 payload");
+        }
+        hasher.update(bytes);
+        result.size += bytes.size();
+        if (ofs.is_open()) ofs.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+    result.sha256 = hasher.hex_digest();
+
+    if (result.sha256.compare(0, BUNDLE_HASH_CHARS, expected) != 0) {
+        return fail("Hash mismatch: bundle_id expects " + expected + ", reassembled data is " +
+                    result.sha256.substr(0, BUNDLE_HASH_CHARS));
+    }
+    if (ofs.is_open()) {
+        ofs.close();
+        if (ofs.fail()) {
+            return fail("Failed to write output file: " + output);
+        }
+        if (std::rename(temp.c_str(), output.c_str()) != 0) {
+            return fail("Failed to write output file: " + output + ": " + std::strerror(errno));
+        }
+    }
+    result.ok = true;
+    return result;
+}
+
+} // namespace cardity
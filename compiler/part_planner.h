@@ -0,0 +1,80 @@
+#ifndef CARDITY_PART_PLANNER_H
+#define CARDITY_PART_PLANNER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace cardity {
+
+// 分片参数（与 deploy_part 信封字段对应）
+struct PartOptions {
+    std::string package_id;
+    std::string module;
+    std::string version = "1.0.0";
+    size_t max_bytes = 50000;  // 单个信封（base64 后的 JSON）的字节上限，Dogecoin 50 KB
+    std::string out_dir;       // 为空时写到源文件所在目录
+    unsigned jobs = 0;         // 0 表示使用硬件并发数
+};
+
+// 单个分片：源文件中的字节区间及其信封大小
+struct PartSlice {
+    size_t idx = 0;            // 从 1 开始
+    size_t offset = 0;
+    size_t size = 0;
+    size_t envelope_size = 0;
+    std::string path;
+};
+
+struct PartPlan {
+    std::string bundle_id;     // <package>-<module>-<version>-<sha256 前 16 位>
+    std::string sha256;        // 源文件完整哈希
+    size_t source_size = 0;
+    size_t chunk_size = 0;     // 除最后一片外每片的原始字节数（3 的倍数，base64 无填充）
+    std::vector<PartSlice> parts;
+};
+
+// 重组校验结果
+struct PartVerifyResult {
+    bool ok = false;
+    std::string bundle_id;
+    std::string sha256;
+    size_t total = 0;
+    size_t size = 0;
+    std::vector<std::string> errors;
+};
+
+// .carc 分片规划器：替代 bin/cardity_split_parts.js
+class PartPlanner {
+public:
+    static constexpr size_t BUNDLE_HASH_CHARS = 16;    // bundle_id 末尾携带的 SHA-256 hex 位数
+
+    // 规划分片：保证每个信封（而非原始字节）不超过 max_bytes
+    static PartPlan plan(size_t size, const std::string& sha256_hex,
+                         const std::string& source_name, const PartOptions& options);
+
+    // 读取 .carc（只哈希一次），规划并并行编码写出所有分片
+    static PartPlan split_file(const std::string& carc_file, const PartOptions& options);
+
+    // 生成单个信封的 JSON 文本（与 JSON.stringify(envelope, null, 2) 一致）
+    static std::string envelope_json(const PartPlan& plan, const PartOptions& options,
+                                     const PartSlice& slice, const uint8_t* data);
+
+    // 读取分片文件，按 idx 重组并校验 bundle_id 中的哈希；output 非空时写出重组结果
+    // （先写临时文件，哈希一致后才改名到 output，失败时不留下文件）
+    static PartVerifyResult verify(const std::vector<std::string>& part_files,
+                                   const std::string& output = "");
+
+    // 目录下所有 *.part.json（按文件名排序）
+    static std::vector<std::string> list_part_files(const std::string& dir);
+
+private:
+    // 信封除 carc_b64 内容外的字节数
+    static size_t envelope_overhead(const std::string& bundle_id, const PartOptions& options,
+                                    size_t idx, size_t total);
+};
+
+} // namespace cardity
+
+#endif // CARDITY_PART_PLANNER_H
@@ -1,12 +1,53 @@
 #include "runtime.h"
+#include "invoke_codec.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
 #include <cctype>
 #include <stdexcept>
+#include <cstdio>
 
 namespace cardity {
 
+DispatchTable::DispatchTable(const json& car) {
+    if (!car.contains("cpl") || !car["cpl"].contains("methods")) {
+        return;
+    }
+    const json& methods = car["cpl"]["methods"];
+    entries.reserve(methods.size());
+    by_name.reserve(methods.size());
+    by_selector.reserve(methods.size());
+    for (auto it = methods.begin(); it != methods.end(); ++it) {
+        MethodEntry entry;
+        entry.name = it.key();
+        entry.selector = InvokeCodec::method_selector(it.key(), it.value());
+        if (it.value().contains("params")) {
+            entry.params = it.value()["params"].get<std::vector<std::string>>();
+        }
+        entry.method = it.value();
+
+        uint32_t index = static_cast<uint32_t>(entries.size());
+        auto [pos, inserted] = by_selector.emplace(entry.selector, index);
+        if (!inserted) {
+            // 4 字节选择器理论上可能碰撞，此时按选择器分派会有歧义，直接拒绝
+            throw std::runtime_error("Selector collision between methods " + entries[pos->second].name +
+                                     " and " + entry.name);
+        }
+        by_name.emplace(entry.name, index);
+        entries.push_back(std::move(entry));
+    }
+}
+
+const MethodEntry* DispatchTable::find(const std::string& name) const {
+    auto it = by_name.find(name);
+    return it == by_name.end() ? nullptr : &entries[it->second];
+}
+
+const MethodEntry* DispatchTable::find(uint32_t selector) const {
+    auto it = by_selector.find(selector);
+    return it == by_selector.end() ? nullptr : &entries[it->second];
+}
+
 Runtime::Runtime() {
     // 构造函数，初始化事件管理器
 }
@@ -42,18 +83,50 @@ State Runtime::initialize_state(const json& car) {
 std::string Runtime::invoke_method(const json& car, State& state, 
                                  const std::string& method_name, 
                                  const std::vector<std::string>& args) {
-    auto methods = car["cpl"]["methods"];
-    if (!methods.contains(method_name)) {
+    if (!method_exists(car, method_name)) {
         throw std::runtime_error("Method not found: " + method_name);
     }
     
-    auto method = methods[method_name];
+    const json& method = car["cpl"]["methods"][method_name];
     std::vector<std::string> param_names;
     
     if (method.contains("params")) {
         param_names = method["params"].get<std::vector<std::string>>();
     }
 
+    return execute(method, state, args, param_names);
+}
+
+std::string Runtime::invoke_method(const DispatchTable& table, State& state,
+                                 const std::string& method_name,
+                                 const std::vector<std::string>& args) {
+    const MethodEntry* entry = table.find(method_name);
+    if (!entry) {
+        throw std::runtime_error("Method not found: " + method_name);
+    }
+    return execute(entry->method, state, args, entry->params);
+}
+
+std::string Runtime::invoke_method(const DispatchTable& table, State& state,
+                                 uint32_t selector,
+                                 const std::vector<std::string>& args) {
+    const MethodEntry* entry = table.find(selector);
+    if (!entry) {
+        char buf[16];
+        std::snprintf(buf, sizeof(buf), "%08x", selector);
+        throw std::runtime_error(std::string("No method matches selector 0x") + buf);
+    }
+    return execute(entry->method, state, args, entry->params);
+}
+
+std::string Runtime::invoke_method(const MethodEntry& entry, State& state,
+                                 const std::vector<std::string>& args) {
+    return execute(entry.method, state, args, entry.params);
+}
+
+std::string Runtime::execute(const json& method, State& state,
+                             const std::vector<std::string>& args,
+                             const std::vector<std::string>& param_names) {
     // 处理逻辑字段：state.xxx = yyy 或 if 条件语句
     if (method.contains("logic")) {
         if (method["logic"].is_string()) {
@@ -93,7 +166,7 @@ std::string Runtime::invoke_method(const json& car, State& state,
             }
         } else if (method["logic"].is_array()) {
             // 多个逻辑语句
-            auto logic_array = method["logic"];
+            const json& logic_array = method["logic"];
             for (const auto& logic_item : logic_array) {
                 std::string logic = logic_item;
                 
@@ -120,7 +193,7 @@ std::string Runtime::invoke_method(const json& car, State& state,
             return parse_return(returns, state);
         } else if (method["returns"].is_object()) {
             // 新格式：类型化对象
-            auto returns_obj = method["returns"];
+            const json& returns_obj = method["returns"];
             if (returns_obj.contains("expr")) {
                 std::string expr = returns_obj["expr"];
                 // 尝试用表达式求值：优先条件，其次变量解析
@@ -338,7 +411,7 @@ std::vector<std::string> Runtime::get_method_params(const json& car, const std::
         throw std::runtime_error("Method not found: " + method_name);
     }
     
-    auto method = car["cpl"]["methods"][method_name];
+    const json& method = car["cpl"]["methods"][method_name];
     if (method.contains("params")) {
         return method["params"].get<std::vector<std::string>>();
     }
@@ -346,6 +419,18 @@ std::vector<std::string> Runtime::get_method_params(const json& car, const std::
     return {};
 }
 
+bool Runtime::method_exists(const DispatchTable& table, const std::string& method_name) {
+    return table.find(method_name) != nullptr;
+}
+
+const std::vector<std::string>& Runtime::get_method_params(const DispatchTable& table, const std::string& method_name) {
+    const MethodEntry* entry = table.find(method_name);
+    if (!entry) {
+        throw std::runtime_error("Method not found: " + method_name);
+    }
+    return entry->params;
+}
+
 std::string Runtime::trim(const std::string& str) {
     std::string result = str;
     result.erase(std::remove_if(result.begin(), result.end(), ::isspace), result.end());
@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 #include "expression.h"
 #include "type_system.h"
@@ -17,6 +18,34 @@ using json = nlohmann::json;
 using State = std::unordered_map<std::string, std::string>;
 using TypedState = std::unordered_map<std::string, Value>;
 
+// 分派表中的单个方法（加载时从 .car 中取出，调用时不再查询 JSON）
+struct MethodEntry {
+    std::string name;
+    uint32_t selector = 0;              // 与 ABI 中的 selector 一致
+    std::vector<std::string> params;
+    json method;                        // 方法定义（logic/returns 等）
+};
+
+// 方法分派表：协议加载后构建一次，按名称或选择器 O(1) 解析方法
+class DispatchTable {
+public:
+    DispatchTable() = default;
+    explicit DispatchTable(const json& car);
+
+    // 未找到返回 nullptr
+    const MethodEntry* find(const std::string& name) const;
+    const MethodEntry* find(uint32_t selector) const;
+
+    // 稠密数组，下标即方法编号（顺序与 .car 中 methods 一致）
+    const std::vector<MethodEntry>& methods() const { return entries; }
+    size_t size() const { return entries.size(); }
+
+private:
+    std::vector<MethodEntry> entries;
+    std::unordered_map<std::string, uint32_t> by_name;
+    std::unordered_map<uint32_t, uint32_t> by_selector;
+};
+
 class Runtime {
 public:
     Runtime();
@@ -32,6 +61,16 @@ public:
                             const std::string& method_name, 
                             const std::vector<std::string>& args);
 
+    // 通过分派表执行方法调用（按名称或选择器）
+    std::string invoke_method(const DispatchTable& table, State& state,
+                            const std::string& method_name,
+                            const std::vector<std::string>& args);
+    std::string invoke_method(const DispatchTable& table, State& state,
+                            uint32_t selector,
+                            const std::vector<std::string>& args);
+    std::string invoke_method(const MethodEntry& entry, State& state,
+                            const std::vector<std::string>& args);
+
     // 设置调用上下文（可选）：sender/txid/data_length 等
     void set_context(const std::string& key, const std::string& value) { context[key] = value; }
     const std::unordered_map<std::string, std::string>& get_context() const { return context; }
@@ -41,9 +80,11 @@ public:
     
     // 验证方法是否存在
     static bool method_exists(const json& car, const std::string& method_name);
+    static bool method_exists(const DispatchTable& table, const std::string& method_name);
     
     // 获取方法参数列表
     static std::vector<std::string> get_method_params(const json& car, const std::string& method_name);
+    static const std::vector<std::string>& get_method_params(const DispatchTable& table, const std::string& method_name);
     
     // 获取事件管理器
     EventManager& get_event_manager() { return event_manager; }
@@ -55,6 +96,11 @@ private:
     EventManager event_manager;
     std::unordered_map<std::string, std::string> context;
     
+    // 执行已解析的方法定义
+    std::string execute(const json& method, State& state,
+                        const std::vector<std::string>& args,
+                        const std::vector<std::string>& param_names);
+    
     // 解析简单的赋值语句：state.xxx = yyy
     static void parse_assignment(const std::string& logic, State& state, 
                                const std::vector<std::string>& args,
@@ -1,29 +1,35 @@
 #include "runtime.h"
+#include "invoke_codec.h"
+#include "codec.h"
 #include <iostream>
 #include <string>
 #include <vector>
 #include <sstream>
 #include <fstream>
+#include <cstdio>
 
 using namespace cardity;
 
 void print_usage(const std::string& program_name) {
     std::cout << "Usage: " << program_name << " <car_file> [method_name] [args...] [--sender <addr>] [--txid <id>] [--data-length <n>] [--state <file>]\n";
+    std::cout << "       " << program_name << " <car_file> --decode-invoke <hex> [--sender <addr>] [--txid <id>] [--data-length <n>] [--state <file>]\n";
+    std::cout << "       " << program_name << " <car_file> --encode-invoke <method_name> [args_json_array]\n";
     std::cout << "\nExamples:\n";
     std::cout << "  " << program_name << " hello.car                    # Load and show initial state\n";
     std::cout << "  " << program_name << " hello.car set_msg \"Hello\"   # Call set_msg method\n";
     std::cout << "  " << program_name << " hello.car get_msg            # Call get_msg method\n";
+    std::cout << "  " << program_name << " hello.car --encode-invoke set_msg '[\"Hello\"]'  # Binary invoke payload (hex)\n";
+    std::cout << "  " << program_name << " hello.car --decode-invoke c1...  # Decode payload and dispatch by selector\n";
 }
 
-void interactive_mode(const json& car, State& state) {
+void interactive_mode(const json& car, const DispatchTable& table, State& state) {
     std::cout << "\n🎮 Interactive Mode (type 'quit' to exit, 'state' to show state)\n";
     std::cout << "Available methods:\n";
     
-    auto methods = car["cpl"]["methods"];
-    for (auto& [method_name, method] : methods.items()) {
-        std::cout << "  - " << method_name;
-        if (method.contains("params")) {
-            auto params = method["params"];
+    for (const auto& entry : table.methods()) {
+        std::cout << "  - " << entry.name;
+        if (entry.method.contains("params")) {
+            auto params = entry.method["params"];
             std::cout << "(";
             for (size_t i = 0; i < params.size(); ++i) {
                 if (i > 0) std::cout << ", ";
@@ -72,7 +78,7 @@ void interactive_mode(const json& car, State& state) {
                 runtime.get_event_manager().parse_events_from_json(car["cpl"]["events"]);
             }
             
-            std::string result = runtime.invoke_method(car, state, method_name, args);
+            std::string result = runtime.invoke_method(table, state, method_name, args);
             if (result != "ok") {
                 std::cout << "📥 Result: " << result << "\n";
             } else {
@@ -92,11 +98,31 @@ int main(int argc, char* argv[]) {
 
     std::string car_file = argv[1];
     
+    // 编码二进制调用：只输出 hex，便于脚本使用
+    if (argc > 2 && std::string(argv[2]) == "--encode-invoke") {
+        if (argc < 4) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        try {
+            auto car = Runtime::load_car_file(car_file);
+            json args = argc > 4 ? json::parse(argv[4]) : json::array();
+            std::cout << Codec::hex_encode(InvokeCodec::encode(car, argv[3], args)) << std::endl;
+            return 0;
+        } catch (const std::exception& e) {
+            std::cerr << "❌ Error: " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    
     try {
         // 加载 .car 协议文件
         std::cout << "📖 Loading protocol: " << car_file << std::endl;
         auto car = Runtime::load_car_file(car_file);
         
+        // 构建方法分派表（之后按名称或选择器解析方法都不再查询 JSON）
+        DispatchTable table(car);
+        
         // 初始化状态
         std::cout << "🔧 Initializing state..." << std::endl;
         auto state = Runtime::initialize_state(car);
@@ -114,9 +140,28 @@ int main(int argc, char* argv[]) {
         if (argc > 2) {
             std::string method_name = argv[2];
             std::vector<std::string> args;
+            const MethodEntry* entry = nullptr;
+            int first_arg = 3;
+            
+            // 二进制调用：按选择器分派，参数直接取自载荷（不经 JSON）
+            if (method_name == "--decode-invoke") {
+                if (argc < 4) {
+                    throw std::runtime_error("--decode-invoke requires a hex payload");
+                }
+                DecodedInvoke decoded = InvokeCodec::decode_hex(argv[3]);
+                entry = table.find(decoded.selector);
+                if (!entry) {
+                    char buf[16];
+                    std::snprintf(buf, sizeof(buf), "%08x", decoded.selector);
+                    throw std::runtime_error(std::string("No method matches selector 0x") + buf);
+                }
+                method_name = entry->name;
+                args = std::move(decoded.args);
+                first_arg = 4;
+            }
             
             // 收集参数与可选上下文
-            for (int i = 3; i < argc; ++i) {
+            for (int i = first_arg; i < argc; ++i) {
                 std::string a = argv[i];
                 if (a == "--sender" && i + 1 < argc) { sender = argv[++i]; continue; }
                 if (a == "--txid" && i + 1 < argc) { txid = argv[++i]; continue; }
@@ -165,7 +210,8 @@ int main(int argc, char* argv[]) {
                 } catch (...) {}
             }
 
-            std::string result = runtime.invoke_method(car, state, method_name, args);
+            std::string result = entry ? runtime.invoke_method(*entry, state, args)
+                                       : runtime.invoke_method(table, state, method_name, args);
             if (result != "ok") {
                 std::cout << "📥 Result: " << result << std::endl;
             } else {
@@ -218,7 +264,7 @@ int main(int argc, char* argv[]) {
             }
         } else {
             // 进入交互模式
-            interactive_mode(car, state);
+            interactive_mode(car, table, state);
         }
         
         return 0;
@@ -0,0 +1,53 @@
+#include "sha256.h"
+#include "codec.h"
+#include <openssl/evp.h>
+#include <stdexcept>
+
+namespace cardity {
+
+Sha256::Sha256() : ctx_(EVP_MD_CTX_new()) {
+    if (!ctx_) {
+        throw std::runtime_error("Failed to allocate SHA-256 context");
+    }
+    reset();
+}
+
+Sha256::~Sha256() {
+    EVP_MD_CTX_free(ctx_);
+}
+
+void Sha256::reset() {
+    if (EVP_DigestInit_ex(ctx_, EVP_sha256(), nullptr) != 1) {
+        throw std::runtime_error("Failed to initialize SHA-256");
+    }
+}
+
+void Sha256::update(const void* data, size_t size) {
+    if (size == 0) return;
+    if (EVP_DigestUpdate(ctx_, data, size) != 1) {
+        throw std::runtime_error("SHA-256 update failed");
+    }
+}
+
+std::vector<uint8_t> Sha256::digest() {
+    std::vector<uint8_t> out(EVP_MAX_MD_SIZE);
+    unsigned int len = 0;
+    if (EVP_DigestFinal_ex(ctx_, out.data(), &len) != 1) {
+        throw std::runtime_error("SHA-256 finalization failed");
+    }
+    out.resize(len);
+    reset();
+    return out;
+}
+
+std::string Sha256::hex_digest() {
+    return Codec::hex_encode(digest());
+}
+
+std::string Sha256::hex(const void* data, size_t size) {
+    Sha256 hasher;
+    hasher.update(data, size);
+    return hasher.hex_digest();
+}
+
+} // namespace cardity
@@ -0,0 +1,43 @@
+#ifndef CARDITY_SHA256_H
+#define CARDITY_SHA256_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "canonical_json.h"
+
+typedef struct evp_md_ctx_st EVP_MD_CTX;
+
+namespace cardity {
+
+// 流式 SHA-256（OpenSSL EVP）；可作为 ByteSink 直接接收规范化 JSON
+class Sha256 : public ByteSink {
+public:
+    Sha256();
+    ~Sha256() override;
+    Sha256(const Sha256&) = delete;
+    Sha256& operator=(const Sha256&) = delete;
+
+    // 追加数据，可多次调用（大包按模块/分片增量计算）
+    void update(const void* data, size_t size);
+    void update(const std::string& data) { update(data.data(), data.size()); }
+    void update(const std::vector<uint8_t>& data) { update(data.data(), data.size()); }
+    void write(const char* data, size_t size) override { update(data, size); }
+
+    // 结束计算；之后对象会重置，可继续复用
+    std::vector<uint8_t> digest();
+    std::string hex_digest();
+
+    // 便捷接口
+    static std::string hex(const void* data, size_t size);
+    static std::string hex(const std::vector<uint8_t>& data) { return hex(data.data(), data.size()); }
+
+private:
+    void reset();
+    EVP_MD_CTX* ctx_;
+};
+
+} // namespace cardity
+
+#endif // CARDITY_SHA256_H
@@ -6,7 +6,10 @@
 namespace cardity {
 
 Tokenizer::Tokenizer(const std::string& input)
-    : source(input), pos(0), line(1), column(1) {}
+    : source(input), pos(0), line(1), column(1), tolerant(false) {}
+
+Tokenizer::Tokenizer(const std::string& input, bool tolerant_mode)
+    : source(input), pos(0), line(1), column(1), tolerant(tolerant_mode) {}
 
 Token Tokenizer::next_token() {
     skip_whitespace();
@@ -38,6 +41,11 @@ Token Tokenizer::next_token() {
     }
 
     // 未知字符
+    if (tolerant) {
+        int start_column = column;
+        advance_position();
+        return Token(TokenType::UNKNOWN, std::string(1, ch), line, start_column);
+    }
     std::string error_msg = "Unknown character: " + std::string(1, ch);
     error_msg += " at line " + std::to_string(line) + ", column " + std::to_string(column);
     throw std::runtime_error(error_msg);
@@ -107,6 +115,9 @@ Token Tokenizer::parse_string() {
     }
     
     if (pos >= source.size()) {
+        if (tolerant) {
+            return Token(TokenType::END_OF_FILE, "", line, column);
+        }
         std::string error_msg = "Unterminated string literal at " + get_current_position();
         throw std::runtime_error(error_msg);
     }
@@ -255,4 +266,52 @@ void Tokenizer::advance_position_by(int count) {
     }
 }
 
+std::vector<Token> tokenize_all(const std::string& input, bool tolerant) {
+    Tokenizer tokenizer(input, tolerant);
+    std::vector<Token> tokens;
+    tokens.reserve(input.size() / 4 + 1);
+    while (true) {
+        Token tok = tokenizer.next_token();
+        if (tok.type == TokenType::END_OF_FILE) break;
+        tokens.push_back(std::move(tok));
+    }
+    return tokens;
+}
+
+bool is_word_token(const Token& tok) {
+    if (tok.type == TokenType::STRING || tok.type == TokenType::NUMBER || tok.value.empty()) {
+        return false;
+    }
+    unsigned char c = static_cast<unsigned char>(tok.value[0]);
+    return std::isalpha(c) || c == '_';
+}
+
+void scan_external_calls(const std::string& logic, std::vector<std::tuple<std::string, std::string, int>>& outCalls) {
+    // find alias . method ( ... ) on the token stream
+    std::vector<Token> toks = tokenize_all(logic, true);
+    size_t i = 0;
+    while (i + 3 < toks.size()) {
+        if (!(is_word_token(toks[i]) && toks[i+1].type == TokenType::DOT &&
+              is_word_token(toks[i+2]) && toks[i+3].type == TokenType::LPAREN)) {
+            ++i;
+            continue;
+        }
+        std::string alias = toks[i].value;
+        std::string method = toks[i+2].value;
+        // count args from '(' to matching ')'
+        int depth = 0; int argCount = 0; bool anyToken = false;
+        size_t j = i + 3;
+        for (; j < toks.size(); ++j) {
+            TokenType t = toks[j].type;
+            if (t == TokenType::LPAREN) { if (depth >= 1) anyToken = true; depth++; }
+            else if (t == TokenType::RPAREN) { if (depth == 1 && anyToken) argCount++; depth--; if (depth <= 0) break; }
+            else if (t == TokenType::COMMA && depth == 1) { argCount++; anyToken = false; }
+            else if (depth >= 1) { anyToken = true; }
+        }
+        outCalls.emplace_back(alias, method, argCount);
+        // resume right after '(' so nested calls in arguments are scanned too
+        i += 4;
+    }
+}
+
 } // namespace cardity 
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <vector>
+#include <tuple>
 
 namespace cardity {
 
@@ -74,6 +75,9 @@ struct Token {
 class Tokenizer {
 public:
     explicit Tokenizer(const std::string& input);
+    // tolerant 模式：未知字符返回 UNKNOWN token、未闭合字符串视为结束，而不是抛异常。
+    // 供 ABI/DRC-20 提取、import 扫描等对任意文本做 token 级匹配的场景使用。
+    Tokenizer(const std::string& input, bool tolerant);
 
     // 主要方法
     Token next_token();
@@ -88,6 +92,7 @@ private:
     size_t pos;
     int line;
     int column;
+    bool tolerant;
     
     // 私有辅助方法
     void skip_whitespace();
@@ -104,4 +109,13 @@ private:
     void advance_position_by(int count);
 };
 
+// 将整段输入切分为 token 序列（不含 END_OF_FILE）
+std::vector<Token> tokenize_all(const std::string& input, bool tolerant = false);
+
+// 是否为“单词” token：标识符或关键字（等价于 \w+ 且不以数字开头）
+bool is_word_token(const Token& tok);
+
+// 扫描 `alias . method (...)` 形式的调用，输出 (alias, method, 参数个数)；参数中的嵌套调用也会列出
+void scan_external_calls(const std::string& logic, std::vector<std::tuple<std::string, std::string, int>>& outCalls);
+
 } // namespace cardity 
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "content_store.h"
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <set>
+#include <thread>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+#include <archive.h>
+#include <archive_entry.h>
+#include "sha256.h"
+#include "byte_channel.h"
+
+namespace cardity {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 归档内路径规范化；绝对路径或含 ".." 时返回 false
+bool normalize_entry_path(std::string path, std::string& out) {
+    while (path.rfind("./", 0) == 0) path.erase(0, 2);
+    if (path.empty() || path[0] == '/') return false;
+    fs::path p(path);
+    for (const auto& part : p) {
+        if (part == "..") return false;
+    }
+    out = p.lexically_normal().generic_string();
+    return !out.empty() && out != ".";
+}
+
+// 临时文件写完后原子改名；目标已存在（其他进程/线程已入库同一内容）时丢弃临时文件
+void publish(const std::string& temp, const std::string& target) {
+    std::error_code ec;
+    if (fs::exists(target, ec)) {
+        fs::remove(temp, ec);
+        return;
+    }
+    fs::create_directories(fs::path(target).parent_path());
+    fs::rename(temp, target);
+}
+
+void write_file_atomic(const std::string& temp, const std::string& target, const std::string& content) {
+    {
+        std::ofstream ofs(temp, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            throw std::runtime_error("Failed to write store file: " + temp);
+        }
+        ofs << content;
+        ofs.close();
+        if (!ofs) {
+            std::error_code ec;
+            fs::remove(temp, ec);
+            throw std::runtime_error("Failed to write store file: " + temp);
+        }
+    }
+    fs::create_directories(fs::path(target).parent_path());
+    fs::rename(temp, target);
+}
+
+} // namespace
+
+ContentStore::ContentStore(const std::string& root) : root_(root) {
+    fs::create_directories(root_ + "/files");
+    fs::create_directories(root_ + "/index");
+    fs::create_directories(root_ + "/packages");
+    fs::create_directories(root_ + "/archives");
+    fs::create_directories(root_ + "/tmp");
+}
+
+std::string ContentStore::default_root(const std::string& fallback) {
+    if (const char* env = std::getenv("CARDITY_STORE")) {
+        if (*env) return env;
+    }
+    if (const char* home = std::getenv("HOME")) {
+        if (*home) return std::string(home) + "/.cardity/store";
+    }
+    return fallback;
+}
+
+std::string ContentStore::content_path(const std::string& sha256) const {
+    return root_ + "/files/" + sha256.substr(0, 2) + "/" + sha256.substr(2);
+}
+
+std::string ContentStore::manifest_path(const std::string& archive_sha256) const {
+    return root_ + "/index/" + archive_sha256 + ".json";
+}
+
+std::string ContentStore::archive_path(const std::string& archive_sha256) const {
+    return root_ + "/archives/" + archive_sha256 + ".tar.gz";
+}
+
+std::string ContentStore::package_path(const std::string& name, const std::string& version) const {
+    // @scope/name -> @scope+name
+    std::string key = name;
+    std::replace(key.begin(), key.end(), '/', '+');
+    return root_ + "/packages/" + key + "@" + version;
+}
+
+std::string ContentStore::temp_path() const {
+    static std::atomic<uint64_t> counter{0};
+    return root_ + "/tmp/" + std::to_string(::getpid()) + "-" +
+           std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + "-" +
+           std::to_string(counter++);
+}
+
+std::string ContentStore::file_sha256(const std::string& path) {
+    // 流式计算，文件不存在时返回空串
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs.is_open()) {
+        return "";
+    }
+    Sha256 hasher;
+    std::vector<char> buffer(1 << 16);
+    while (ifs) {
+        ifs.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        hasher.update(buffer.data(), static_cast<size_t>(ifs.gcount()));
+    }
+    return hasher.hex_digest();
+}
+
+const char* ContentStore::link_method_name(LinkMethod method) {
+    switch (method) {
+        case LinkMethod::HardLink: return "hard link";
+        case LinkMethod::Reflink: return "reflink";
+        case LinkMethod::Copy: return "copy";
+    }
+    return "copy";
+}
+
+json ContentStore::manifest_to_json(const StoreManifest& manifest) {
+    json files = json::array();
+    for (const auto& entry : manifest.files) {
+        files.push_back({{"path", entry.path},
+                         {"sha256", entry.sha256},
+                         {"size", entry.size},
+                         {"executable", entry.executable}});
+    }
+    return {{"sha256", manifest.sha256}, {"files", files}};
+}
+
+bool ContentStore::manifest_from_json(const json& data, StoreManifest& manifest) {
+    try {
+        manifest = StoreManifest();
+        manifest.sha256 = data.at("sha256").get<std::string>();
+        for (const auto& item : data.at("files")) {
+            StoreEntry entry;
+            entry.path = item.at("path").get<std::string>();
+            entry.sha256 = item.at("sha256").get<std::string>();
+            entry.size = item.value("size", uint64_t(0));
+            entry.executable = item.value("executable", false);
+            manifest.files.push_back(std::move(entry));
+        }
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+bool ContentStore::lookup(const std::string& archive_sha256, StoreManifest& manifest) const {
+    std::ifstream ifs(manifest_path(archive_sha256));
+    if (!ifs.is_open()) {
+        return false;
+    }
+    try {
+        if (!manifest_from_json(json::parse(ifs), manifest) || manifest.sha256 != archive_sha256) {
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    // 内容已在入库时校验；这里只确认文件仍在（被手动清理时重新入库）
+    std::error_code ec;
+    for (const auto& entry : manifest.files) {
+        if (!fs::exists(content_path(entry.sha256), ec)) return false;
+    }
+    return true;
+}
+
+bool ContentStore::lookup_package(const std::string& name, const std::string& version,
+                                  StoreManifest& manifest) const {
+    std::ifstream ifs(package_path(name, version));
+    std::string archive_sha256;
+    if (!ifs.is_open() || !std::getline(ifs, archive_sha256)) {
+        return false;
+    }
+    return lookup(archive_sha256, manifest);
+}
+
+void ContentStore::record_package(const std::string& name, const std::string& version,
+                                  const std::string& archive_sha256) {
+    write_file_atomic(temp_path(), package_path(name, version), archive_sha256 + "\n");
+}
+
+namespace {
+
+// 流式入库时 libarchive 的数据源：从通道读取压缩数据，同时计算归档哈希并可选地把原始归档写入 store
+struct StreamSource {
+    ByteChannel* channel;
+    Sha256 hasher;
+    std::ofstream tee;
+    std::vector<char> buffer = std::vector<char>(1 << 16);
+    std::string error;
+
+    long next() {
+        long n = channel->read(buffer.data(), buffer.size());
+        if (n < 0) {
+            error = channel->error();
+        } else if (n > 0) {
+            hasher.update(buffer.data(), static_cast<size_t>(n));
+            if (tee.is_open()) tee.write(buffer.data(), n);
+        }
+        return n;
+    }
+};
+
+using ArchiveReader = std::unique_ptr<struct archive, int (*)(struct archive*)>;
+
+la_ssize_t read_stream(struct archive* a, void* client_data, const void** block) {
+    auto* source = static_cast<StreamSource*>(client_data);
+    long n = source->next();
+    if (n < 0) {
+        archive_set_error(a, EIO, "%s", source->error.c_str());
+        return ARCHIVE_FATAL;
+    }
+    *block = source->buffer.data();
+    return n;
+}
+
+} // namespace
+
+StoreManifest ContentStore::ingest_stream(ByteChannel& channel, const std::string& expected_sha256,
+                                          bool keep_archive) {
+    // 任何失败（包括文件系统异常）都要取消通道：否则生产方在缓冲区满时一直暂停，等待它的调用方会死锁
+    std::string tee_temp;
+    try {
+        StreamSource source;
+        source.channel = &channel;
+        if (keep_archive) {
+            tee_temp = temp_path();
+            source.tee.open(tee_temp, std::ios::binary | std::ios::trunc);
+            if (!source.tee.is_open()) {
+                throw std::runtime_error("Failed to write store file: " + tee_temp);
+            }
+        }
+
+        StoreManifest manifest;
+        std::string error;
+        {
+            ArchiveReader a(archive_read_new(), archive_read_free);
+            archive_read_support_filter_gzip(a.get());
+            archive_read_support_format_tar(a.get());
+            if (archive_read_open(a.get(), &source, nullptr, read_stream, nullptr) != ARCHIVE_OK) {
+                error = archive_error_string(a.get()) ? archive_error_string(a.get()) : "Failed to open archive stream";
+            } else {
+                error = store_entries(a.get(), manifest);
+            }
+        }
+
+        // tar 结束标记之后可能还有填充，读完剩余数据才能得到完整的归档哈希
+        while (error.empty()) {
+            long n = source.next();
+            if (n < 0) error = source.error;
+            if (n <= 0) break;
+        }
+        manifest.sha256 = source.hasher.hex_digest();
+        if (error.empty() && !expected_sha256.empty() && manifest.sha256 != expected_sha256) {
+            error = "checksum mismatch (expected " + expected_sha256 + ", got " + manifest.sha256 + ")";
+        }
+        if (source.tee.is_open()) {
+            source.tee.close();
+            if (error.empty() && !source.tee) {
+                error = "Failed to write store file: " + tee_temp;
+            }
+        }
+        if (!error.empty()) {
+            throw std::runtime_error(error);
+        }
+
+        if (keep_archive) {
+            publish(tee_temp, archive_path(manifest.sha256));
+            tee_temp.clear();
+        }
+        // 已写入的文件按内容寻址，校验失败时留下的只是无人引用的文件
+        StoreManifest existing;
+        if (lookup(manifest.sha256, existing)) {
+            return existing;
+        }
+        write_file_atomic(temp_path(), manifest_path(manifest.sha256), manifest_to_json(manifest).dump());
+        return manifest;
+    } catch (...) {
+        channel.cancel();
+        if (!tee_temp.empty()) {
+            std::error_code ec;
+            fs::remove(tee_temp, ec);
+        }
+        throw;
+    }
+}
+
+std::string ContentStore::store_entries(struct archive* a, StoreManifest& manifest) {
+    std::string error;
+    std::vector<char> buffer(1 << 16);
+    std::set<std::string> seen;
+    struct archive_entry* header;
+    for (;;) {
+        int r = archive_read_next_header(a, &header);
+        if (r == ARCHIVE_EOF) break;
+        if (r < ARCHIVE_WARN) {
+            error = archive_error_string(a) ? archive_error_string(a) : "corrupt archive";
+            break;
+        }
+        // 只收普通文件；目录由路径隐含，链接等特殊条目跳过
+        if (archive_entry_filetype(header) != AE_IFREG) continue;
+
+        StoreEntry entry;
+        if (!normalize_entry_path(archive_entry_pathname(header), entry.path)) {
+            error = std::string("Unsafe path in archive: ") + archive_entry_pathname(header);
+            break;
+        }
+        // 同一路径出现两次时安装结果取决于顺序，直接拒绝
+        if (!seen.insert(entry.path).second) {
+            error = "Duplicate path in archive: " + entry.path;
+            break;
+        }
+        entry.executable = (archive_entry_perm(header) & 0111) != 0;
+
+        // 边解压边哈希，写入临时文件后按内容哈希改名；文件系统异常转为错误信息返回
+        std::string temp = temp_path();
+        try {
+            Sha256 hasher;
+            std::ofstream ofs(temp, std::ios::binary | std::ios::trunc);
+            if (!ofs.is_open()) {
+                error = "Failed to write store file: " + temp;
+                break;
+            }
+            la_ssize_t n;
+            while ((n = archive_read_data(a, buffer.data(), buffer.size())) > 0) {
+                hasher.update(buffer.data(), static_cast<size_t>(n));
+                ofs.write(buffer.data(), n);
+                entry.size += static_cast<uint64_t>(n);
+            }
+            ofs.close();
+            if (n < 0) {
+                error = archive_error_string(a) ? archive_error_string(a) : "corrupt archive";
+            } else if (!ofs) {
+                // 写入不完整（磁盘满、I/O 错误）时哈希仍覆盖全部数据，不能以此哈希入库
+                error = "Failed to write store file: " + temp;
+            } else {
+                entry.sha256 = hasher.hex_digest();
+                if (entry.executable) entry.sha256 += "-exec";    // 硬链接共享权限位，可执行文件单独存放
+                fs::permissions(temp, entry.executable ? fs::perms(0555) : fs::perms(0444));
+                publish(temp, content_path(entry.sha256));
+            }
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        if (!error.empty()) {
+            std::error_code ec;
+            fs::remove(temp, ec);
+            break;
+        }
+        manifest.files.push_back(std::move(entry));
+    }
+    return error;
+}
+
+ContentStore::LinkMethod ContentStore::link_into(const StoreManifest& manifest, const std::string& dest) const {
+    fs::remove_all(dest);
+    fs::create_directories(dest);
+
+    LinkMethod used = LinkMethod::HardLink;
+    for (const auto& entry : manifest.files) {
+        std::string source = content_path(entry.sha256);
+        fs::path target = fs::path(dest) / entry.path;
+        fs::create_directories(target.parent_path());
+
+        if (::link(source.c_str(), target.c_str()) == 0) {
+            continue;
+        }
+        // 已存在的目标可能本身就是指向存储对象的硬链接：只能删除后重建，
+        // 打开后截断写入会改写共享对象，破坏所有引用它的包
+        int link_error = errno;
+        ::unlink(target.c_str());
+        if (link_error == EEXIST && ::link(source.c_str(), target.c_str()) == 0) {
+            continue;
+        }
+#ifdef FICLONE
+        // 跨文件系统等无法硬链接时，尝试写时复制克隆
+        int in = ::open(source.c_str(), O_RDONLY);
+        if (in >= 0) {
+            int out = ::open(target.c_str(), O_WRONLY | O_CREAT | O_EXCL, entry.executable ? 0755 : 0644);
+            bool cloned = out >= 0 && ::ioctl(out, FICLONE, in) == 0;
+            if (out >= 0) ::close(out);
+            ::close(in);
+            if (cloned) {
+                if (used == LinkMethod::HardLink) used = LinkMethod::Reflink;
+                continue;
+            }
+        }
+#endif
+        ::unlink(target.c_str());    // 克隆失败时可能留下空文件
+        fs::copy_file(source, target);
+        fs::permissions(target, entry.executable ? fs::perms(0755) : fs::perms(0644));
+        used = LinkMethod::Copy;
+    }
+    return used;
+}
+
+} // namespace cardity
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+struct archive;
+
+namespace cardity {
+
+class ByteChannel;
+
+using json = nlohmann::json;
+
+// 归档中的一个文件
+struct StoreEntry {
+    std::string path;        // 包内相对路径
+    std::string sha256;      // 文件内容哈希，即 store 中的键
+    uint64_t size = 0;
+    bool executable = false;
+};
+
+// 一个已入库归档的清单
+struct StoreManifest {
+    std::string sha256;      // 归档哈希
+    std::vector<StoreEntry> files;
+};
+
+// 内容寻址的全局包存储（多个项目共享）：
+//   files/ab/cdef...        文件内容，按 SHA-256 去重，只读
+//   index/<归档哈希>.json    归档清单
+//   packages/<name>@<ver>   包版本 -> 归档哈希
+//   archives/<归档哈希>.tar.gz 原始归档（入库时要求保留才有）
+// 完整性只在入库时校验一次；安装时把文件硬链接（失败则 reflink，再失败则复制）到项目目录
+class ContentStore {
+public:
+    enum class LinkMethod { HardLink, Reflink, Copy };
+
+    explicit ContentStore(const std::string& root);
+
+    // 默认位置：$CARDITY_STORE，其次 ~/.cardity/store，都不可用时为 fallback
+    static std::string default_root(const std::string& fallback);
+
+    const std::string& root() const { return root_; }
+
+    // 按归档哈希 / 包版本查找已入库的清单
+    bool lookup(const std::string& archive_sha256, StoreManifest& manifest) const;
+    bool lookup_package(const std::string& name, const std::string& version, StoreManifest& manifest) const;
+
+    // 流式入库：边接收边解压、边计算归档哈希，归档无需先落盘；逐文件边解压边哈希写入 store，
+    // 路径越界（绝对路径、..）或重复的条目会被拒绝。keep_archive 时把原始归档同时写入 store
+    // （校验通过后位于 archive_path）。任何失败都会取消通道并抛异常
+    StoreManifest ingest_stream(ByteChannel& channel, const std::string& expected_sha256 = "",
+                                bool keep_archive = false);
+
+    // keep_archive 入库时保存的原始归档位置（不保证存在）
+    std::string archive_path(const std::string& archive_sha256) const;
+
+    // 记录包版本对应的归档
+    void record_package(const std::string& name, const std::string& version, const std::string& archive_sha256);
+
+    // 把清单中的文件放到 dest（先清空 dest）；返回实际使用的最“重”的方式
+    LinkMethod link_into(const StoreManifest& manifest, const std::string& dest) const;
+
+    static std::string file_sha256(const std::string& path);
+    static const char* link_method_name(LinkMethod method);
+
+private:
+    std::string content_path(const std::string& sha256) const;
+    std::string manifest_path(const std::string& archive_sha256) const;
+    std::string package_path(const std::string& name, const std::string& version) const;
+    std::string temp_path() const;
+    std::string store_entries(struct archive* a, StoreManifest& manifest);    // 返回错误信息
+
+    static json manifest_to_json(const StoreManifest& manifest);
+    static bool manifest_from_json(const json& data, StoreManifest& manifest);
+
+    std::string root_;
+};
+
+} // namespace cardity
@@ -0,0 +1,347 @@
+#include "dependency_solver.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <unordered_set>
+#include "canonical_json.h"
+#include "sha256.h"
+
+namespace cardity {
+
+DependencySolver::DependencySolver(MetadataFetcher fetch, unsigned jobs)
+    : fetch_(std::move(fetch)), jobs_(std::max(1u, jobs)) {}
+
+void DependencySolver::set_preferred(const std::unordered_map<std::string, std::string>& versions) {
+    preferred_ = versions;
+}
+
+std::vector<VersionCandidate> DependencySolver::parse_candidates(const json& metadata) {
+    std::vector<VersionCandidate> result;
+    if (!metadata.is_object()) {
+        return result;
+    }
+    std::string latest = metadata.value("latest", "");
+
+    // {"versions": {"1.0.0": {"dependencies": ..., "sha256": ...}}} 或 {"versions": ["1.0.0", ...]}
+    if (metadata.contains("versions") && (metadata["versions"].is_object() || metadata["versions"].is_array())) {
+        const json& versions = metadata["versions"];
+        for (auto it = versions.begin(); it != versions.end(); ++it) {
+            VersionCandidate candidate;
+            const json* info = nullptr;
+            if (versions.is_object()) {
+                candidate.version_string = it.key();
+                info = &it.value();
+            } else if (it->is_string()) {
+                candidate.version_string = it->get<std::string>();
+            }
+            if (!SemVer::parse(candidate.version_string, candidate.version)) {
+                continue;
+            }
+            if (info && info->is_object()) {
+                if (info->contains("dependencies")) {
+                    candidate.dependencies = PackageManager::parse_dependencies((*info)["dependencies"]);
+                }
+                candidate.sha256 = info->value("sha256", "");
+            } else if (candidate.version_string == latest && metadata.contains("dependencies")) {
+                candidate.dependencies = PackageManager::parse_dependencies(metadata["dependencies"]);
+            }
+            result.push_back(std::move(candidate));
+        }
+    } else if (!latest.empty()) {
+        // 只有 latest 的旧格式；非 semver 版本号只能被 "latest"/"*" 匹配
+        VersionCandidate candidate;
+        candidate.version_string = latest;
+        SemVer::parse(latest, candidate.version);
+        if (metadata.contains("dependencies")) {
+            candidate.dependencies = PackageManager::parse_dependencies(metadata["dependencies"]);
+        }
+        candidate.sha256 = metadata.value("sha256", "");
+        result.push_back(std::move(candidate));
+    }
+
+    std::sort(result.begin(), result.end(), [](const VersionCandidate& a, const VersionCandidate& b) {
+        return b.version < a.version;
+    });
+    return result;
+}
+
+void DependencySolver::prefetch(const std::vector<std::string>& names) {
+    std::vector<std::string> missing;
+    std::unordered_set<std::string> seen;
+    for (const auto& name : names) {
+        if (!cache_.count(name) && seen.insert(name).second) missing.push_back(name);
+    }
+    if (missing.empty()) {
+        return;
+    }
+
+    // 同一批元数据异步并发拉取，同时在途的请求不超过 jobs_
+    std::cout << "🔍 Resolving " << missing.size() << " package(s)..." << std::endl;
+    std::vector<std::future<json>> pending(missing.size());
+    size_t done = 0;
+    for (size_t i = 0; i < missing.size(); ++i) {
+        if (i - done >= jobs_) {
+            cache_[missing[done]] = parse_candidates(pending[done].get());
+            ++done;
+        }
+        pending[i] = fetch_(missing[i]);
+    }
+    for (; done < missing.size(); ++done) {
+        cache_[missing[done]] = parse_candidates(pending[done].get());
+    }
+}
+
+const std::vector<VersionCandidate>& DependencySolver::candidates(const std::string& name) {
+    prefetch({name});
+    return cache_[name];
+}
+
+DependencyGraph DependencySolver::solve(const std::vector<Dependency>& roots) {
+    struct Constraint {
+        std::string requester;
+        std::string spec;
+        VersionRange range;
+    };
+    std::unordered_map<std::string, std::vector<Constraint>> constraints;
+    std::unordered_map<std::string, const VersionCandidate*> picks;
+    std::deque<std::string> work;
+    std::unordered_set<std::string> queued;
+
+    auto enqueue = [&](const std::string& name) {
+        if (queued.insert(name).second) work.push_back(name);
+    };
+    auto add = [&](const std::string& requester, const Dependency& dep) {
+        // 依赖名来自注册表元数据，之后会拼进安装路径
+        if (!PackageManager::is_valid_package_name(dep.name)) {
+            throw std::runtime_error("Invalid package name \"" + dep.name + "\" (required by " + requester + ")");
+        }
+        Constraint c;
+        c.requester = requester;
+        c.spec = dep.version.empty() ? "latest" : dep.version;
+        if (!VersionRange::parse(c.spec, c.range)) {
+            throw std::runtime_error("Invalid version range for " + dep.name + " (required by " + requester +
+                                     "): " + c.spec);
+        }
+        constraints[dep.name].push_back(std::move(c));
+        enqueue(dep.name);
+    };
+    // 撤回 requester 旧版本带来的约束；失去全部约束的包连同其子树一起移除
+    std::function<void(const std::string&, const VersionCandidate*)> release =
+        [&](const std::string& requester, const VersionCandidate* old) {
+            for (const auto& dep : old->dependencies) {
+                auto& list = constraints[dep.name];
+                list.erase(std::remove_if(list.begin(), list.end(),
+                                          [&](const Constraint& c) { return c.requester == requester; }),
+                           list.end());
+                if (!list.empty()) {
+                    enqueue(dep.name);
+                    continue;
+                }
+                auto it = picks.find(dep.name);
+                if (it != picks.end()) {
+                    const VersionCandidate* orphan = it->second;
+                    picks.erase(it);
+                    release(dep.name, orphan);
+                }
+            }
+        };
+
+    const std::string root_label = "cardity.json";
+    for (const auto& dep : roots) {
+        add(root_label, dep);
+    }
+
+    // 逐层处理：每层先并发拉取元数据，再依次选版本
+    size_t steps = 0;
+    while (!work.empty()) {
+        std::vector<std::string> batch(work.begin(), work.end());
+        work.clear();
+        queued.clear();
+        prefetch(batch);
+
+        for (const auto& name : batch) {
+            if (++steps > 100000) {
+                throw std::runtime_error("Dependency resolution did not converge");
+            }
+            const auto& list = constraints[name];
+            if (list.empty()) {
+                continue;
+            }
+            const auto& available = cache_[name];
+            if (available.empty()) {
+                throw std::runtime_error("Package not found: " + name + " (required by " + list.front().requester + ")");
+            }
+
+            auto accepts = [&](const VersionCandidate& candidate) {
+                for (const auto& c : list) {
+                    if (!c.range.satisfies(candidate.version)) return false;
+                }
+                return true;
+            };
+            const VersionCandidate* best = nullptr;
+            auto preferred = preferred_.find(name);
+            if (preferred != preferred_.end()) {
+                for (const auto& candidate : available) {
+                    if (candidate.version_string == preferred->second && accepts(candidate)) {
+                        best = &candidate;
+                        break;
+                    }
+                }
+            }
+            for (size_t i = 0; !best && i < available.size(); ++i) {
+                if (accepts(available[i])) best = &available[i];
+            }
+
+            if (!best) {
+                std::string message = "Version conflict for " + name + ":";
+                for (const auto& c : list) {
+                    message += " " + c.requester + " requires " + c.spec + ";";
+                }
+                message += " available:";
+                for (size_t i = 0; i < available.size() && i < 8; ++i) {
+                    message += " " + available[i].version_string;
+                }
+                throw std::runtime_error(message);
+            }
+
+            auto it = picks.find(name);
+            if (it != picks.end() && it->second == best) {
+                continue;
+            }
+            const VersionCandidate* old = it != picks.end() ? it->second : nullptr;
+            picks[name] = best;
+            if (old) {
+                release(name, old);
+            }
+            for (const auto& dep : best->dependencies) {
+                add(name, dep);
+            }
+        }
+    }
+
+    DependencyGraph graph;
+    for (const auto& [name, pick] : picks) {
+        PackageNode node;
+        node.name = name;
+        node.version = pick->version_string;
+        node.dependencies = pick->dependencies;
+        node.sha256 = pick->sha256;
+        graph.nodes[name] = std::move(node);
+    }
+    std::vector<std::string> root_names;
+    for (const auto& dep : roots) root_names.push_back(dep.name);
+    topological_sort(graph, root_names);
+    return graph;
+}
+
+void DependencySolver::topological_sort(DependencyGraph& graph, const std::vector<std::string>& roots) {
+    enum class Mark { None, Visiting, Done };
+    std::unordered_map<std::string, Mark> marks;
+    graph.order.clear();
+    std::function<void(const std::string&)> visit = [&](const std::string& name) {
+        Mark& mark = marks[name];
+        if (mark == Mark::Done) return;
+        if (mark == Mark::Visiting) {
+            throw std::runtime_error("Circular dependency detected at: " + name);
+        }
+        mark = Mark::Visiting;
+        for (const auto& child : graph.nodes.at(name).dependencies) {
+            if (graph.nodes.count(child.name)) visit(child.name);
+        }
+        marks[name] = Mark::Done;
+        graph.order.push_back(name);
+    };
+    for (const auto& name : roots) {
+        if (graph.nodes.count(name)) visit(name);
+    }
+}
+
+std::string LockFile::fingerprint(const std::vector<Dependency>& deps) {
+    json declared = json::object();
+    for (const auto& dep : deps) {
+        declared[dep.name] = dep.version;
+    }
+    Sha256 hasher;
+    CanonicalJson::write(declared, hasher);
+    return hasher.hex_digest();
+}
+
+bool LockFile::read(const std::string& path, LockFile& lock) {
+    std::ifstream ifs(path);
+    if (!ifs.is_open()) {
+        return false;
+    }
+    try {
+        json data = json::parse(ifs);
+        if (data.value("lockfileVersion", 0) != VERSION || !data.contains("packages")) {
+            return false;
+        }
+        lock = LockFile();
+        lock.requires_hash = data.value("requires", "");
+        std::vector<std::string> names;
+        for (const auto& [name, entry] : data["packages"].items()) {
+            if (!PackageManager::is_valid_package_name(name)) {
+                throw std::runtime_error("invalid package name \"" + name + "\"");
+            }
+            PackageNode node;
+            node.name = name;
+            node.version = entry.at("version").get<std::string>();
+            node.sha256 = entry.value("sha256", "");
+            if (entry.contains("dependencies")) {
+                node.dependencies = PackageManager::parse_dependencies(entry["dependencies"]);
+            }
+            names.push_back(name);
+            lock.graph.nodes[name] = std::move(node);
+        }
+        DependencySolver::topological_sort(lock.graph, names);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Ignoring invalid lockfile " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool LockFile::write(const std::string& path) const {
+    // 依赖记录为所选的精确版本；键有序，便于审阅 diff
+    json packages = json::object();
+    for (const auto& [name, node] : graph.nodes) {
+        json entry;
+        entry["version"] = node.version;
+        entry["sha256"] = node.sha256;
+        json deps = json::object();
+        for (const auto& dep : node.dependencies) {
+            auto it = graph.nodes.find(dep.name);
+            if (it != graph.nodes.end()) deps[dep.name] = it->second.version;
+        }
+        entry["dependencies"] = std::move(deps);
+        packages[name] = std::move(entry);
+    }
+    json data;
+    data["lockfileVersion"] = VERSION;
+    data["requires"] = requires_hash;
+    data["packages"] = std::move(packages);
+
+    // 先写临时文件再改名，中断时不会留下半个锁文件
+    std::string temp = path + ".tmp";
+    {
+        std::ofstream ofs(temp, std::ios::trunc);
+        if (!ofs.is_open()) {
+            return false;
+        }
+        ofs << data.dump(2) << std::endl;
+        ofs.close();
+        if (!ofs) {
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace cardity
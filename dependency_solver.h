@@ -0,0 +1,66 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <future>
+#include <unordered_map>
+#include "package_manager.h"
+#include "semver.h"
+
+namespace cardity {
+
+// 某个包的一个可选版本（来自注册表元数据）
+struct VersionCandidate {
+    SemVer version;
+    std::string version_string;            // 注册表中的原文
+    std::vector<Dependency> dependencies;  // 版本范围
+    std::string sha256;                    // 注册表提供时用于校验归档
+};
+
+// 语义化版本求解器：每个包只选一个版本，取满足全部约束的最高版本；
+// 新约束到来时重新选择并撤回旧版本带来的约束，无解时报告冲突及各约束来源
+class DependencySolver {
+public:
+    using MetadataFetcher = std::function<std::future<json>(const std::string&)>;
+
+    explicit DependencySolver(MetadataFetcher fetch, unsigned jobs = 8);
+
+    // 已安装的版本：满足约束时优先保留，避免无谓的升级
+    void set_preferred(const std::unordered_map<std::string, std::string>& versions);
+
+    // 返回完整解（节点版本均为精确版本），order 为拓扑序；无解或循环依赖时抛异常
+    DependencyGraph solve(const std::vector<Dependency>& roots);
+
+    // 包的候选版本（降序）；每个包只拉取一次元数据
+    const std::vector<VersionCandidate>& candidates(const std::string& name);
+
+    static std::vector<VersionCandidate> parse_candidates(const json& metadata);
+
+    // 依赖在前的拓扑序；按 roots 顺序遍历以保证结果确定
+    static void topological_sort(DependencyGraph& graph, const std::vector<std::string>& roots);
+
+private:
+    void prefetch(const std::vector<std::string>& names);
+
+    MetadataFetcher fetch_;
+    unsigned jobs_;
+    std::unordered_map<std::string, std::vector<VersionCandidate>> cache_;
+    std::unordered_map<std::string, std::string> preferred_;
+};
+
+// cardity.lock：解出的精确版本、依赖与归档 SHA-256
+struct LockFile {
+    static constexpr int VERSION = 1;
+
+    std::string requires_hash;     // cardity.json 依赖声明的指纹；不一致时锁文件失效
+    DependencyGraph graph;
+
+    static std::string fingerprint(const std::vector<Dependency>& deps);
+
+    // 文件不存在、格式错误或版本不符时返回 false
+    static bool read(const std::string& path, LockFile& lock);
+    bool write(const std::string& path) const;
+};
+
+} // namespace cardity
@@ -0,0 +1,317 @@
+#include "http_client.h"
+#include <cctype>
+#include <cstdio>
+#include <unordered_set>
+#include <curl/curl.h>
+
+namespace cardity {
+
+namespace {
+
+// 流式写入目标；带上句柄以便在写入前检查状态码
+struct StreamSink {
+    ByteChannel* channel = nullptr;
+    CURL* easy = nullptr;
+};
+
+} // namespace
+
+struct HttpClient::Transfer {
+    HttpRequest request;
+    HttpResponse response;
+    std::promise<HttpResponse> promise;
+    CURL* easy = nullptr;
+    FILE* file = nullptr;
+    curl_slist* headers = nullptr;
+    curl_mime* mime = nullptr;
+    StreamSink sink;
+};
+
+namespace {
+
+size_t write_string(char* data, size_t size, size_t nmemb, void* userp) {
+    static_cast<std::string*>(userp)->append(data, size * nmemb);
+    return size * nmemb;
+}
+
+size_t write_file(char* data, size_t size, size_t nmemb, void* userp) {
+    return std::fwrite(data, size, nmemb, static_cast<FILE*>(userp)) * size;
+}
+
+size_t write_stream(char* data, size_t size, size_t nmemb, void* userp) {
+    auto* sink = static_cast<StreamSink*>(userp);
+    if (sink->channel->cancelled()) {
+        return 0;    // 中止传输
+    }
+    // 错误页不进入通道，传输结束时以 "HTTP <status>" 报错
+    long status = 0;
+    curl_easy_getinfo(sink->easy, CURLINFO_RESPONSE_CODE, &status);
+    if (status >= 300) {
+        return size * nmemb;
+    }
+    return sink->channel->try_write(data, size * nmemb) ? size * nmemb : CURL_WRITEFUNC_PAUSE;
+}
+
+size_t write_header(char* data, size_t size, size_t nmemb, void* userp) {
+    auto* response = static_cast<HttpResponse*>(userp);
+    std::string line(data, size * nmemb);
+    if (line.rfind("HTTP/", 0) == 0) {
+        response->headers.clear();    // 新的状态行（重定向后）
+        return size * nmemb;
+    }
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) {
+        return size * nmemb;
+    }
+    std::string name = line.substr(0, colon);
+    for (char& c : name) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    size_t begin = line.find_first_not_of(" \t", colon + 1);
+    size_t end = line.find_last_not_of(" \t\r\n");
+    std::string value = begin == std::string::npos || end < begin ? "" : line.substr(begin, end - begin + 1);
+    response->headers.emplace_back(std::move(name), std::move(value));
+    return size * nmemb;
+}
+
+constexpr size_t MAX_IDLE_HANDLES = 16;
+
+} // namespace
+
+std::string HttpResponse::header(const std::string& name) const {
+    for (const auto& [key, value] : headers) {
+        if (key == name) return value;
+    }
+    return "";
+}
+
+HttpClient& HttpClient::instance() {
+    static HttpClient client;
+    return client;
+}
+
+HttpClient::HttpClient() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    // share 句柄只在后台线程使用，无需加锁回调
+    CURLSH* share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    share_ = share;
+
+    CURLM* multi = curl_multi_init();
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, 8L);
+    curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, 32L);
+    multi_ = multi;
+
+    loop_ = std::thread(&HttpClient::run, this);
+}
+
+HttpClient::~HttpClient() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    curl_multi_wakeup(static_cast<CURLM*>(multi_));
+    if (loop_.joinable()) loop_.join();
+
+    for (void* easy : idle_handles_) curl_easy_cleanup(static_cast<CURL*>(easy));
+    curl_multi_cleanup(static_cast<CURLM*>(multi_));
+    curl_share_cleanup(static_cast<CURLSH*>(share_));
+    curl_global_cleanup();
+}
+
+std::future<HttpResponse> HttpClient::send(HttpRequest request) {
+    auto* transfer = new Transfer();
+    transfer->request = std::move(request);
+    std::future<HttpResponse> future = transfer->promise.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            transfer->response.error = "HTTP client is shutting down";
+            transfer->promise.set_value(std::move(transfer->response));
+            delete transfer;
+            return future;
+        }
+        queue_.push_back(transfer);
+    }
+    curl_multi_wakeup(static_cast<CURLM*>(multi_));
+    return future;
+}
+
+bool HttpClient::start(Transfer* t) {
+    const HttpRequest& req = t->request;
+    CURL* easy;
+    if (!idle_handles_.empty()) {
+        easy = static_cast<CURL*>(idle_handles_.back());
+        idle_handles_.pop_back();
+    } else {
+        easy = curl_easy_init();
+    }
+    if (!easy) {
+        t->response.error = "Failed to initialize CURL";
+        return false;
+    }
+    t->easy = easy;
+
+    curl_easy_setopt(easy, CURLOPT_URL, req.url.c_str());
+    curl_easy_setopt(easy, CURLOPT_PRIVATE, t);
+    curl_easy_setopt(easy, CURLOPT_SHARE, static_cast<CURLSH*>(share_));
+    curl_easy_setopt(easy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(easy, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(easy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);    // 等待可复用的 HTTP/2 连接，而不是另开一条
+    curl_easy_setopt(easy, CURLOPT_ACCEPT_ENCODING, "");
+    curl_easy_setopt(easy, CURLOPT_HEADERFUNCTION, write_header);
+    curl_easy_setopt(easy, CURLOPT_HEADERDATA, &t->response);
+
+    if (req.stream) {
+        t->sink.channel = req.stream.get();
+        t->sink.easy = easy;
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, write_stream);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &t->sink);
+        req.stream->set_resume_callback([this, t]() { resume(t); });
+    } else if (!req.output_path.empty()) {
+        t->file = std::fopen(req.output_path.c_str(), "wb");
+        if (!t->file) {
+            t->response.error = "Failed to create file: " + req.output_path;
+            return false;
+        }
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, write_file);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, t->file);
+    } else {
+        curl_easy_setopt(easy, CURLOPT_WRITEFUNCTION, write_string);
+        curl_easy_setopt(easy, CURLOPT_WRITEDATA, &t->response.body);
+    }
+
+    if (!req.form_file.empty()) {
+        t->mime = curl_mime_init(easy);
+        curl_mimepart* part = curl_mime_addpart(t->mime);
+        curl_mime_name(part, "file");
+        curl_mime_filedata(part, req.form_file.c_str());
+        curl_easy_setopt(easy, CURLOPT_MIMEPOST, t->mime);
+    } else if (req.method == "POST") {
+        curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(req.body.size()));
+        curl_easy_setopt(easy, CURLOPT_COPYPOSTFIELDS, req.body.c_str());
+    } else if (req.method != "GET") {
+        curl_easy_setopt(easy, CURLOPT_CUSTOMREQUEST, req.method.c_str());
+        if (!req.body.empty()) {
+            curl_easy_setopt(easy, CURLOPT_POSTFIELDSIZE, static_cast<long>(req.body.size()));
+            curl_easy_setopt(easy, CURLOPT_COPYPOSTFIELDS, req.body.c_str());
+        }
+    }
+
+    for (const auto& header : req.headers) {
+        t->headers = curl_slist_append(t->headers, header.c_str());
+    }
+    if (t->headers) {
+        curl_easy_setopt(easy, CURLOPT_HTTPHEADER, t->headers);
+    }
+
+    if (curl_multi_add_handle(static_cast<CURLM*>(multi_), easy) != CURLM_OK) {
+        t->response.error = "Failed to start request";
+        return false;
+    }
+    return true;
+}
+
+void HttpClient::finish(Transfer* t, int result) {
+    if (t->easy) {
+        if (result != CURLE_OK && t->response.error.empty()) {
+            t->response.error = curl_easy_strerror(static_cast<CURLcode>(result));
+        }
+        curl_easy_getinfo(t->easy, CURLINFO_RESPONSE_CODE, &t->response.status);
+        long connects = 0;
+        curl_easy_getinfo(t->easy, CURLINFO_NUM_CONNECTS, &connects);
+        connections_ += static_cast<size_t>(connects);
+
+        curl_multi_remove_handle(static_cast<CURLM*>(multi_), t->easy);
+        if (idle_handles_.size() < MAX_IDLE_HANDLES) {
+            curl_easy_reset(t->easy);
+            idle_handles_.push_back(t->easy);
+        } else {
+            curl_easy_cleanup(t->easy);
+        }
+    }
+    if (t->file) {
+        std::fclose(t->file);
+        if (!t->response.ok()) std::remove(t->request.output_path.c_str());
+    }
+    if (t->request.stream) {
+        t->request.stream->set_resume_callback(nullptr);
+        if (!t->response.error.empty()) {
+            t->request.stream->finish(t->response.error);
+        } else if (!t->response.ok()) {
+            t->request.stream->finish("HTTP " + std::to_string(t->response.status));
+        } else {
+            t->request.stream->finish();
+        }
+    }
+    curl_slist_free_all(t->headers);
+    curl_mime_free(t->mime);
+
+    ++requests_;
+    t->promise.set_value(std::move(t->response));
+    delete t;
+}
+
+void HttpClient::resume(Transfer* transfer) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        resumed_.push_back(transfer);
+    }
+    curl_multi_wakeup(static_cast<CURLM*>(multi_));
+}
+
+void HttpClient::run() {
+    CURLM* multi = static_cast<CURLM*>(multi_);
+    std::unordered_set<Transfer*> active;
+    for (;;) {
+        std::deque<Transfer*> incoming;
+        std::deque<Transfer*> resumed;
+        bool stopping;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            incoming.swap(queue_);
+            resumed.swap(resumed_);
+            stopping = stopping_;
+        }
+        if (stopping) {
+            // 退出时未完成的请求一律失败，不阻塞进程结束
+            for (Transfer* t : incoming) active.insert(t);
+            for (Transfer* t : active) {
+                t->response.error = "HTTP client is shutting down";
+                finish(t, CURLE_ABORTED_BY_CALLBACK);
+            }
+            return;
+        }
+
+        for (Transfer* t : incoming) {
+            if (start(t)) {
+                active.insert(t);
+            } else {
+                finish(t, CURLE_FAILED_INIT);
+            }
+        }
+
+        for (Transfer* t : resumed) {
+            if (active.count(t)) curl_easy_pause(t->easy, CURLPAUSE_CONT);
+        }
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+        int pending = 0;
+        while (CURLMsg* msg = curl_multi_info_read(multi, &pending)) {
+            if (msg->msg != CURLMSG_DONE) continue;
+            Transfer* t = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, reinterpret_cast<char**>(&t));
+            CURLcode result = msg->data.result;
+            active.erase(t);
+            finish(t, result);
+        }
+
+        curl_multi_poll(multi, nullptr, 0, 1000, nullptr);
+    }
+}
+
+} // namespace cardity
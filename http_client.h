@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include "byte_channel.h"
+
+namespace cardity {
+
+struct HttpRequest {
+    std::string url;
+    std::string method = "GET";
+    std::vector<std::string> headers;    // "Name: value"
+    std::string body;
+    std::string output_path;             // 非空时响应体写入该文件（失败时删除）
+    std::string form_file;               // 非空时以 multipart 字段 "file" 上传该文件
+    std::shared_ptr<ByteChannel> stream; // 非空时响应体边下载边写入该通道；缓冲区满时暂停传输
+};
+
+struct HttpResponse {
+    long status = 0;
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> headers;    // 名称为小写；只含最后一跳（跟随重定向时）
+    std::string error;                   // 传输层错误；HTTP 错误看 status
+
+    bool ok() const { return error.empty() && status >= 200 && status < 300; }
+    std::string header(const std::string& name) const;
+};
+
+// 进程内共享的 HTTP 客户端：一个 curl multi 句柄由后台线程驱动，
+// 连接（keep-alive）、DNS 与 TLS 会话在所有请求间复用，HTTPS 下同主机请求走 HTTP/2 多路复用
+class HttpClient {
+public:
+    static HttpClient& instance();
+
+    // 异步发起请求；可一次发出多个再逐个 get()
+    std::future<HttpResponse> send(HttpRequest request);
+    HttpResponse perform(HttpRequest request) { return send(std::move(request)).get(); }
+
+    // 已完成的请求数与新建的连接数
+    size_t requests_completed() const { return requests_; }
+    size_t connections_opened() const { return connections_; }
+
+    ~HttpClient();
+    HttpClient(const HttpClient&) = delete;
+    HttpClient& operator=(const HttpClient&) = delete;
+
+private:
+    struct Transfer;
+
+    HttpClient();
+    void run();
+    bool start(Transfer* transfer);
+    void finish(Transfer* transfer, int result);
+    void resume(Transfer* transfer);
+
+    void* multi_ = nullptr;              // CURLM*
+    void* share_ = nullptr;              // CURLSH*
+    std::vector<void*> idle_handles_;    // 复用的 CURL* 句柄，只在后台线程访问
+
+    std::mutex mutex_;
+    std::deque<Transfer*> queue_;
+    std::deque<Transfer*> resumed_;      // 消费者腾出空间、待继续的流式传输
+    bool stopping_ = false;
+    std::thread loop_;
+
+    std::atomic<size_t> requests_{0};
+    std::atomic<size_t> connections_{0};
+};
+
+} // namespace cardity
@@ -0,0 +1,492 @@
+#include "installed_db.h"
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <stdexcept>
+#include <string_view>
+#include <filesystem>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+
+namespace cardity {
+
+namespace {
+
+constexpr char MAGIC[8] = {'C', 'R', 'D', 'P', 'D', 'B', '1', '\0'};
+
+// 磁盘上的整数一律按小端逐字节编解码，与主机字节序无关；下面两个结构只是解码后的值
+struct Header {
+    char magic[8];
+    uint64_t index_offset;
+    uint64_t index_count;
+    uint64_t tail_offset;    // 追加区起点（= 索引末尾）
+};
+
+struct IndexEntry {
+    uint64_t offset;
+    uint32_t length;
+    uint32_t reserved;
+};
+
+constexpr size_t HEADER_SIZE = 32;         // magic[8] + 3 × u64
+constexpr size_t INDEX_ENTRY_SIZE = 16;    // u64 偏移 + u32 长度 + u32 保留
+
+constexpr uint8_t OP_PUT = 1;
+constexpr uint8_t OP_DELETE = 2;
+constexpr size_t RECORD_PREFIX = 8;    // u32 正文长度 + u32 CRC32
+
+void store_le(unsigned char* p, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+uint64_t load_le(const unsigned char* p, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return value;
+}
+
+uint32_t load_u32(const unsigned char* p) {
+    return static_cast<uint32_t>(load_le(p, 4));
+}
+
+void put_le(std::string& out, uint64_t value, size_t bytes) {
+    unsigned char buffer[8];
+    store_le(buffer, value, bytes);
+    out.append(reinterpret_cast<const char*>(buffer), bytes);
+}
+
+void put_u32(std::string& out, uint32_t value) {
+    put_le(out, value, 4);
+}
+
+Header read_header(const unsigned char* p) {
+    Header h;
+    std::memcpy(h.magic, p, sizeof(h.magic));
+    h.index_offset = load_le(p + 8, 8);
+    h.index_count = load_le(p + 16, 8);
+    h.tail_offset = load_le(p + 24, 8);
+    return h;
+}
+
+std::string encode_header(uint64_t index_offset, uint64_t index_count) {
+    std::string out(MAGIC, sizeof(MAGIC));
+    put_le(out, index_offset, 8);
+    put_le(out, index_count, 8);
+    put_le(out, index_offset + index_count * INDEX_ENTRY_SIZE, 8);
+    return out;
+}
+
+IndexEntry read_entry(const unsigned char* data, uint64_t index_offset, uint64_t i) {
+    const unsigned char* p = data + index_offset + i * INDEX_ENTRY_SIZE;
+    return {load_le(p, 8), load_u32(p + 8), load_u32(p + 12)};
+}
+
+void put_string(std::string& out, const std::string& value) {
+    put_u32(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+void put_list(std::string& out, const std::vector<std::string>& values) {
+    put_u32(out, static_cast<uint32_t>(values.size()));
+    for (const auto& value : values) put_string(out, value);
+}
+
+// 记录正文的顺序读取，越界时置 ok = false
+struct Reader {
+    const unsigned char* p;
+    size_t left;
+    bool ok = true;
+
+    uint32_t u32() {
+        if (left < 4) { ok = false; return 0; }
+        uint32_t value = load_u32(p);
+        p += 4;
+        left -= 4;
+        return value;
+    }
+    std::string str() {
+        uint32_t length = u32();
+        if (!ok || left < length) { ok = false; return ""; }
+        std::string value(reinterpret_cast<const char*>(p), length);
+        p += length;
+        left -= length;
+        return value;
+    }
+    std::vector<std::string> list() {
+        uint32_t count = u32();
+        std::vector<std::string> values;
+        for (uint32_t i = 0; ok && i < count; ++i) values.push_back(str());
+        return values;
+    }
+};
+
+std::string encode_record(uint8_t op, const PackageInfo& info) {
+    std::string body(1, static_cast<char>(op));
+    put_string(body, info.name);
+    if (op == OP_PUT) {
+        put_string(body, info.version);
+        put_string(body, info.description);
+        put_string(body, info.author);
+        put_string(body, info.license);
+        put_string(body, info.repository);
+        put_string(body, info.source);
+        put_string(body, info.hash);
+        put_string(body, info.timestamp);
+        put_list(body, info.dependencies);
+        put_list(body, info.files);
+    }
+    std::string record;
+    put_u32(record, static_cast<uint32_t>(body.size()));
+    put_u32(record, static_cast<uint32_t>(crc32(0, reinterpret_cast<const Bytef*>(body.data()),
+                                                static_cast<uInt>(body.size()))));
+    return record + body;
+}
+
+// 解析 [offset, limit) 处的一条记录；不完整或校验失败时返回 0，否则返回记录总长
+size_t decode_record(const unsigned char* data, uint64_t offset, uint64_t limit, uint8_t& op, PackageInfo& info) {
+    if (limit < offset + RECORD_PREFIX) return 0;
+    uint32_t length = load_u32(data + offset);
+    uint32_t checksum = load_u32(data + offset + 4);
+    if (length == 0 || limit - offset - RECORD_PREFIX < length) return 0;
+    const unsigned char* body = data + offset + RECORD_PREFIX;
+    if (crc32(0, body, length) != checksum) return 0;
+
+    Reader in{body + 1, length - 1u};
+    op = body[0];
+    info = PackageInfo();
+    info.name = in.str();
+    if (op == OP_PUT) {
+        info.version = in.str();
+        info.description = in.str();
+        info.author = in.str();
+        info.license = in.str();
+        info.repository = in.str();
+        info.source = in.str();
+        info.hash = in.str();
+        info.timestamp = in.str();
+        info.dependencies = in.list();
+        info.files = in.list();
+    } else if (op != OP_DELETE) {
+        return 0;
+    }
+    return in.ok ? RECORD_PREFIX + length : 0;
+}
+
+// 索引项来自磁盘：先与文件大小比较再相加，越界或溢出的项视为损坏
+bool entry_in_bounds(const IndexEntry& entry, size_t size) {
+    return entry.offset <= size && entry.length <= size - entry.offset;
+}
+
+// 只取记录中的包名（二分查找用），不做校验和计算
+bool record_name(const unsigned char* data, size_t size, const IndexEntry& entry, std::string_view& name) {
+    if (!entry_in_bounds(entry, size) || entry.length < RECORD_PREFIX + 5) return false;
+    uint32_t length = load_u32(data + entry.offset + RECORD_PREFIX + 1);
+    if (RECORD_PREFIX + 5 + uint64_t(length) > entry.length) return false;
+    name = std::string_view(reinterpret_cast<const char*>(data + entry.offset + RECORD_PREFIX + 5), length);
+    return true;
+}
+
+} // namespace
+
+InstalledDb::InstalledDb(const std::string& path) : path_(path) {}
+
+InstalledDb::~InstalledDb() {
+    unload();
+}
+
+bool InstalledDb::exists() const {
+    return std::filesystem::exists(path_);
+}
+
+void InstalledDb::unload() {
+    if (data_) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+    index_offset_ = index_count_ = end_ = inode_ = 0;
+    tail_.clear();
+    tail_records_ = 0;
+    loaded_ = false;
+}
+
+void InstalledDb::load() {
+    if (loaded_) return;
+    int fd = ::open(path_.c_str(), O_RDONLY);
+    if (fd < 0) {
+        loaded_ = true;    // 还没有数据库：视为空
+        return;
+    }
+    map_file(fd);
+    ::close(fd);
+}
+
+void InstalledDb::map_file(int fd) {
+    unload();
+    loaded_ = true;
+    struct stat st;
+    if (::fstat(fd, &st) != 0) return;
+    inode_ = static_cast<uint64_t>(st.st_ino);
+    if (static_cast<size_t>(st.st_size) < HEADER_SIZE) return;
+
+    void* mapped = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) return;
+    data_ = static_cast<const unsigned char*>(mapped);
+    size_ = static_cast<size_t>(st.st_size);
+
+    // 只校验头部与索引段的范围；记录在访问时逐条检查
+    Header h = read_header(data_);
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.index_offset < HEADER_SIZE ||
+        h.index_offset > size_ || h.index_offset % 8 != 0 ||
+        h.index_count > (size_ - h.index_offset) / INDEX_ENTRY_SIZE ||
+        h.tail_offset != h.index_offset + h.index_count * INDEX_ENTRY_SIZE) {
+        std::cerr << "⚠️  Ignoring corrupt installed package database: " << path_ << std::endl;
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+        return;
+    }
+    index_offset_ = h.index_offset;
+    index_count_ = h.index_count;
+
+    // 读入追加区；末尾不完整的记录（写入中断）忽略，下次写入时截掉
+    uint64_t pos = h.tail_offset;
+    for (;;) {
+        uint8_t op;
+        PackageInfo info;
+        size_t length = decode_record(data_, pos, size_, op, info);
+        if (length == 0) break;
+        std::string name = info.name;
+        tail_[name] = op == OP_PUT ? std::optional<PackageInfo>(std::move(info)) : std::nullopt;
+        tail_records_++;
+        pos += length;
+    }
+    end_ = pos;
+}
+
+std::optional<PackageInfo> InstalledDb::find_indexed(const std::string& name) const {
+    if (!data_ || index_count_ == 0) return std::nullopt;
+    size_t lo = 0, hi = static_cast<size_t>(index_count_);
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        IndexEntry entry = read_entry(data_, index_offset_, mid);
+        std::string_view candidate;
+        if (!record_name(data_, size_, entry, candidate)) return std::nullopt;
+        if (candidate < name) {
+            lo = mid + 1;
+        } else if (name < candidate) {
+            hi = mid;
+        } else {
+            uint8_t op;
+            PackageInfo info;
+            if (!entry_in_bounds(entry, size_) ||
+                decode_record(data_, entry.offset, entry.offset + entry.length, op, info) == 0 ||
+                op != OP_PUT) {
+                return std::nullopt;
+            }
+            return info;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<PackageInfo> InstalledDb::get(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    auto it = tail_.find(name);
+    if (it != tail_.end()) {
+        return it->second;
+    }
+    return find_indexed(name);
+}
+
+std::vector<PackageInfo> InstalledDb::all_loaded() const {
+    std::map<std::string, PackageInfo> merged;
+    if (data_) {
+        for (uint64_t i = 0; i < index_count_; ++i) {
+            IndexEntry entry = read_entry(data_, index_offset_, i);
+            uint8_t op;
+            PackageInfo info;
+            if (entry_in_bounds(entry, size_) &&
+                decode_record(data_, entry.offset, entry.offset + entry.length, op, info) &&
+                op == OP_PUT) {
+                std::string name = info.name;
+                merged[name] = std::move(info);
+            }
+        }
+    }
+    for (const auto& [name, info] : tail_) {
+        if (info) {
+            merged[name] = *info;
+        } else {
+            merged.erase(name);
+        }
+    }
+    std::vector<PackageInfo> packages;
+    packages.reserve(merged.size());
+    for (auto& entry : merged) {
+        packages.push_back(std::move(entry.second));
+    }
+    return packages;
+}
+
+std::vector<PackageInfo> InstalledDb::all() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    load();
+    return all_loaded();
+}
+
+int InstalledDb::lock_file() {
+    for (;;) {
+        int fd = ::open(path_.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open " + path_ + ": " + std::strerror(errno));
+        }
+        if (::flock(fd, LOCK_EX) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Cannot lock " + path_ + ": " + std::strerror(errno));
+        }
+        // 等锁期间文件可能被其他进程压缩替换，此时锁住的是旧文件，需要重新打开
+        struct stat by_fd, by_path;
+        if (::fstat(fd, &by_fd) == 0 && ::stat(path_.c_str(), &by_path) == 0 && by_fd.st_ino == by_path.st_ino) {
+            return fd;
+        }
+        ::close(fd);
+    }
+}
+
+void InstalledDb::sync_locked(int fd) {
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        throw std::runtime_error("Cannot stat " + path_);
+    }
+    if (static_cast<size_t>(st.st_size) < HEADER_SIZE) {
+        // 新建的空库
+        std::string header = encode_header(HEADER_SIZE, 0);
+        if (::pwrite(fd, header.data(), header.size(), 0) != static_cast<ssize_t>(header.size()) ||
+            ::ftruncate(fd, HEADER_SIZE) != 0) {
+            throw std::runtime_error("Failed to initialize " + path_);
+        }
+        unload();
+        load();
+        return;
+    }
+    // 其他进程追加或压缩过时重新映射。
+    // 映射用 load() 另开的描述符：mmap 会持有所用描述符，用加锁的那个会让锁在 close 后仍不释放
+    if (!loaded_ || inode_ != static_cast<uint64_t>(st.st_ino) || end_ != static_cast<uint64_t>(st.st_size)) {
+        unload();
+        load();
+        if (!data_) {
+            throw std::runtime_error("Installed package database is corrupt: " + path_);
+        }
+        if (end_ < static_cast<uint64_t>(st.st_size) && ::ftruncate(fd, static_cast<off_t>(end_)) != 0) {
+            throw std::runtime_error("Failed to repair " + path_);
+        }
+    }
+}
+
+void InstalledDb::append(uint8_t op, const PackageInfo& info) {
+    std::string record = encode_record(op, info);
+    std::lock_guard<std::mutex> lock(mutex_);
+    int fd = lock_file();
+    try {
+        sync_locked(fd);
+        if (::pwrite(fd, record.data(), record.size(), static_cast<off_t>(end_)) !=
+            static_cast<ssize_t>(record.size())) {
+            throw std::runtime_error("Failed to write " + path_);
+        }
+        end_ += record.size();
+        tail_[info.name] = op == OP_PUT ? std::optional<PackageInfo>(info) : std::nullopt;
+        tail_records_++;
+
+        if (tail_records_ >= COMPACT_MIN_RECORDS && tail_records_ > index_count_ / 2) {
+            write_compacted(all_loaded());
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+void InstalledDb::put(const PackageInfo& info) {
+    append(OP_PUT, info);
+}
+
+void InstalledDb::remove(const std::string& name) {
+    append(OP_DELETE, PackageInfo(name, ""));
+}
+
+void InstalledDb::write_compacted(std::vector<PackageInfo> packages) {
+    std::sort(packages.begin(), packages.end(),
+              [](const PackageInfo& a, const PackageInfo& b) { return a.name < b.name; });
+    packages.erase(std::unique(packages.begin(), packages.end(),
+                               [](const PackageInfo& a, const PackageInfo& b) { return a.name == b.name; }),
+                   packages.end());
+
+    std::string content(HEADER_SIZE, '\0');
+    std::vector<IndexEntry> entries;
+    entries.reserve(packages.size());
+    for (const auto& info : packages) {
+        std::string record = encode_record(OP_PUT, info);
+        entries.push_back({content.size(), static_cast<uint32_t>(record.size()), 0});
+        content += record;
+    }
+    content.resize((content.size() + 7) & ~size_t(7), '\0');
+
+    content.replace(0, HEADER_SIZE, encode_header(content.size(), entries.size()));
+    for (const auto& entry : entries) {
+        put_le(content, entry.offset, 8);
+        put_u32(content, entry.length);
+        put_u32(content, entry.reserved);
+    }
+
+    // 写临时文件后原子替换；调用方持有文件锁
+    std::string temp = path_ + ".tmp";
+    int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot create " + temp);
+    }
+    bool ok = ::write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()) &&
+              ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || ::rename(temp.c_str(), path_.c_str()) != 0) {
+        ::unlink(temp.c_str());
+        throw std::runtime_error("Failed to write " + path_);
+    }
+
+    unload();
+    load();
+}
+
+void InstalledDb::replace_all(std::vector<PackageInfo> packages) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int fd = lock_file();
+    try {
+        write_compacted(std::move(packages));
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+void InstalledDb::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int fd = lock_file();
+    try {
+        sync_locked(fd);
+        write_compacted(all_loaded());
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+} // namespace cardity
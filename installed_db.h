@@ -0,0 +1,66 @@
+#pragma once
+
+#include "package_manager.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <cstdint>
+
+namespace cardity {
+
+// 已安装包数据库：单文件、只追加写、按名称索引，首次访问时才 mmap 打开。
+// 文件布局（小端）：
+//   Header | 压缩区记录（按名称排序）| Index[index_count] | 追加区记录...
+// 每条记录为 u32 长度 + u32 CRC32 + 正文（操作类型、名称、字段）。
+// 查询单个包时在 Index 上二分查找，再查看追加区，不加载整个库；
+// 追加区过长时压缩：只保留每个包的最新记录，重写索引后原子替换文件。
+// 写入时持有文件锁，多个 cardity 进程可同时使用
+class InstalledDb {
+public:
+    static constexpr size_t COMPACT_MIN_RECORDS = 64;    // 追加区至少这么多条且超过压缩区一半时压缩
+
+    explicit InstalledDb(const std::string& path);
+    ~InstalledDb();
+    InstalledDb(const InstalledDb&) = delete;
+    InstalledDb& operator=(const InstalledDb&) = delete;
+
+    bool exists() const;    // 数据库文件是否已存在
+
+    std::optional<PackageInfo> get(const std::string& name);
+    bool contains(const std::string& name) { return get(name).has_value(); }
+    std::vector<PackageInfo> all();    // 按名称排序
+
+    void put(const PackageInfo& info);
+    void remove(const std::string& name);
+
+    // 用给定内容整体替换（迁移旧格式时使用）
+    void replace_all(std::vector<PackageInfo> packages);
+    void compact();
+
+private:
+    void load();
+    void map_file(int fd);
+    void unload();
+    int lock_file();
+    void sync_locked(int fd);
+    void append(uint8_t op, const PackageInfo& info);
+    void write_compacted(std::vector<PackageInfo> packages);
+    std::optional<PackageInfo> find_indexed(const std::string& name) const;
+    std::vector<PackageInfo> all_loaded() const;
+
+    std::string path_;
+    std::mutex mutex_;
+    bool loaded_ = false;
+    const unsigned char* data_ = nullptr;    // mmap 的文件内容
+    size_t size_ = 0;
+    uint64_t index_offset_ = 0;
+    uint64_t index_count_ = 0;
+    uint64_t end_ = 0;                       // 最后一条完整记录之后的位置
+    uint64_t inode_ = 0;
+    std::map<std::string, std::optional<PackageInfo>> tail_;    // 追加区中各包的最新状态，nullopt 表示已删除
+    size_t tail_records_ = 0;
+};
+
+} // namespace cardity
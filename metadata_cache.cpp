@@ -0,0 +1,129 @@
+#include "metadata_cache.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <atomic>
+#include <unistd.h>
+#include "http_client.h"
+#include "sha256.h"
+
+namespace cardity {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+long long now_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+std::future<json> ready(json value) {
+    std::promise<json> promise;
+    promise.set_value(std::move(value));
+    return promise.get_future();
+}
+
+} // namespace
+
+MetadataCache::MetadataCache(const std::string& dir, long ttl_seconds) : dir_(dir), ttl_(ttl_seconds) {
+    fs::create_directories(dir_);
+}
+
+std::string MetadataCache::entry_path(const std::string& url) const {
+    Sha256 hasher;
+    hasher.update(url.data(), url.size());
+    return dir_ + "/" + hasher.hex_digest() + ".json";
+}
+
+bool MetadataCache::load(const std::string& url, Entry& entry) const {
+    std::ifstream ifs(entry_path(url));
+    if (!ifs.is_open()) {
+        return false;
+    }
+    try {
+        json data = json::parse(ifs);
+        if (data.value("url", "") != url || !data.contains("body")) {
+            return false;
+        }
+        entry.etag = data.value("etag", "");
+        entry.last_modified = data.value("last_modified", "");
+        entry.fetched_at = data.value("fetched_at", 0LL);
+        entry.body = std::move(data["body"]);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+void MetadataCache::save(const std::string& url, const Entry& entry) const {
+    json data = {{"url", url},
+                 {"etag", entry.etag},
+                 {"last_modified", entry.last_modified},
+                 {"fetched_at", entry.fetched_at},
+                 {"body", entry.body}};
+    // 并发写同一条目时各写各的临时文件，改名保证读者只看到完整内容
+    static std::atomic<unsigned> counter{0};
+    std::string path = entry_path(url);
+    std::string temp = path + ".tmp" + std::to_string(::getpid()) + "-" + std::to_string(counter++);
+    {
+        std::ofstream ofs(temp);
+        if (!ofs.is_open()) {
+            return;
+        }
+        ofs << data.dump();
+    }
+    std::error_code ec;
+    fs::rename(temp, path, ec);
+    if (ec) fs::remove(temp, ec);
+}
+
+std::future<json> MetadataCache::fetch(const std::string& url, const std::vector<std::string>& headers) {
+    auto entry = std::make_shared<Entry>();
+    bool cached = load(url, *entry);
+
+    if (offline_) {
+        return ready(cached ? entry->body : json());
+    }
+    if (cached && now_seconds() - entry->fetched_at < ttl_) {
+        return ready(entry->body);
+    }
+
+    HttpRequest request;
+    request.url = url;
+    request.headers = headers;
+    if (cached) {
+        if (!entry->etag.empty()) request.headers.push_back("If-None-Match: " + entry->etag);
+        if (!entry->last_modified.empty()) request.headers.push_back("If-Modified-Since: " + entry->last_modified);
+    }
+    auto pending = std::make_shared<std::future<HttpResponse>>(HttpClient::instance().send(std::move(request)));
+
+    return std::async(std::launch::deferred, [this, url, entry, cached, pending]() {
+        HttpResponse response = pending->get();
+        if (cached && response.error.empty() && response.status == 304) {
+            entry->fetched_at = now_seconds();
+            save(url, *entry);
+            return entry->body;
+        }
+        if (response.ok()) {
+            try {
+                entry->body = json::parse(response.body);
+            } catch (const std::exception&) {
+                return json();
+            }
+            entry->etag = response.header("etag");
+            entry->last_modified = response.header("last-modified");
+            entry->fetched_at = now_seconds();
+            save(url, *entry);
+            return entry->body;
+        }
+        if (cached && !response.error.empty()) {
+            std::cerr << "Warning: " << url << ": " << response.error << ", using cached metadata" << std::endl;
+            return entry->body;
+        }
+        return json();
+    });
+}
+
+} // namespace cardity
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <future>
+#include <nlohmann/json.hpp>
+
+namespace cardity {
+
+using json = nlohmann::json;
+
+// 注册表元数据的磁盘缓存：每个 URL 一个文件，保存响应体与 ETag/Last-Modified。
+// TTL 内直接使用缓存；过期后带 If-None-Match/If-Modified-Since 重新验证，304 时只刷新时间戳。
+// 网络失败时退回到过期的缓存；离线模式只读缓存
+class MetadataCache {
+public:
+    static constexpr long DEFAULT_TTL = 300;    // 秒
+
+    explicit MetadataCache(const std::string& dir, long ttl_seconds = DEFAULT_TTL);
+
+    void set_offline(bool offline) { offline_ = offline; }
+    bool offline() const { return offline_; }
+    void set_ttl(long ttl_seconds) { ttl_ = ttl_seconds; }
+    long ttl() const { return ttl_; }
+
+    // 异步获取 URL 的 JSON；取不到时结果为空 json
+    std::future<json> fetch(const std::string& url, const std::vector<std::string>& headers = {});
+    json get(const std::string& url, const std::vector<std::string>& headers = {}) { return fetch(url, headers).get(); }
+
+private:
+    struct Entry {
+        std::string etag;
+        std::string last_modified;
+        long long fetched_at = 0;    // Unix 时间（秒）
+        json body;
+    };
+
+    std::string entry_path(const std::string& url) const;
+    bool load(const std::string& url, Entry& entry) const;
+    void save(const std::string& url, const Entry& entry) const;
+
+    std::string dir_;
+    long ttl_;
+    bool offline_ = false;
+};
+
+} // namespace cardity
@@ -0,0 +1,227 @@
+#include "package_archive.h"
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <deque>
+#include <future>
+#include <thread>
+#include <cstdlib>
+#include <cerrno>
+#include <archive.h>
+#include <archive_entry.h>
+#include <zlib.h>
+#include "sha256.h"
+
+namespace cardity {
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// 把一块 tar 数据压缩为独立的 gzip 成员；头部字段固定，输出只取决于输入
+std::string gzip_member(const std::string& input) {
+    z_stream zs{};
+    if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("Failed to initialize gzip stream");
+    }
+    gz_header header{};
+    header.os = 3;    // 固定为 Unix，不随构建平台变化
+    deflateSetHeader(&zs, &header);
+
+    std::string output(deflateBound(&zs, input.size()), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    zs.avail_in = static_cast<uInt>(input.size());
+    zs.next_out = reinterpret_cast<Bytef*>(&output[0]);
+    zs.avail_out = static_cast<uInt>(output.size());
+    int rc = deflate(&zs, Z_FINISH);
+    output.resize(zs.total_out);
+    deflateEnd(&zs);
+    if (rc != Z_STREAM_END) {
+        throw std::runtime_error("gzip compression failed");
+    }
+    return output;
+}
+
+// 收集 tar 流、分块并行压缩，按原顺序写出并计算哈希；同时进行压缩的块不超过 jobs 个
+class CompressedOutput {
+public:
+    CompressedOutput(const std::string& path, unsigned jobs) : jobs_(jobs) {
+        file_.open(path, std::ios::binary | std::ios::trunc);
+        if (!file_.is_open()) {
+            throw std::runtime_error("Cannot create archive: " + path);
+        }
+    }
+
+    void append(const char* data, size_t size) {
+        block_.append(data, size);
+        while (block_.size() >= PackageArchive::BLOCK_SIZE) {
+            std::string rest = block_.substr(PackageArchive::BLOCK_SIZE);
+            block_.resize(PackageArchive::BLOCK_SIZE);
+            submit(std::move(block_));
+            block_ = std::move(rest);
+        }
+    }
+
+    void finish(PackageArchive::Result& result) {
+        if (!block_.empty()) {
+            submit(std::move(block_));
+            block_.clear();
+        }
+        while (!pending_.empty()) {
+            drain_one();
+        }
+        file_.close();
+        if (!file_) {
+            throw std::runtime_error("Failed to write archive");
+        }
+        result.sha256 = hasher_.hex_digest();
+        result.size = size_;
+    }
+
+private:
+    void submit(std::string block) {
+        if (pending_.size() >= jobs_) {
+            drain_one();
+        }
+        pending_.push_back(std::async(std::launch::async, gzip_member, std::move(block)));
+    }
+
+    void drain_one() {
+        std::string member = pending_.front().get();
+        pending_.pop_front();
+        file_.write(member.data(), static_cast<std::streamsize>(member.size()));
+        hasher_.update(member);
+        size_ += member.size();
+    }
+
+    unsigned jobs_;
+    std::ofstream file_;
+    Sha256 hasher_;
+    uintmax_t size_ = 0;
+    std::string block_;
+    std::deque<std::future<std::string>> pending_;
+};
+
+la_ssize_t write_output(struct archive* a, void* client_data, const void* buffer, size_t length) {
+    try {
+        static_cast<CompressedOutput*>(client_data)->append(static_cast<const char*>(buffer), length);
+    } catch (const std::exception& e) {
+        archive_set_error(a, EIO, "%s", e.what());
+        return -1;
+    }
+    return static_cast<la_ssize_t>(length);
+}
+
+} // namespace
+
+long long PackageArchive::default_mtime() {
+    const char* epoch = std::getenv("SOURCE_DATE_EPOCH");
+    return epoch && *epoch ? std::strtoll(epoch, nullptr, 10) : 0;
+}
+
+PackageArchive::Result PackageArchive::write(const std::string& root, std::vector<std::string> files,
+                                             const std::string& output_path, unsigned jobs) {
+    return write(root, std::move(files), output_path, jobs, default_mtime());
+}
+
+PackageArchive::Result PackageArchive::write(const std::string& root, std::vector<std::string> files,
+                                             const std::string& output_path, unsigned jobs, long long mtime) {
+    if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    for (auto& file : files) {
+        file = fs::path(file).generic_string();
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+
+    std::string temp = output_path + ".tmp";
+    Result result;
+    std::string error;
+    {
+        CompressedOutput output(temp, jobs);
+        struct archive* a = archive_write_new();
+        archive_write_set_format_pax_restricted(a);
+        archive_write_add_filter_none(a);
+        if (archive_write_open(a, &output, nullptr, write_output, nullptr) != ARCHIVE_OK) {
+            error = archive_error_string(a) ? archive_error_string(a) : "Failed to open archive";
+        }
+
+        struct archive_entry* entry = archive_entry_new();
+        std::vector<char> buffer(1 << 16);
+        for (size_t i = 0; i < files.size() && error.empty(); ++i) {
+            fs::path path = fs::path(root) / files[i];
+            std::ifstream input(path, std::ios::binary);
+            if (!input.is_open()) {
+                error = "Cannot read " + path.string();
+                break;
+            }
+            // 用 error_code 版本：这里抛出异常会跳过下面的 archive 释放并留下临时文件
+            std::error_code ec;
+            fs::file_status status = fs::status(path, ec);
+            uintmax_t size = ec ? 0 : fs::file_size(path, ec);
+            if (ec) {
+                error = "Cannot stat " + path.string() + ": " + ec.message();
+                break;
+            }
+            // 只保留可执行位，其余元数据统一固定
+            bool executable = (status.permissions() & fs::perms::owner_exec) != fs::perms::none;
+            archive_entry_clear(entry);
+            archive_entry_set_pathname(entry, files[i].c_str());
+            archive_entry_set_filetype(entry, AE_IFREG);
+            archive_entry_set_perm(entry, executable ? 0755 : 0644);
+            archive_entry_set_size(entry, static_cast<la_int64_t>(size));
+            archive_entry_set_mtime(entry, static_cast<time_t>(mtime), 0);
+            archive_entry_set_uid(entry, 0);
+            archive_entry_set_gid(entry, 0);
+            if (archive_write_header(a, entry) != ARCHIVE_OK) {
+                error = archive_error_string(a) ? archive_error_string(a) : "Failed to write entry header";
+                break;
+            }
+            uintmax_t read = 0;
+            while (input) {
+                input.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                std::streamsize n = input.gcount();
+                if (n > 0 && archive_write_data(a, buffer.data(), static_cast<size_t>(n)) < 0) {
+                    error = archive_error_string(a) ? archive_error_string(a) : "Failed to write entry data";
+                    break;
+                }
+                read += static_cast<uintmax_t>(n);
+            }
+            // 读取出错，或文件在打包期间变化（libarchive 会把缩短的条目静默补零、把多出的数据截掉）
+            if (error.empty() && input.bad()) {
+                error = "Failed to read " + path.string();
+            } else if (error.empty() && read != size) {
+                error = path.string() + " changed while it was being archived";
+            }
+            if (!error.empty()) break;
+            result.entries++;
+        }
+        archive_entry_free(entry);
+        if (archive_write_close(a) != ARCHIVE_OK && error.empty()) {
+            error = archive_error_string(a) ? archive_error_string(a) : "Failed to finish archive";
+        }
+        archive_write_free(a);
+
+        if (error.empty()) {
+            try {
+                output.finish(result);
+            } catch (const std::exception& e) {
+                error = e.what();
+            }
+        }
+    }
+
+    std::error_code ec;
+    if (!error.empty()) {
+        fs::remove(temp, ec);
+        throw std::runtime_error(error);
+    }
+    fs::rename(temp, output_path, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        throw std::runtime_error("Failed to write archive: " + output_path);
+    }
+    return result;
+}
+
+} // namespace cardity
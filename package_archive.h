@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace cardity {
+
+// 可复现的 .tar.gz 打包：条目按路径排序，mtime/属主/权限固定，相同输入在任何机器上得到相同字节。
+// tar 流按固定大小切块后在多个线程上各自压缩为一个 gzip 成员，按顺序拼接（多成员 gzip，
+// gzip -d 与 libarchive 均可直接读取）；写出的同时计算归档的 SHA-256
+class PackageArchive {
+public:
+    static constexpr size_t BLOCK_SIZE = 1 << 20;    // 每个 gzip 成员压缩的 tar 字节数
+
+    struct Result {
+        std::string sha256;
+        uintmax_t size = 0;      // 归档字节数
+        size_t entries = 0;
+    };
+
+    // files 为相对 root 的路径；jobs 为 0 时按硬件线程数。
+    // mtime 默认取 SOURCE_DATE_EPOCH，未设置时为 0。失败时抛出 std::runtime_error
+    static Result write(const std::string& root, std::vector<std::string> files, const std::string& output_path,
+                        unsigned jobs = 0);
+    static Result write(const std::string& root, std::vector<std::string> files, const std::string& output_path,
+                        unsigned jobs, long long mtime);
+
+    static long long default_mtime();
+};
+
+} // namespace cardity
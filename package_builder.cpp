@@ -1,13 +1,105 @@
 #include "package_manager.h"
+#include "content_store.h"
+#include "package_archive.h"
+#include "tokenizer.h"
+#include "parser.h"
+#include "car_generator.h"
 #include <iostream>
+#include <iomanip>
 #include <fstream>
 #include <filesystem>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
 #include <nlohmann/json.hpp>
 
 using namespace cardity;
 using json = nlohmann::json;
 namespace fs = std::filesystem;
 
+namespace {
+
+const int BUILD_STATE_VERSION = 2;    // 2：imports 也记录 using 的模块
+
+bool is_asset(const fs::path& path) {
+    auto ext = path.extension().string();
+    return ext == ".json" || ext == ".md" || ext == ".txt" || ext == ".yml" || ext == ".yaml";
+}
+
+double elapsed_ms(std::chrono::steady_clock::time_point since) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - since).count();
+}
+
+// 大小与修改时间都没变时沿用记录的哈希，否则重新计算；返回内容是否变化
+template <typename Record>
+bool refresh_record(const fs::path& path, Record& record) {
+    uintmax_t size = fs::file_size(path);
+    long long mtime = static_cast<long long>(fs::last_write_time(path).time_since_epoch().count());
+    if (!record.hash.empty() && record.size == size && record.mtime == mtime) {
+        return false;
+    }
+    std::string hash = ContentStore::file_sha256(path.string());
+    bool changed = hash != record.hash;
+    record.hash = hash;
+    record.size = size;
+    record.mtime = mtime;
+    return changed;
+}
+
+// 用容错模式的词法分析取出协议名与 import/using 的模块名，不做完整解析
+void scan_module(const std::string& content, std::string& module, std::vector<std::string>& imports) {
+    module.clear();
+    imports.clear();
+    std::vector<Token> tokens = tokenize_all(content, true);
+    for (size_t i = 0; i + 1 < tokens.size(); ++i) {
+        if (!is_word_token(tokens[i + 1])) continue;
+        if (tokens[i].value == "protocol" && module.empty()) {
+            module = tokens[i + 1].value;
+        } else if (tokens[i].value == "import" || tokens[i].value == "using") {
+            imports.push_back(tokens[i + 1].value);
+        }
+    }
+}
+
+std::string read_file(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + path.string());
+    }
+    return std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// 编译单个模块，写出 .car JSON
+// 解析器的警告与调试信息写入 log，不经过共享的 std::cout
+void compile_module(const fs::path& input, const fs::path& output, std::ostream& log) {
+    std::string content = read_file(input);
+    Tokenizer tokenizer(content);
+    Parser parser(tokenizer, log);
+    json car = CarGenerator::compile_to_car(CarGenerator::from_ast(parser.parse_protocol()));
+
+    fs::create_directories(output.parent_path());
+    std::string tmp = output.string() + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        file << car.dump(2);
+        if (!file.good()) {
+            throw std::runtime_error("Failed to write " + output.string());
+        }
+    }
+    fs::rename(tmp, output);
+}
+
+fs::path module_output(const std::string& output_dir, const std::string& rel) {
+    return (fs::path(output_dir) / rel).replace_extension(".json");
+}
+
+} // namespace
+
 // PackageBuilder 实现
 PackageBuilder::PackageBuilder(const std::string& source, const std::string& output)
     : source_dir(source), output_dir(output) {
@@ -17,26 +109,68 @@ bool PackageBuilder::build() {
     std::cout << "🔨 Building project..." << std::endl;
     
     try {
+        auto build_start = std::chrono::steady_clock::now();
+        
         // 创建输出目录
         fs::create_directories(output_dir);
+        load_build_state();
         
-        // 编译源文件
-        if (!compile_sources()) {
+        // 扫描输入文件
+        auto stage_start = std::chrono::steady_clock::now();
+        std::vector<std::string> sources, assets;
+        scan_inputs(sources, assets);
+        double scan_ms = elapsed_ms(stage_start);
+        
+        // 源文件 foo.cardity 编译为 foo.json，不能与同名资源 foo.json 写到同一个输出文件
+        std::set<std::string> asset_set(assets.begin(), assets.end());
+        for (const auto& rel : sources) {
+            std::string output = fs::path(rel).replace_extension(".json").generic_string();
+            if (asset_set.count(output)) {
+                std::cerr << "❌ " << rel << " and asset " << output << " both map to "
+                          << (fs::path(output_dir) / output).generic_string() << std::endl;
+                return false;
+            }
+        }
+        
+        // 编译源文件（只编译变化的模块及其导入方）
+        stage_start = std::chrono::steady_clock::now();
+        size_t compiled = 0;
+        bool sources_ok = compile_sources(sources, compiled);
+        double compile_ms = elapsed_ms(stage_start);
+        if (!sources_ok) {
+            save_build_state();    // 成功的模块不必下次重编
             std::cerr << "❌ Failed to compile sources" << std::endl;
             return false;
         }
         
-        // 复制资源文件
-        if (!copy_assets()) {
+        // 复制资源文件（只复制内容变化的）
+        stage_start = std::chrono::steady_clock::now();
+        size_t copied = 0;
+        if (!copy_assets(assets, copied)) {
             std::cerr << "❌ Failed to copy assets" << std::endl;
             return false;
         }
+        double assets_ms = elapsed_ms(stage_start);
         
         // 生成元数据
+        stage_start = std::chrono::steady_clock::now();
         if (!generate_metadata()) {
             std::cerr << "❌ Failed to generate metadata" << std::endl;
             return false;
         }
+        save_build_state();
+        double metadata_ms = elapsed_ms(stage_start);
+        
+        std::cout << "⏱️  Build timing:" << std::fixed << std::setprecision(1) << std::endl;
+        std::cout << "    scan     " << std::setw(8) << scan_ms << " ms  (" << sources.size()
+                  << " source(s), " << assets.size() << " asset(s))" << std::endl;
+        std::cout << "    compile  " << std::setw(8) << compile_ms << " ms  (" << compiled << "/"
+                  << sources.size() << " module(s) rebuilt)" << std::endl;
+        std::cout << "    assets   " << std::setw(8) << assets_ms << " ms  (" << copied << "/"
+                  << assets.size() << " copied)" << std::endl;
+        std::cout << "    metadata " << std::setw(8) << metadata_ms << " ms" << std::endl;
+        std::cout << "    total    " << std::setw(8) << elapsed_ms(build_start) << " ms" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
         
         std::cout << "✅ Build completed successfully" << std::endl;
         return true;
@@ -49,7 +183,14 @@ bool PackageBuilder::build() {
 
 bool PackageBuilder::build_for_distribution() {
     std::cout << "📦 Building for distribution..." << std::endl;
-    return build();
+    if (!build()) {
+        return false;
+    }
+    if (!create_archive()) {
+        std::cerr << "❌ Failed to create archive" << std::endl;
+        return false;
+    }
+    return true;
 }
 
 bool PackageBuilder::build_for_development() {
@@ -62,6 +203,8 @@ void PackageBuilder::clean() {
     if (fs::exists(output_dir)) {
         fs::remove_all(output_dir);
     }
+    source_records.clear();
+    asset_records.clear();
 }
 
 bool PackageBuilder::run_script(const std::string& script_name) {
@@ -90,7 +233,35 @@ bool PackageBuilder::publish(const std::string& api_key) {
     return true;
 }
 
-bool PackageBuilder::compile_sources() {
+void PackageBuilder::scan_inputs(std::vector<std::string>& sources, std::vector<std::string>& assets) {
+    if (!fs::exists(source_dir)) {
+        return;
+    }
+    
+    // 跳过输出目录与隐藏目录（.cardity 等）
+    fs::path output = fs::weakly_canonical(output_dir);
+    for (auto it = fs::recursive_directory_iterator(source_dir); it != fs::recursive_directory_iterator(); ++it) {
+        const auto& entry = *it;
+        if (entry.is_directory()) {
+            std::string name = entry.path().filename().string();
+            if ((!name.empty() && name[0] == '.') || fs::weakly_canonical(entry.path()) == output) {
+                it.disable_recursion_pending();
+            }
+            continue;
+        }
+        if (!entry.is_regular_file()) continue;
+        std::string rel = fs::relative(entry.path(), source_dir).generic_string();
+        if (entry.path().extension() == ".cardity") {
+            sources.push_back(rel);
+        } else if (is_asset(entry.path())) {
+            assets.push_back(rel);
+        }
+    }
+    std::sort(sources.begin(), sources.end());
+    std::sort(assets.begin(), assets.end());
+}
+
+bool PackageBuilder::compile_sources(const std::vector<std::string>& sources, size_t& compiled) {
     std::cout << "  Compiling sources..." << std::endl;
     
     if (!fs::exists(source_dir)) {
@@ -98,43 +269,209 @@ bool PackageBuilder::compile_sources() {
         return false;
     }
     
-    // 查找所有 .cardity 文件
-    for (const auto& entry : fs::recursive_directory_iterator(source_dir)) {
-        if (entry.is_regular_file() && entry.path().extension() == ".cardity") {
-            std::cout << "    Compiling: " << entry.path().filename() << std::endl;
-            // 这里应该调用实际的编译器
+    // 找出内容变化的模块；协议名变化时新旧名字都算变化
+    std::set<std::string> dirty;
+    std::set<std::string> changed_modules;
+    for (const auto& rel : sources) {
+        FileRecord& record = source_records[rel];
+        std::string previous_module = record.module;
+        bool is_new = record.hash.empty();
+        if (refresh_record(fs::path(source_dir) / rel, record) || is_new) {
+            scan_module(read_file(fs::path(source_dir) / rel), record.module, record.imports);
+            dirty.insert(rel);
+            changed_modules.insert(previous_module);
+            changed_modules.insert(record.module);
+        } else if (!fs::exists(module_output(output_dir, rel))) {
+            dirty.insert(rel);
         }
     }
     
-    return true;
+    // 已删除的源文件：移除其输出，导入它的模块需要重编
+    std::set<std::string> present(sources.begin(), sources.end());
+    for (auto it = source_records.begin(); it != source_records.end();) {
+        if (present.count(it->first)) {
+            ++it;
+            continue;
+        }
+        changed_modules.insert(it->second.module);
+        std::error_code ec;
+        fs::remove(module_output(output_dir, it->first), ec);
+        it = source_records.erase(it);
+    }
+    changed_modules.erase("");
+    
+    // 沿反向 import 边传播到所有（间接）导入方
+    std::map<std::string, std::vector<std::string>> importers;
+    for (const auto& [rel, record] : source_records) {
+        for (const auto& module : record.imports) {
+            importers[module].push_back(rel);
+        }
+    }
+    std::deque<std::string> pending(changed_modules.begin(), changed_modules.end());
+    while (!pending.empty()) {
+        std::string module = pending.front();
+        pending.pop_front();
+        auto found = importers.find(module);
+        if (found == importers.end()) continue;
+        for (const auto& rel : found->second) {
+            if (dirty.insert(rel).second) {
+                pending.push_back(source_records[rel].module);
+            }
+        }
+    }
+    
+    std::vector<std::string> work(dirty.begin(), dirty.end());
+    compiled = work.size();
+    if (work.empty()) {
+        return true;
+    }
+    
+    unsigned workers = jobs > 0 ? jobs : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min<unsigned>(workers, static_cast<unsigned>(work.size()));
+    
+    std::vector<std::string> errors(work.size());
+    std::atomic<size_t> next{0};
+    std::mutex log_mutex;
+    auto worker = [&]() {
+        for (size_t i = next++; i < work.size(); i = next++) {
+            // 每个任务自己的日志：成功时丢弃，失败时随错误一起输出
+            std::ostringstream log;
+            try {
+                compile_module(fs::path(source_dir) / work[i], module_output(output_dir, work[i]), log);
+            } catch (const std::exception& e) {
+                errors[i] = e.what();
+            }
+            std::lock_guard<std::mutex> lock(log_mutex);
+            if (errors[i].empty()) {
+                std::cout << "    Compiling: " << work[i] << std::endl;
+            } else {
+                std::cerr << log.str() << "    ❌ " << work[i] << ": " << errors[i] << std::endl;
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < workers; ++t) pool.emplace_back(worker);
+    for (auto& thread : pool) thread.join();
+    
+    // 失败的模块清空哈希，下次构建重试
+    bool ok = true;
+    for (size_t i = 0; i < work.size(); ++i) {
+        if (!errors[i].empty()) {
+            source_records[work[i]].hash.clear();
+            ok = false;
+        }
+    }
+    return ok;
 }
 
-bool PackageBuilder::copy_assets() {
+bool PackageBuilder::copy_assets(const std::vector<std::string>& assets, size_t& copied) {
     std::cout << "  Copying assets..." << std::endl;
     
-    if (!fs::exists(source_dir)) {
-        return true; // 没有源目录，认为成功
-    }
-    
-    // 复制非源文件
-    for (const auto& entry : fs::recursive_directory_iterator(source_dir)) {
-        if (entry.is_regular_file()) {
-            auto ext = entry.path().extension().string();
-            // 只复制资源文件，跳过编译文件和可执行文件
-            if (ext == ".json" || ext == ".md" || ext == ".txt" || ext == ".yml" || ext == ".yaml") {
-                try {
-                    auto dest = output_dir + "/" + entry.path().filename().string();
-                    fs::copy_file(entry.path(), dest, fs::copy_options::overwrite_existing);
-                } catch (const std::exception& e) {
-                    // 忽略复制错误
-                }
-            }
+    // 复制非源文件，内容与上次相同且目标仍在时跳过
+    for (const auto& rel : assets) {
+        FileRecord& record = asset_records[rel];
+        fs::path source = fs::path(source_dir) / rel;
+        fs::path dest = fs::path(output_dir) / rel;
+        bool is_new = record.hash.empty();
+        if (!refresh_record(source, record) && !is_new && fs::exists(dest)) {
+            continue;
+        }
+        try {
+            fs::create_directories(dest.parent_path());
+            fs::copy_file(source, dest, fs::copy_options::overwrite_existing);
+            copied++;
+        } catch (const std::exception& e) {
+            // 忽略复制错误，下次构建重试
+            std::cerr << "    ⚠️  " << rel << ": " << e.what() << std::endl;
+            record.hash.clear();
         }
     }
     
+    // 源中已删除的资源从输出中移除
+    std::set<std::string> present(assets.begin(), assets.end());
+    for (auto it = asset_records.begin(); it != asset_records.end();) {
+        if (present.count(it->first)) {
+            ++it;
+            continue;
+        }
+        std::error_code ec;
+        fs::remove(fs::path(output_dir) / it->first, ec);
+        it = asset_records.erase(it);
+    }
+    
     return true;
 }
 
+std::string PackageBuilder::build_state_path() const {
+    return output_dir + "/.cardity-build.json";
+}
+
+void PackageBuilder::load_build_state() {
+    source_records.clear();
+    asset_records.clear();
+    
+    std::ifstream file(build_state_path());
+    if (!file.is_open()) {
+        return;    // 首次构建
+    }
+    try {
+        json state = json::parse(file);
+        if (state.value("version", 0) != BUILD_STATE_VERSION) {
+            return;
+        }
+        auto load = [](const json& entries, std::map<std::string, FileRecord>& records) {
+            for (auto it = entries.begin(); it != entries.end(); ++it) {
+                FileRecord record;
+                record.hash = it.value().value("hash", "");
+                record.size = it.value().value("size", uintmax_t(0));
+                record.mtime = it.value().value("mtime", 0LL);
+                record.module = it.value().value("module", "");
+                record.imports = it.value().value("imports", std::vector<std::string>());
+                records[it.key()] = record;
+            }
+        };
+        load(state.value("sources", json::object()), source_records);
+        load(state.value("assets", json::object()), asset_records);
+    } catch (const std::exception& e) {
+        // 记录损坏时退回全量构建
+        std::cerr << "⚠️  Ignoring corrupt build state: " << e.what() << std::endl;
+        source_records.clear();
+        asset_records.clear();
+    }
+}
+
+void PackageBuilder::save_build_state() const {
+    json state;
+    state["version"] = BUILD_STATE_VERSION;
+    state["sources"] = json::object();
+    for (const auto& [rel, record] : source_records) {
+        state["sources"][rel] = {
+            {"hash", record.hash},
+            {"size", record.size},
+            {"mtime", record.mtime},
+            {"module", record.module},
+            {"imports", record.imports}
+        };
+    }
+    state["assets"] = json::object();
+    for (const auto& [rel, record] : asset_records) {
+        state["assets"][rel] = {{"hash", record.hash}, {"size", record.size}, {"mtime", record.mtime}};
+    }
+    
+    std::string tmp = build_state_path() + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        file << state.dump(2);
+        file.close();
+        if (!file.good()) {
+            std::error_code ec;
+            fs::remove(tmp, ec);
+            throw std::runtime_error("Failed to write " + build_state_path());
+        }
+    }
+    fs::rename(tmp, build_state_path());
+}
+
 bool PackageBuilder::generate_metadata() {
     std::cout << "  Generating metadata..." << std::endl;
     
@@ -156,8 +493,45 @@ bool PackageBuilder::generate_metadata() {
 bool PackageBuilder::create_archive() {
     std::cout << "  Creating archive..." << std::endl;
     
-    // 这里应该创建 tar.gz 或 zip 文件
-    return true;
+    try {
+        auto started = std::chrono::steady_clock::now();
+        
+        PackageConfig package(source_dir + "/cardity.json");
+        package.load();
+        std::string name = package.get_name().empty() ? "package" : package.get_name();
+        std::string version = package.get_version().empty() ? "0.0.0" : package.get_version();
+        if (!name.empty() && name[0] == '@') name.erase(0, 1);
+        std::replace(name.begin(), name.end(), '/', '-');
+        std::string file_name = name + "-" + version + ".tar.gz";
+        
+        // 打包输出目录中的构建产物，跳过构建记录和根目录下的归档
+        std::vector<std::string> files;
+        for (const auto& entry : fs::recursive_directory_iterator(output_dir)) {
+            if (!entry.is_regular_file()) continue;
+            std::string rel = fs::relative(entry.path(), output_dir).generic_string();
+            bool at_root = rel.find('/') == std::string::npos;
+            if (at_root && (rel.rfind(".cardity-build.json", 0) == 0 ||
+                            entry.path().filename().string().find(".tar.gz") != std::string::npos)) {
+                continue;
+            }
+            files.push_back(rel);
+        }
+        
+        archive_file = output_dir + "/" + file_name;
+        PackageArchive::Result result = PackageArchive::write(output_dir, files, archive_file, jobs);
+        archive_hash = result.sha256;
+        
+        std::cout << "    📦 " << archive_file << " (" << result.entries << " file(s), " << result.size
+                  << " bytes, " << std::fixed << std::setprecision(1) << elapsed_ms(started) << " ms)" << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << "    sha256: " << archive_hash << std::endl;
+        return true;
+    } catch (const std::exception& e) {
+        archive_file.clear();
+        archive_hash.clear();
+        std::cerr << "    " << e.what() << std::endl;
+        return false;
+    }
 }
 
 bool PackageBuilder::run_tests() {
@@ -1,46 +1,39 @@
 #include "package_manager.h"
+#include "dependency_solver.h"
+#include "content_store.h"
+#include "http_client.h"
+#include "byte_channel.h"
+#include "installed_db.h"
+#include "metadata_cache.h"
+#include "registry_index.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <curl/curl.h>
-#include <archive.h>
-#include <archive_entry.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
 
 namespace cardity {
 
-// 辅助函数
-static size_t copy_data(struct archive* ar, struct archive* aw) {
-    int r;
-    const void* buff;
-    size_t size;
-    int64_t offset;
-    
-    for (;;) {
-        r = archive_read_data_block(ar, &buff, &size, &offset);
-        if (r == ARCHIVE_EOF)
-            return ARCHIVE_OK;
-        if (r < ARCHIVE_OK)
-            return r;
-        r = archive_write_data_block(aw, buff, size, offset);
-        if (r < ARCHIVE_OK) {
-            return r;
-        }
-    }
-}
-
 // PackageManager 实现
 PackageManager::PackageManager() 
     : registry_url("https://registry.cardity.dev"), 
       cache_dir("./.cardity/cache"),
-      packages_dir("./.cardity/packages") {
+      packages_dir("./.cardity/packages"),
+      store_dir(ContentStore::default_root("./.cardity/store")) {
     initialize();
 }
 
 PackageManager::PackageManager(const std::string& registry, const std::string& cache)
     : registry_url(registry), 
       cache_dir(cache + "/cache"),
-      packages_dir(cache + "/packages") {
+      packages_dir(cache + "/packages"),
+      store_dir(ContentStore::default_root(cache + "/store")) {
     initialize();
 }
 
@@ -48,12 +41,23 @@ void PackageManager::initialize() {
     // 创建必要的目录
     fs::create_directories(cache_dir);
     fs::create_directories(packages_dir);
-    
-    // 初始化 CURL
-    curl_global_init(CURL_GLOBAL_DEFAULT);
-    
-    // 加载已安装的包信息
-    load_installed_packages();
+    metadata_cache = std::make_shared<MetadataCache>(cache_dir + "/metadata");
+}
+
+InstalledDb& PackageManager::installed() {
+    if (!installed_db) {
+        installed_db = std::make_shared<InstalledDb>(cache_dir + "/installed.db");
+        
+        // 旧版 installed_packages.json 一次性导入；解析失败时保留原文件，不写空数据库
+        std::string legacy = cache_dir + "/installed_packages.json";
+        std::vector<PackageInfo> packages;
+        if (!installed_db->exists() && fs::exists(legacy) && load_legacy_installed_packages(legacy, packages)) {
+            installed_db->replace_all(std::move(packages));
+            std::error_code ec;
+            fs::rename(legacy, legacy + ".bak", ec);
+        }
+    }
+    return *installed_db;
 }
 
 bool PackageManager::install_package(const std::string& package_name, const std::string& version) {
@@ -66,108 +70,284 @@ bool PackageManager::install_package(const std::string& package_name, const std:
             return true;
         }
         
-        // 获取包元数据
-        json metadata = fetch_package_metadata(package_name);
-        if (metadata.empty()) {
-            std::cerr << "❌ Package not found: " << package_name << std::endl;
+        // 先构建完整依赖图，再并行安装
+        if (!install_with_dependencies({Dependency(package_name, version)})) {
+            std::cerr << "❌ Failed to install package: " << package_name << std::endl;
             return false;
         }
         
-        // 确定版本
-        std::string target_version = version;
-        if (version == "latest") {
-            target_version = metadata["latest"];
-        }
+        std::cout << "✅ Package installed successfully: " << package_name << "@"
+                  << get_package_info(package_name).version << std::endl;
+        return true;
         
-        // 下载包
-        if (!download_package(package_name, target_version)) {
-            std::cerr << "❌ Failed to download package: " << package_name << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error installing package: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool PackageManager::install_with_dependencies(std::vector<Dependency> roots, DependencyGraph* resolved) {
+    while (!roots.empty()) {
+        DependencyGraph full = resolve_dependency_graph(roots);
+        if (!install_dependency_graph(pending_installs(full))) {
             return false;
         }
         
-        // 解压包
-        std::string archive_path = cache_dir + "/" + package_name + "-" + target_version + ".tar.gz";
-        std::string extract_path = packages_dir + "/" + package_name;
-        
-        if (!extract_package(archive_path, extract_path)) {
-            std::cerr << "❌ Failed to extract package: " << package_name << std::endl;
-            return false;
+        // 注册表元数据未列出、但包内 cardity.json 声明的依赖：再补一轮
+        roots.clear();
+        std::unordered_set<std::string> queued;
+        for (auto& [name, node] : full.nodes) {
+            PackageInfo info = installed().get(name).value_or(PackageInfo());
+            if (node.sha256.empty()) node.sha256 = info.hash;
+            for (const auto& dep : info.dependencies) {
+                if (!package_exists(dep) && queued.insert(dep).second) {
+                    roots.push_back(Dependency(dep, "latest"));
+                }
+            }
+        }
+        if (resolved) {
+            for (auto& [name, node] : full.nodes) {
+                resolved->nodes[name] = std::move(node);
+            }
+        }
+    }
+    return true;
+}
+
+DependencyGraph PackageManager::resolve_dependency_graph(const std::vector<Dependency>& roots) {
+    DependencySolver solver([this](const std::string& name) { return fetch_package_metadata_async(name); },
+                            install_jobs);
+    std::unordered_map<std::string, std::string> preferred;
+    for (const auto& info : installed().all()) {
+        preferred[info.name] = info.version;
+    }
+    solver.set_preferred(preferred);
+    return solver.solve(roots);
+}
+
+DependencyGraph PackageManager::build_dependency_graph(const std::vector<Dependency>& roots) {
+    return pending_installs(resolve_dependency_graph(roots));
+}
+
+DependencyGraph PackageManager::pending_installs(const DependencyGraph& graph) {
+    DependencyGraph pending;
+    for (const auto& name : graph.order) {
+        auto installed_info = installed().get(name);
+        const PackageNode& node = graph.nodes.at(name);
+        if (installed_info && installed_info->version == node.version) {
+            continue;
+        }
+        pending.nodes[name] = node;
+        pending.order.push_back(name);
+    }
+    return pending;
+}
+
+bool PackageManager::install_project(const std::string& config_path, const std::string& lock_path) {
+    try {
+        PackageConfig config(config_path);
+        std::vector<Dependency> deps = config.get_dependencies();
+        std::string fingerprint = LockFile::fingerprint(deps);
+        
+        LockFile lock;
+        if (LockFile::read(lock_path, lock) && lock.requires_hash == fingerprint) {
+            std::cout << "🔒 Installing from " << lock_path << " (" << lock.graph.order.size()
+                      << " package(s), no metadata resolution)" << std::endl;
+            return install_dependency_graph(pending_installs(lock.graph));
         }
         
-        // 验证包
-        if (!validate_package(extract_path)) {
-            std::cerr << "❌ Invalid package: " << package_name << std::endl;
+        DependencyGraph resolved;
+        if (!install_with_dependencies(deps, &resolved)) {
             return false;
         }
+        lock.requires_hash = fingerprint;
+        lock.graph = std::move(resolved);
+        if (!lock.write(lock_path)) {
+            std::cerr << "⚠️  Failed to write " << lock_path << std::endl;
+        } else {
+            std::cout << "🔒 Wrote " << lock_path << " (" << lock.graph.nodes.size() << " package(s))" << std::endl;
+        }
+        return true;
         
-        // 安装依赖
-        PackageInfo pkg_info = get_package_info(package_name);
-        if (!pkg_info.dependencies.empty()) {
-            std::cout << "📋 Installing dependencies..." << std::endl;
-            std::vector<Dependency> deps;
-            for (const auto& dep : pkg_info.dependencies) {
-                deps.push_back(Dependency(dep, "latest"));
+    } catch (const std::exception& e) {
+        std::cerr << "❌ Error installing dependencies: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool PackageManager::install_dependency_graph(const DependencyGraph& graph) {
+    size_t total = graph.order.size();
+    if (total == 0) {
+        return true;
+    }
+    
+    // 入度 = 图中尚未安装的直接依赖数
+    std::unordered_map<std::string, size_t> pending;
+    std::unordered_map<std::string, std::vector<std::string>> dependents;
+    for (const auto& name : graph.order) {
+        size_t count = 0;
+        for (const auto& dep : graph.nodes.at(name).dependencies) {
+            if (graph.nodes.count(dep.name)) {
+                ++count;
+                dependents[dep.name].push_back(name);
             }
-            resolve_dependencies(deps);
         }
-        
-        // 更新已安装包列表
-        installed_packages[package_name] = pkg_info;
-        save_installed_packages();
-        
-        std::cout << "✅ Package installed successfully: " << package_name << "@" << target_version << std::endl;
+        pending[name] = count;
+    }
+    std::deque<std::string> ready;
+    for (const auto& name : graph.order) {
+        if (pending[name] == 0) ready.push_back(name);
+    }
+    
+    std::cout << "📋 Installing " << total << " package(s) with up to " << install_jobs << " worker(s)..." << std::endl;
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t active = 0;
+    size_t started = 0;
+    size_t finished = 0;
+    bool failed = false;
+    
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            cv.wait(lock, [&] { return failed || !ready.empty() || active == 0; });
+            if (failed || ready.empty()) {
+                return;
+            }
+            std::string name = ready.front();
+            ready.pop_front();
+            const PackageNode& node = graph.nodes.at(name);
+            ++active;
+            std::cout << "📥 [" << ++started << "/" << total << "] " << name << "@" << node.version << std::endl;
+            lock.unlock();
+            
+            PackageInfo info;
+            std::string error;
+            bool ok = install_node(node, info, error);
+            
+            lock.lock();
+            --active;
+            if (ok) {
+                try {
+                    installed().put(info);
+                } catch (const std::exception& e) {
+                    error = e.what();
+                    ok = false;
+                }
+            }
+            if (ok) {
+                std::cout << "✅ [" << ++finished << "/" << total << "] " << name << "@" << node.version << std::endl;
+                for (const auto& dependent : dependents[name]) {
+                    if (--pending[dependent] == 0) ready.push_back(dependent);
+                }
+            } else {
+                std::cerr << "❌ " << name << "@" << node.version << ": " << error << std::endl;
+                failed = true;
+            }
+            cv.notify_all();
+        }
+    };
+    unsigned workers = static_cast<unsigned>(std::min<size_t>(install_jobs, total));
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < workers; ++t) threads.emplace_back(worker);
+    worker();
+    for (auto& th : threads) th.join();
+    
+    // 每个包装好时已写入数据库，即使整体失败，下次安装也会跳过它们
+    return !failed && finished == total;
+}
+
+bool PackageManager::is_valid_package_name(const std::string& name) {
+    auto valid_part = [](const std::string& part) {
+        if (part.empty() || part == "." || part == "..") return false;
+        for (char c : part) {
+            bool ok = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '-';
+            if (!ok) return false;
+        }
         return true;
-        
+    };
+    if (name.empty() || name[0] != '@') {
+        return valid_part(name);
+    }
+    size_t slash = name.find('/');
+    return slash != std::string::npos && valid_part(name.substr(1, slash - 1)) && valid_part(name.substr(slash + 1));
+}
+
+std::string PackageManager::package_dir(const std::string& package_name) const {
+    if (!is_valid_package_name(package_name)) {
+        throw std::runtime_error("Invalid package name: \"" + package_name + "\"");
+    }
+    // 名称已排除 ".." 与绝对路径；再按解析后的路径确认，防止 packages_dir 内的符号链接指向外部
+    fs::path root = fs::weakly_canonical(packages_dir);
+    fs::path dest = fs::weakly_canonical(fs::path(packages_dir) / package_name);
+    auto mismatch = std::mismatch(root.begin(), root.end(), dest.begin(), dest.end());
+    if (mismatch.first != root.end() || dest == root) {
+        throw std::runtime_error("Package path escapes " + packages_dir + ": " + package_name);
+    }
+    return packages_dir + "/" + package_name;
+}
+
+bool PackageManager::install_node(const PackageNode& node, PackageInfo& info, std::string& error) {
+    StoreManifest manifest;
+    std::string extract_path;
+    try {
+        extract_path = package_dir(node.name);
+        // 已入库的归档直接链接，不再下载/解压/校验；锁文件给出哈希时按哈希查找
+        ContentStore store(store_dir);
+        bool stored = node.sha256.empty() ? store.lookup_package(node.name, node.version, manifest)
+                                          : store.lookup(node.sha256, manifest);
+        if (!stored) {
+            if (offline) {
+                error = "not in the package store (offline)";
+                return false;
+            }
+            std::string url = registry_url + "/packages/" + node.name + "/" + node.version + "/download";
+            if (!fetch_into_store(store, url, node.sha256, manifest, error)) {
+                return false;
+            }
+            store.record_package(node.name, node.version, manifest.sha256);
+        }
+        // 换版本时 link_into 会先清掉旧文件
+        store.link_into(manifest, extract_path);
     } catch (const std::exception& e) {
-        std::cerr << "❌ Error installing package: " << e.what() << std::endl;
+        error = e.what();
         return false;
     }
+    if (!validate_package(extract_path)) {
+        error = "invalid package";
+        return false;
+    }
+    
+    info = read_package_info(extract_path);
+    info.name = node.name;
+    info.version = node.version;
+    info.source = "registry";
+    info.hash = manifest.sha256;
+    return true;
 }
 
 bool PackageManager::install_package_from_url(const std::string& url, const std::string& version) {
     try {
         std::cout << "📦 Installing package from URL: " << url << std::endl;
+        if (offline) {
+            std::cerr << "❌ Cannot download " << url << " in offline mode" << std::endl;
+            return false;
+        }
         
         // 解析包名
         size_t last_slash = url.find_last_of('/');
         std::string package_name = url.substr(last_slash + 1);
-        
-        // 下载包
-        std::string download_path = cache_dir + "/" + package_name + ".tar.gz";
-        
-        CURL* curl = curl_easy_init();
-        if (!curl) {
-            std::cerr << "❌ Failed to initialize CURL" << std::endl;
-            return false;
-        }
-        
-        FILE* fp = fopen(download_path.c_str(), "wb");
-        if (!fp) {
-            std::cerr << "❌ Failed to create download file" << std::endl;
-            curl_easy_cleanup(curl);
-            return false;
-        }
-        
-        curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, NULL);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-        
-        CURLcode res = curl_easy_perform(curl);
-        fclose(fp);
-        curl_easy_cleanup(curl);
-        
-        if (res != CURLE_OK) {
-            std::cerr << "❌ Failed to download package: " << curl_easy_strerror(res) << std::endl;
-            return false;
-        }
-        
-        // 解压并安装
-        std::string extract_path = packages_dir + "/" + package_name;
-        if (!extract_package(download_path, extract_path)) {
-            std::cerr << "❌ Failed to extract package" << std::endl;
+        std::string extract_path = package_dir(package_name);
+        
+        // 边下载边解压入库，再链接到包目录
+        ContentStore store(store_dir);
+        StoreManifest manifest;
+        std::string error;
+        if (!fetch_into_store(store, url, "", manifest, error)) {
+            std::cerr << "❌ Failed to download package: " << error << std::endl;
             return false;
         }
+        store.link_into(manifest, extract_path);
         
         // 验证和安装
         if (!validate_package(extract_path)) {
@@ -180,8 +360,8 @@ bool PackageManager::install_package_from_url(const std::string& url, const std:
         pkg_info.name = package_name;
         pkg_info.version = version;
         pkg_info.source = url;
-        installed_packages[package_name] = pkg_info;
-        save_installed_packages();
+        pkg_info.hash = manifest.sha256;
+        installed().put(pkg_info);
         
         std::cout << "✅ Package installed successfully from URL" << std::endl;
         return true;
@@ -215,7 +395,7 @@ bool PackageManager::install_package_from_local(const std::string& path) {
         std::string version = config["version"];
         
         // 复制包到安装目录
-        std::string install_path = packages_dir + "/" + package_name;
+        std::string install_path = package_dir(package_name);
         fs::create_directories(install_path);
         
         // 复制所有文件
@@ -240,8 +420,7 @@ bool PackageManager::install_package_from_local(const std::string& path) {
         pkg_info.name = package_name;
         pkg_info.version = version;
         pkg_info.source = "local";
-        installed_packages[package_name] = pkg_info;
-        save_installed_packages();
+        installed().put(pkg_info);
         
         std::cout << "✅ Package installed successfully from local path" << std::endl;
         return true;
@@ -262,12 +441,10 @@ bool PackageManager::uninstall_package(const std::string& package_name) {
         }
         
         // 删除包目录
-        std::string package_path = packages_dir + "/" + package_name;
-        fs::remove_all(package_path);
+        fs::remove_all(package_dir(package_name));
         
         // 从已安装包列表中移除
-        installed_packages.erase(package_name);
-        save_installed_packages();
+        installed().remove(package_name);
         
         std::cout << "✅ Package uninstalled successfully: " << package_name << std::endl;
         return true;
@@ -279,48 +456,69 @@ bool PackageManager::uninstall_package(const std::string& package_name) {
 }
 
 std::vector<PackageInfo> PackageManager::list_installed_packages() {
-    std::vector<PackageInfo> packages;
-    for (const auto& pair : installed_packages) {
-        packages.push_back(pair.second);
-    }
-    return packages;
+    return installed().all();
 }
 
 bool PackageManager::package_exists(const std::string& package_name) {
-    return installed_packages.find(package_name) != installed_packages.end();
+    return installed().contains(package_name);
 }
 
 PackageInfo PackageManager::get_package_info(const std::string& package_name) {
-    if (package_exists(package_name)) {
-        return installed_packages[package_name];
+    if (auto info = installed().get(package_name)) {
+        return *info;
     }
     
     // 尝试从包目录读取信息
-    std::string package_path = packages_dir + "/" + package_name;
+    return read_package_info(packages_dir + "/" + package_name);
+}
+
+PackageInfo PackageManager::read_package_info(const std::string& package_path) {
     std::string config_path = package_path + "/cardity.json";
+    if (!fs::exists(config_path)) {
+        return PackageInfo();
+    }
     
-    if (fs::exists(config_path)) {
-        std::ifstream ifs(config_path);
-        json config = json::parse(ifs);
-        
-        PackageInfo info;
-        info.name = config["name"];
-        info.version = config["version"];
-        info.description = config.value("description", "");
-        info.author = config.value("author", "");
-        info.license = config.value("license", "");
-        info.repository = config.value("repository", "");
-        
-        if (config.contains("dependencies")) {
-            for (const auto& dep : config["dependencies"]) {
-                info.dependencies.push_back(dep);
-            }
+    std::ifstream ifs(config_path);
+    json config = json::parse(ifs);
+    
+    PackageInfo info;
+    info.name = config["name"];
+    info.version = config["version"];
+    info.description = config.value("description", "");
+    info.author = config.value("author", "");
+    info.license = config.value("license", "");
+    info.repository = config.value("repository", "");
+    
+    if (config.contains("dependencies")) {
+        for (const auto& dep : parse_dependencies(config["dependencies"])) {
+            info.dependencies.push_back(dep.name);
         }
-        
-        return info;
     }
     
-    return PackageInfo();
+    return info;
+}
+
+std::vector<Dependency> PackageManager::parse_dependencies(const json& deps) {
+    // 支持 {"name": "version"}、["name", ...] 与 [{"name", "version"}, ...]
+    std::vector<Dependency> result;
+    if (deps.is_object()) {
+        for (const auto& [name, version] : deps.items()) {
+            result.push_back(Dependency(name, version.is_string() ? version.get<std::string>() : "latest"));
+        }
+    } else if (deps.is_array()) {
+        for (const auto& dep : deps) {
+            if (dep.is_string()) {
+                result.push_back(Dependency(dep.get<std::string>(), "latest"));
+            } else if (dep.is_object() && dep.contains("name")) {
+                result.push_back(Dependency(dep["name"].get<std::string>(), dep.value("version", "latest")));
+            }
+        }
+    }
+    return result;
+}
+
+std::string PackageManager::calculate_package_hash(const std::string& package_path) {
+    return ContentStore::file_sha256(package_path);
 }
 
 std::string PackageManager::get_package_path(const std::string& package_name) {
@@ -386,184 +584,203 @@ std::string PackageManager::import_package(const std::string& package_name, cons
 }
 
 // 内部方法实现
-bool PackageManager::download_package(const std::string& package_name, const std::string& version) {
-    // 实现包下载逻辑
-    std::string download_url = registry_url + "/packages/" + package_name + "/" + version + "/download";
-    std::string download_path = cache_dir + "/" + package_name + "-" + version + ".tar.gz";
-    
-    CURL* curl = curl_easy_init();
-    if (!curl) {
+bool PackageManager::fetch_into_store(ContentStore& store, const std::string& url, const std::string& expected_sha256,
+                                      StoreManifest& manifest, std::string& error) {
+    // 下载流经有界缓冲区直接喂给解压，两者重叠进行；归档不落盘
+    auto channel = std::make_shared<ByteChannel>();
+    HttpRequest request;
+    request.url = url;
+    request.stream = channel;
+    std::future<HttpResponse> pending = HttpClient::instance().send(std::move(request));
+    try {
+        manifest = store.ingest_stream(*channel, expected_sha256);
+    } catch (const std::exception& e) {
+        // 先取消通道：传输可能正因缓冲区已满而暂停，不取消就永远等不到结束
+        channel->cancel();
+        // 传输本身失败时报告传输错误，而不是随之而来的解压错误
+        HttpResponse response = pending.get();
+        if (!response.error.empty() || response.status >= 300) {
+            error = "download failed: " +
+                    (response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error);
+        } else {
+            error = e.what();
+        }
         return false;
     }
-    
-    FILE* fp = fopen(download_path.c_str(), "wb");
-    if (!fp) {
-        curl_easy_cleanup(curl);
+    pending.get();
+    return true;
+}
+
+json PackageManager::fetch_package_metadata(const std::string& package_name) {
+    return fetch_package_metadata_async(package_name).get();
+}
+
+std::future<json> PackageManager::fetch_package_metadata_async(const std::string& package_name) {
+    return metadata_cache->fetch(registry_url + "/packages/" + package_name);
+}
+
+bool PackageManager::load_legacy_installed_packages(const std::string& path, std::vector<PackageInfo>& packages) {
+    packages.clear();
+    try {
+        std::ifstream ifs(path);
+        json data = json::parse(ifs);
+        
+        for (const auto& item : data) {
+            PackageInfo info;
+            info.name = item["name"];
+            info.version = item["version"];
+            info.description = item.value("description", "");
+            info.author = item.value("author", "");
+            info.license = item.value("license", "");
+            info.repository = item.value("repository", "");
+            info.hash = item.value("hash", "");
+            
+            if (item.contains("dependencies")) {
+                for (const auto& dep : item["dependencies"]) {
+                    info.dependencies.push_back(dep);
+                }
+            }
+            
+            packages.push_back(info);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to load installed packages from " << path << " (left in place): "
+                  << e.what() << std::endl;
+        packages.clear();
         return false;
     }
+    return true;
+}
+
+std::vector<PackageInfo> PackageManager::search_packages(const std::string& query) {
+    std::vector<PackageInfo> result;
+    std::string path = search_index_path();
     
-    curl_easy_setopt(curl, CURLOPT_URL, download_url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, NULL);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    
-    CURLcode res = curl_easy_perform(curl);
-    fclose(fp);
-    curl_easy_cleanup(curl);
+    std::error_code ec;
+    auto modified = fs::last_write_time(path, ec);
+    bool stale = ec || fs::file_time_type::clock::now() - modified > std::chrono::seconds(metadata_cache->ttl());
+    if (stale && !offline) {
+        update_search_index();
+    }
     
-    return res == CURLE_OK;
+    RegistryIndex index;
+    if (!index.open(path)) {
+        std::cerr << "⚠️  No local search index" << (offline ? " (offline)" : "") << std::endl;
+        return result;
+    }
+    for (const auto& package : index.search(query)) {
+        PackageInfo info(package.name, package.version);
+        info.description = package.description;
+        info.source = "registry";
+        result.push_back(std::move(info));
+    }
+    return result;
 }
 
-bool PackageManager::extract_package(const std::string& archive_path, const std::string& extract_path) {
-    struct archive* a = archive_read_new();
-    struct archive* ext = archive_write_disk_new();
-    struct archive_entry* entry;
-    int r;
-    
-    archive_read_support_filter_gzip(a);
-    archive_read_support_format_tar(a);
-    archive_write_disk_set_options(ext, ARCHIVE_EXTRACT_TIME);
+std::string PackageManager::search_index_path() const {
+    return cache_dir + "/registry.idx";
+}
+
+bool PackageManager::update_search_index() {
+    static constexpr size_t PAGE_SIZE = 1000;
+    std::string path = search_index_path();
     
-    if ((r = archive_read_open_filename(a, archive_path.c_str(), 10240))) {
-        archive_read_free(a);
-        archive_write_free(ext);
-        return false;
+    std::map<std::string, IndexedPackage> packages;
+    uint64_t since = 0;
+    {
+        RegistryIndex index;
+        if (index.open(path)) {
+            since = index.sequence();
+            for (auto& package : index.packages()) {
+                packages[package.name] = std::move(package);
+            }
+        }
     }
     
+    uint64_t sequence = since;
+    size_t changed = 0;
     for (;;) {
-        r = archive_read_next_header(a, &entry);
-        if (r == ARCHIVE_EOF)
-            break;
-        if (r < ARCHIVE_OK)
-            break;
-        
-        std::string entry_path = extract_path + "/" + archive_entry_pathname(entry);
-        archive_entry_set_pathname(entry, entry_path.c_str());
-        
-        r = archive_write_header(ext, entry);
-        if (r < ARCHIVE_OK) {
-            break;
+        HttpRequest request;
+        request.url = registry_url + "/-/index/changes?since=" + std::to_string(sequence) +
+                      "&limit=" + std::to_string(PAGE_SIZE);
+        HttpResponse response = HttpClient::instance().perform(std::move(request));
+        if (!response.ok()) {
+            std::cerr << "⚠️  Failed to sync search index: "
+                      << (response.error.empty() ? "HTTP " + std::to_string(response.status) : response.error)
+                      << std::endl;
+            return false;
         }
         
-        if (archive_entry_size(entry) > 0) {
-            r = copy_data(a, ext);
-            if (r < ARCHIVE_OK) {
-                break;
+        json page;
+        try {
+            page = json::parse(response.body);
+            for (const auto& change : page.at("changes")) {
+                std::string name = change.at("name").get<std::string>();
+                if (change.value("deleted", false)) {
+                    packages.erase(name);
+                } else {
+                    IndexedPackage& package = packages[name];
+                    package.name = name;
+                    package.version = change.value("version", "");
+                    package.description = change.value("description", "");
+                    package.keywords = change.value("keywords", std::vector<std::string>());
+                }
+                ++changed;
             }
+        } catch (const std::exception& e) {
+            std::cerr << "⚠️  Invalid search index response: " << e.what() << std::endl;
+            return false;
         }
         
-        r = archive_write_finish_entry(ext);
-        if (r < ARCHIVE_OK) {
-            break;
-        }
+        uint64_t last = page.value("last_seq", sequence);
+        bool done = page["changes"].size() < PAGE_SIZE || last <= sequence;
+        sequence = std::max(sequence, last);
+        if (done) break;
     }
     
-    archive_read_close(a);
-    archive_read_free(a);
-    archive_write_close(ext);
-    archive_write_free(ext);
-    
-    return r == ARCHIVE_OK;
-}
-
-json PackageManager::fetch_package_metadata(const std::string& package_name) {
-    std::string url = registry_url + "/packages/" + package_name;
-    
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        return json();
+    if (changed == 0 && fs::exists(path)) {
+        // 没有变化：只刷新时间戳
+        std::error_code ec;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+        return true;
     }
     
-    std::string response;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](void* contents, size_t size, size_t nmemb, std::string* userp) {
-        userp->append((char*)contents, size * nmemb);
-        return size * nmemb;
-    });
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK) {
-        return json();
+    std::vector<IndexedPackage> list;
+    list.reserve(packages.size());
+    for (auto& [name, package] : packages) {
+        list.push_back(std::move(package));
     }
-    
+    if (!RegistryIndex::write(path, sequence, std::move(list))) {
+        std::cerr << "⚠️  Failed to write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool PackageManager::resolve_dependencies(const std::vector<Dependency>& deps) {
     try {
-        return json::parse(response);
+        return install_with_dependencies(deps);
     } catch (const std::exception& e) {
-        return json();
+        std::cerr << "Failed to resolve dependencies: " << e.what() << std::endl;
+        return false;
     }
 }
 
-void PackageManager::load_installed_packages() {
-    std::string packages_file = cache_dir + "/installed_packages.json";
-    if (fs::exists(packages_file)) {
-        try {
-            std::ifstream ifs(packages_file);
-            json data = json::parse(ifs);
-            
-            for (const auto& item : data) {
-                PackageInfo info;
-                info.name = item["name"];
-                info.version = item["version"];
-                info.description = item.value("description", "");
-                info.author = item.value("author", "");
-                info.license = item.value("license", "");
-                info.repository = item.value("repository", "");
-                
-                if (item.contains("dependencies")) {
-                    for (const auto& dep : item["dependencies"]) {
-                        info.dependencies.push_back(dep);
-                    }
-                }
-                
-                installed_packages[info.name] = info;
-            }
-        } catch (const std::exception& e) {
-            std::cerr << "Warning: Failed to load installed packages: " << e.what() << std::endl;
-        }
-    }
+void PackageManager::set_store_directory(const std::string& path) {
+    store_dir = path;
 }
 
-void PackageManager::save_installed_packages() {
-    std::string packages_file = cache_dir + "/installed_packages.json";
-    json data = json::array();
-    
-    for (const auto& pair : installed_packages) {
-        json item;
-        item["name"] = pair.second.name;
-        item["version"] = pair.second.version;
-        item["description"] = pair.second.description;
-        item["author"] = pair.second.author;
-        item["license"] = pair.second.license;
-        item["repository"] = pair.second.repository;
-        item["dependencies"] = pair.second.dependencies;
-        
-        data.push_back(item);
-    }
-    
-    std::ofstream ofs(packages_file);
-    ofs << data.dump(2) << std::endl;
+void PackageManager::set_offline(bool enabled) {
+    offline = enabled;
+    metadata_cache->set_offline(enabled);
 }
 
-std::vector<PackageInfo> PackageManager::search_packages(const std::string& query) {
-    std::vector<PackageInfo> result;
-    
-    // 这里应该实现实际的搜索逻辑
-    // 简化实现：返回空结果
-    (void)query; // 避免未使用参数警告
-    return result;
+void PackageManager::set_metadata_ttl(long seconds) {
+    metadata_cache->set_ttl(seconds);
 }
 
-bool PackageManager::resolve_dependencies(const std::vector<Dependency>& deps) {
-    for (const auto& dep : deps) {
-        if (!install_package(dep.name, dep.version)) {
-            std::cerr << "Failed to install dependency: " << dep.name << std::endl;
-            return false;
-        }
-    }
-    return true;
+void PackageManager::set_concurrency(unsigned jobs) {
+    install_jobs = jobs ? jobs : std::max(1u, std::thread::hardware_concurrency());
 }
 
 bool PackageManager::update_package(const std::string& package_name) {
@@ -3,11 +3,19 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <nlohmann/json.hpp>
 #include <filesystem>
+#include <future>
+#include <memory>
 
 namespace cardity {
 
+class MetadataCache;
+class InstalledDb;
+class ContentStore;
+struct StoreManifest;
+
 using json = nlohmann::json;
 namespace fs = std::filesystem;
 
@@ -40,13 +48,31 @@ struct Dependency {
     Dependency(const std::string& n, const std::string& v) : name(n), version(v) {}
 };
 
+// 依赖图节点：解析后的具体版本及其直接依赖
+struct PackageNode {
+    std::string name;
+    std::string version;
+    std::vector<Dependency> dependencies;
+    std::string sha256;      // 归档 SHA-256；非空时安装前校验
+};
+
+// 完整依赖图；order 为拓扑序（依赖在前），已安装的包不在图中
+struct DependencyGraph {
+    std::unordered_map<std::string, PackageNode> nodes;
+    std::vector<std::string> order;
+};
+
 // 包管理器类
 class PackageManager {
 private:
     std::string registry_url;
     std::string cache_dir;
     std::string packages_dir;
-    std::unordered_map<std::string, PackageInfo> installed_packages;
+    std::string store_dir;    // 内容寻址的全局包存储，见 ContentStore
+    std::shared_ptr<MetadataCache> metadata_cache;
+    bool offline = false;
+    std::shared_ptr<InstalledDb> installed_db;    // 首次访问时才打开，见 installed()
+    unsigned install_jobs = 8;
     
 public:
     PackageManager();
@@ -69,12 +95,36 @@ public:
     
     // 包列表
     std::vector<PackageInfo> list_installed_packages();
+    // 在本地索引中搜索；索引过期（超过元数据 TTL）且非离线时先增量同步
     std::vector<PackageInfo> search_packages(const std::string& query);
     
+    // 从注册表变更流增量同步本地搜索索引：
+    //   GET /-/index/changes?since=<seq>&limit=<n>
+    //   -> {"last_seq": N, "changes": [{"seq", "name", "version", "description", "keywords", "deleted"}]}
+    bool update_search_index();
+    std::string search_index_path() const;
+    
     // 依赖管理
     bool resolve_dependencies(const std::vector<Dependency>& deps);
     std::vector<Dependency> get_package_dependencies(const std::string& package_name);
     
+    // 按 semver 范围求解完整依赖图（含已安装的包）；包不存在、版本冲突或循环依赖时抛异常
+    DependencyGraph resolve_dependency_graph(const std::vector<Dependency>& roots);
+    
+    // 求解后去掉已安装同版本的包，得到需要安装的部分
+    DependencyGraph build_dependency_graph(const std::vector<Dependency>& roots);
+    
+    // 安装项目依赖：锁文件与 cardity.json 一致时直接按锁文件安装（不请求元数据），
+    // 否则求解、安装并写出锁文件
+    bool install_project(const std::string& config_path = "cardity.json",
+                         const std::string& lock_path = "cardity.lock");
+    
+    // 按拓扑序并行下载/解压：一个包的依赖全部装好后才开始安装它
+    bool install_dependency_graph(const DependencyGraph& graph);
+    
+    // 元数据获取与下载/解压的并发上限；0 表示使用硬件并发数
+    void set_concurrency(unsigned jobs);
+    
     // 包信息
     PackageInfo get_package_info(const std::string& package_name);
     bool package_exists(const std::string& package_name);
@@ -97,19 +147,37 @@ public:
     // 获取包路径
     std::string get_package_path(const std::string& package_name);
     
+    // 依赖声明：支持 {"name": "range"}、["name", ...] 与 [{"name", "version"}, ...]
+    static std::vector<Dependency> parse_dependencies(const json& deps);
+    
+    // 包名只允许 [a-z0-9._-]，可带一个 @scope/ 前缀；"."、".." 与绝对路径都不合法
+    static bool is_valid_package_name(const std::string& name);
+    
     // 设置配置
     void set_registry_url(const std::string& url);
     void set_cache_directory(const std::string& path);
+    void set_store_directory(const std::string& path);
+    
+    // 离线模式：元数据只读缓存，归档只取自包存储
+    void set_offline(bool enabled);
+    void set_metadata_ttl(long seconds);
     
 private:
     // 内部方法
-    bool download_package(const std::string& package_name, const std::string& version);
-    bool extract_package(const std::string& archive_path, const std::string& extract_path);
+    bool install_with_dependencies(std::vector<Dependency> roots, DependencyGraph* resolved = nullptr);
+    bool install_node(const PackageNode& node, PackageInfo& info, std::string& error);
+    // 包的安装目录；名称不合法或解析后不在 packages_dir 之下时抛异常
+    std::string package_dir(const std::string& package_name) const;
+    DependencyGraph pending_installs(const DependencyGraph& graph);
+    PackageInfo read_package_info(const std::string& package_path);
+    bool fetch_into_store(ContentStore& store, const std::string& url, const std::string& expected_sha256,
+                          StoreManifest& manifest, std::string& error);
     json fetch_package_metadata(const std::string& package_name);
+    std::future<json> fetch_package_metadata_async(const std::string& package_name);
     bool verify_package_signature(const std::string& package_path, const std::string& signature);
     std::string generate_package_signature(const std::string& package_path, const std::string& private_key);
-    void load_installed_packages();
-    void save_installed_packages();
+    InstalledDb& installed();
+    static bool load_legacy_installed_packages(const std::string& path, std::vector<PackageInfo>& packages);
 };
 
 // 包配置文件管理器
@@ -162,18 +230,38 @@ private:
 // 包构建器
 class PackageBuilder {
 private:
+    // 增量构建记录：每个输入文件的内容哈希，源文件另记协议名与 import。
+    // 保存在 <output>/.cardity-build.json，下次构建只重做内容变化的部分
+    struct FileRecord {
+        std::string hash;
+        uintmax_t size = 0;
+        long long mtime = 0;
+        std::string module;
+        std::vector<std::string> imports;
+    };
+
     PackageConfig config;
     std::string source_dir;
     std::string output_dir;
+    unsigned jobs = 0;    // 0 表示按硬件线程数
+    std::map<std::string, FileRecord> source_records;    // 相对路径 -> 记录
+    std::map<std::string, FileRecord> asset_records;
+    std::string archive_file;       // 最近一次 create_archive 的产物
+    std::string archive_hash;
     
 public:
     PackageBuilder(const std::string& source, const std::string& output);
     
-    // 构建包
+    void set_jobs(unsigned count) { jobs = count; }
+    
+    // 构建包（增量）
     bool build();
-    bool build_for_distribution();
+    bool build_for_distribution();    // 构建并打包 <output>/<name>-<version>.tar.gz
     bool build_for_development();
     
+    const std::string& archive_path() const { return archive_file; }
+    const std::string& archive_sha256() const { return archive_hash; }
+    
     // 清理构建
     void clean();
     
@@ -187,42 +275,16 @@ public:
     bool publish(const std::string& api_key);
     
 private:
-    bool compile_sources();
-    bool copy_assets();
+    void scan_inputs(std::vector<std::string>& sources, std::vector<std::string>& assets);
+    bool compile_sources(const std::vector<std::string>& sources, size_t& compiled);
+    bool copy_assets(const std::vector<std::string>& assets, size_t& copied);
     bool generate_metadata();
+    void load_build_state();
+    void save_build_state() const;
+    std::string build_state_path() const;
     bool create_archive();
     bool run_tests();
 };
 
-// 包注册表客户端
-class RegistryClient {
-private:
-    std::string registry_url;
-    std::string api_key;
-    
-public:
-    RegistryClient(const std::string& url, const std::string& key = "");
-    
-    // 包查询
-    json search_packages(const std::string& query);
-    json get_package_info(const std::string& package_name);
-    json get_package_versions(const std::string& package_name);
-    
-    // 包下载
-    bool download_package(const std::string& package_name, const std::string& version, const std::string& output_path);
-    
-    // 包发布
-    bool publish_package(const std::string& package_path, const std::string& api_key);
-    bool unpublish_package(const std::string& package_name, const std::string& version, const std::string& api_key);
-    
-    // 用户管理
-    json login(const std::string& username, const std::string& password);
-    bool logout();
-    json get_user_info();
-    
-private:
-    json make_request(const std::string& endpoint, const std::string& method = "GET", const json& data = json());
-    std::string upload_file(const std::string& file_path);
-};
 
 } // namespace cardity 
\ No newline at end of file
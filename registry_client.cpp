@@ -2,63 +2,62 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
-#include <curl/curl.h>
+#include "http_client.h"
+#include "metadata_cache.h"
+#include "registry_index.h"
 
 namespace cardity {
 
 RegistryClient::RegistryClient(const std::string& url, const std::string& key) 
-    : registry_url(url), api_key(key) {
-    // 初始化 CURL
-    curl_global_init(CURL_GLOBAL_DEFAULT);
+    : registry_url(url), api_key(key) {}
+
+void RegistryClient::set_metadata_cache(std::shared_ptr<MetadataCache> cache) {
+    metadata_cache = std::move(cache);
+}
+
+void RegistryClient::set_search_index(const std::string& path) {
+    search_index = path;
 }
 
 json RegistryClient::search_packages(const std::string& query) {
+    RegistryIndex index;
+    if (!search_index.empty() && index.open(search_index)) {
+        json results = json::array();
+        for (const auto& package : index.search(query)) {
+            results.push_back({{"name", package.name},
+                               {"version", package.version},
+                               {"description", package.description},
+                               {"keywords", package.keywords}});
+        }
+        return results;
+    }
     std::string endpoint = "/search?q=" + query;
     return make_request(endpoint);
 }
 
 json RegistryClient::get_package_info(const std::string& package_name) {
     std::string endpoint = "/packages/" + package_name;
-    return make_request(endpoint);
+    return get_metadata(endpoint);
 }
 
 json RegistryClient::get_package_versions(const std::string& package_name) {
     std::string endpoint = "/packages/" + package_name + "/versions";
-    return make_request(endpoint);
+    return get_metadata(endpoint);
 }
 
 bool RegistryClient::download_package(const std::string& package_name, const std::string& version, const std::string& output_path) {
     std::string endpoint = "/packages/" + package_name + "/" + version + "/download";
     
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        return false;
-    }
-    
-    std::string url = registry_url + endpoint;
-    FILE* fp = fopen(output_path.c_str(), "wb");
-    if (!fp) {
-        curl_easy_cleanup(curl);
-        return false;
-    }
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, NULL);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, fp);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    HttpRequest request;
+    request.url = registry_url + endpoint;
+    request.output_path = output_path;
     
     // 添加认证头
     if (!api_key.empty()) {
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + api_key).c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        request.headers.push_back("Authorization: Bearer " + api_key);
     }
     
-    CURLcode res = curl_easy_perform(curl);
-    fclose(fp);
-    curl_easy_cleanup(curl);
-    
-    return res == CURLE_OK;
+    return HttpClient::instance().perform(std::move(request)).ok();
 }
 
 bool RegistryClient::publish_package(const std::string& package_path, const std::string& api_key) {
@@ -123,103 +122,65 @@ json RegistryClient::get_user_info() {
 }
 
 json RegistryClient::make_request(const std::string& endpoint, const std::string& method, const json& data) {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        return json();
-    }
-    
-    std::string url = registry_url + endpoint;
-    std::string response;
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](void* contents, size_t size, size_t nmemb, std::string* userp) {
-        userp->append((char*)contents, size * nmemb);
-        return size * nmemb;
-    });
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    
-    // 设置请求方法
-    if (method == "POST") {
-        curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    } else if (method == "DELETE") {
-        curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, "DELETE");
-    }
+    HttpRequest request;
+    request.url = registry_url + endpoint;
+    request.method = method;
     
     // 设置请求数据
     if (!data.empty()) {
-        std::string post_data = data.dump();
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, post_data.c_str());
-        
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, "Content-Type: application/json");
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        request.body = data.dump();
+        request.headers.push_back("Content-Type: application/json");
     }
     
     // 添加认证头
     if (!api_key.empty()) {
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + api_key).c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        request.headers.push_back("Authorization: Bearer " + api_key);
     }
     
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK) {
-        std::cerr << "Request failed: " << curl_easy_strerror(res) << std::endl;
+    HttpResponse response = HttpClient::instance().perform(std::move(request));
+    if (!response.error.empty()) {
+        std::cerr << "Request failed: " << response.error << std::endl;
         return json();
     }
     
     try {
-        return json::parse(response);
+        return json::parse(response.body);
     } catch (const std::exception& e) {
         std::cerr << "Failed to parse response: " << e.what() << std::endl;
         return json();
     }
 }
 
-std::string RegistryClient::upload_file(const std::string& file_path) {
-    CURL* curl = curl_easy_init();
-    if (!curl) {
-        return "";
+json RegistryClient::get_metadata(const std::string& endpoint) {
+    if (!metadata_cache) {
+        return make_request(endpoint);
     }
-    
-    std::string url = registry_url + "/upload";
-    std::string response;
-    
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_POST, 1L);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, +[](void* contents, size_t size, size_t nmemb, std::string* userp) {
-        userp->append((char*)contents, size * nmemb);
-        return size * nmemb;
-    });
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-    
-    // 设置文件上传
-    curl_mime* mime = curl_mime_init(curl);
-    curl_mimepart* part = curl_mime_addpart(mime);
-    curl_mime_name(part, "file");
-    curl_mime_filedata(part, file_path.c_str());
-    curl_easy_setopt(curl, CURLOPT_MIMEPOST, mime);
+    std::vector<std::string> headers;
+    if (!api_key.empty()) {
+        headers.push_back("Authorization: Bearer " + api_key);
+    }
+    return metadata_cache->get(registry_url + endpoint, headers);
+}
+
+std::string RegistryClient::upload_file(const std::string& file_path) {
+    HttpRequest request;
+    request.url = registry_url + "/upload";
+    request.method = "POST";
+    request.form_file = file_path;
     
     // 添加认证头
     if (!api_key.empty()) {
-        struct curl_slist* headers = NULL;
-        headers = curl_slist_append(headers, ("Authorization: Bearer " + api_key).c_str());
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+        request.headers.push_back("Authorization: Bearer " + api_key);
     }
     
-    CURLcode res = curl_easy_perform(curl);
-    curl_mime_free(mime);
-    curl_easy_cleanup(curl);
-    
-    if (res != CURLE_OK) {
-        std::cerr << "Upload failed: " << curl_easy_strerror(res) << std::endl;
+    HttpResponse response = HttpClient::instance().perform(std::move(request));
+    if (!response.error.empty()) {
+        std::cerr << "Upload failed: " << response.error << std::endl;
         return "";
     }
     
     try {
-        json response_json = json::parse(response);
+        json response_json = json::parse(response.body);
         if (response_json.contains("upload_url")) {
             return response_json["upload_url"].get<std::string>();
         }
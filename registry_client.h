@@ -1,21 +1,32 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include <nlohmann/json.hpp>
 
 namespace cardity {
 
 using json = nlohmann::json;
 
+class MetadataCache;
+
 // 包注册表客户端
 class RegistryClient {
 private:
     std::string registry_url;
     std::string api_key;
+    std::shared_ptr<MetadataCache> metadata_cache;
+    std::string search_index;
     
 public:
     RegistryClient(const std::string& url, const std::string& key = "");
     
+    // 设置后包信息/版本列表走条件请求缓存（可与 PackageManager 共用同一目录）
+    void set_metadata_cache(std::shared_ptr<MetadataCache> cache);
+    
+    // 设置后 search_packages 查本地索引（见 PackageManager::update_search_index），不再请求 /search
+    void set_search_index(const std::string& path);
+    
     // 包查询
     json search_packages(const std::string& query);
     json get_package_info(const std::string& package_name);
@@ -35,6 +46,7 @@ public:
     
 private:
     json make_request(const std::string& endpoint, const std::string& method = "GET", const json& data = json());
+    json get_metadata(const std::string& endpoint);
     std::string upload_file(const std::string& file_path);
 };
 
@@ -0,0 +1,482 @@
+#include "registry_index.h"
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <fstream>
+#include <string_view>
+#include <unordered_map>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace cardity {
+
+namespace {
+
+constexpr char MAGIC[8] = {'C', 'R', 'D', 'I', 'D', 'X', '1', '\0'};
+
+// 磁盘上的整数一律按小端逐字节编解码，与主机字节序无关；下面三个结构只是解码后的值
+struct Header {
+    char magic[8];
+    uint64_t sequence;
+    uint32_t package_count;
+    uint32_t term_count;
+    uint64_t packages_offset;
+    uint64_t terms_offset;
+    uint64_t postings_offset;
+    uint64_t postings_count;
+    uint64_t strings_offset;
+    uint64_t strings_size;
+};
+
+struct PackageRecord {
+    uint32_t name_offset, name_length;
+    uint32_t version_offset, version_length;
+    uint32_t description_offset, description_length;
+    uint32_t keywords_offset, keywords_length;    // 以 '\n' 连接
+};
+
+struct TermRecord {
+    uint32_t term_offset, term_length;
+    uint32_t postings_start, postings_count;
+};
+
+constexpr size_t HEADER_SIZE = 72;            // magic[8] + u64 + 2 × u32 + 6 × u64
+constexpr size_t PACKAGE_RECORD_SIZE = 32;    // 8 × u32
+constexpr size_t TERM_RECORD_SIZE = 16;       // 4 × u32
+constexpr size_t POSTING_SIZE = 4;            // u32
+
+constexpr uint32_t FIELD_NAME = 1u << 31;
+constexpr uint32_t FIELD_KEYWORD = 1u << 30;
+constexpr uint32_t FIELD_DESCRIPTION = 1u << 29;
+constexpr uint32_t ID_MASK = FIELD_DESCRIPTION - 1;
+
+void store_le(unsigned char* p, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) p[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+uint64_t load_le(const unsigned char* p, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(p[i]) << (8 * i);
+    return value;
+}
+
+uint32_t load_u32(const unsigned char* p) {
+    return static_cast<uint32_t>(load_le(p, 4));
+}
+
+Header read_header(const unsigned char* p) {
+    Header h;
+    std::memcpy(h.magic, p, sizeof(h.magic));
+    h.sequence = load_le(p + 8, 8);
+    h.package_count = load_u32(p + 16);
+    h.term_count = load_u32(p + 20);
+    h.packages_offset = load_le(p + 24, 8);
+    h.terms_offset = load_le(p + 32, 8);
+    h.postings_offset = load_le(p + 40, 8);
+    h.postings_count = load_le(p + 48, 8);
+    h.strings_offset = load_le(p + 56, 8);
+    h.strings_size = load_le(p + 64, 8);
+    return h;
+}
+
+void encode_header(unsigned char* p, const Header& h) {
+    std::memcpy(p, h.magic, sizeof(h.magic));
+    store_le(p + 8, h.sequence, 8);
+    store_le(p + 16, h.package_count, 4);
+    store_le(p + 20, h.term_count, 4);
+    store_le(p + 24, h.packages_offset, 8);
+    store_le(p + 32, h.terms_offset, 8);
+    store_le(p + 40, h.postings_offset, 8);
+    store_le(p + 48, h.postings_count, 8);
+    store_le(p + 56, h.strings_offset, 8);
+    store_le(p + 64, h.strings_size, 8);
+}
+
+PackageRecord read_package(const unsigned char* data, const Header& h, uint32_t id) {
+    const unsigned char* p = data + h.packages_offset + uint64_t(id) * PACKAGE_RECORD_SIZE;
+    return {load_u32(p), load_u32(p + 4), load_u32(p + 8), load_u32(p + 12),
+            load_u32(p + 16), load_u32(p + 20), load_u32(p + 24), load_u32(p + 28)};
+}
+
+void encode_package(unsigned char* p, const PackageRecord& r) {
+    const uint32_t fields[] = {r.name_offset, r.name_length, r.version_offset, r.version_length,
+                               r.description_offset, r.description_length, r.keywords_offset, r.keywords_length};
+    for (size_t i = 0; i < 8; ++i) store_le(p + 4 * i, fields[i], 4);
+}
+
+TermRecord read_term(const unsigned char* data, const Header& h, uint32_t i) {
+    const unsigned char* p = data + h.terms_offset + uint64_t(i) * TERM_RECORD_SIZE;
+    return {load_u32(p), load_u32(p + 4), load_u32(p + 8), load_u32(p + 12)};
+}
+
+void encode_term(unsigned char* p, const TermRecord& t) {
+    store_le(p, t.term_offset, 4);
+    store_le(p + 4, t.term_length, 4);
+    store_le(p + 8, t.postings_start, 4);
+    store_le(p + 12, t.postings_count, 4);
+}
+
+uint64_t align8(uint64_t n) {
+    return (n + 7) & ~uint64_t(7);
+}
+
+int field_score(uint32_t posting) {
+    int score = 0;
+    if (posting & FIELD_NAME) score += 10;
+    if (posting & FIELD_KEYWORD) score += 5;
+    if (posting & FIELD_DESCRIPTION) score += 1;
+    return score;
+}
+
+} // namespace
+
+RegistryIndex::~RegistryIndex() {
+    close();
+}
+
+void RegistryIndex::close() {
+    if (data_) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+bool RegistryIndex::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    data_ = static_cast<const unsigned char*>(mapped);
+    size_ = static_cast<size_t>(st.st_size);
+
+    // 校验各段都落在文件内，之后的访问不再逐一检查
+    // 偏移先与文件大小比较再相加，损坏的头部不会让校验本身溢出
+    Header h = read_header(data_);
+    auto fits = [&](uint64_t offset, uint64_t count, uint64_t unit) {
+        return offset <= size_ && count <= (size_ - offset) / unit;
+    };
+    bool valid = std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+                 fits(h.packages_offset, h.package_count, PACKAGE_RECORD_SIZE) &&
+                 fits(h.terms_offset, h.term_count, TERM_RECORD_SIZE) &&
+                 fits(h.postings_offset, h.postings_count, POSTING_SIZE) &&
+                 fits(h.strings_offset, h.strings_size, 1);
+    if (valid) {
+        for (uint32_t i = 0; valid && i < h.package_count; ++i) {
+            PackageRecord p = read_package(data_, h, i);
+            valid = uint64_t(p.name_offset) + p.name_length <= h.strings_size &&
+                    uint64_t(p.version_offset) + p.version_length <= h.strings_size &&
+                    uint64_t(p.description_offset) + p.description_length <= h.strings_size &&
+                    uint64_t(p.keywords_offset) + p.keywords_length <= h.strings_size;
+        }
+        for (uint32_t i = 0; valid && i < h.term_count; ++i) {
+            TermRecord t = read_term(data_, h, i);
+            valid = uint64_t(t.term_offset) + t.term_length <= h.strings_size &&
+                    uint64_t(t.postings_start) + t.postings_count <= h.postings_count;
+        }
+    }
+    if (!valid) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+uint64_t RegistryIndex::sequence() const {
+    return data_ ? read_header(data_).sequence : 0;
+}
+
+size_t RegistryIndex::size() const {
+    return data_ ? read_header(data_).package_count : 0;
+}
+
+std::string RegistryIndex::string_at(uint32_t offset, uint32_t length) const {
+    return std::string(reinterpret_cast<const char*>(data_ + read_header(data_).strings_offset + offset), length);
+}
+
+IndexedPackage RegistryIndex::package_at(uint32_t id) const {
+    PackageRecord p = read_package(data_, read_header(data_), id);
+    IndexedPackage package;
+    package.name = string_at(p.name_offset, p.name_length);
+    package.version = string_at(p.version_offset, p.version_length);
+    package.description = string_at(p.description_offset, p.description_length);
+    std::string keywords = string_at(p.keywords_offset, p.keywords_length);
+    size_t start = 0;
+    while (start < keywords.size()) {
+        size_t end = keywords.find('\n', start);
+        if (end == std::string::npos) end = keywords.size();
+        package.keywords.push_back(keywords.substr(start, end - start));
+        start = end + 1;
+    }
+    return package;
+}
+
+std::vector<IndexedPackage> RegistryIndex::packages() const {
+    std::vector<IndexedPackage> result;
+    for (uint32_t i = 0; i < size(); ++i) {
+        result.push_back(package_at(i));
+    }
+    return result;
+}
+
+std::vector<std::string> RegistryIndex::tokenize(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::string current;
+    for (unsigned char c : text) {
+        if (std::isalnum(c) || c >= 0x80) {
+            current += static_cast<char>(std::tolower(c));
+        } else if (!current.empty()) {
+            tokens.push_back(std::move(current));
+            current.clear();
+        }
+    }
+    if (!current.empty()) tokens.push_back(std::move(current));
+    return tokens;
+}
+
+std::vector<IndexedPackage> RegistryIndex::search(const std::string& query, size_t limit) const {
+    std::vector<IndexedPackage> result;
+    std::vector<std::string> words = tokenize(query);
+    if (!data_ || words.empty()) {
+        return result;
+    }
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    const Header h = read_header(data_);
+    const unsigned char* postings = data_ + h.postings_offset;
+    const char* strings = reinterpret_cast<const char*>(data_ + h.strings_offset);
+    auto term_at = [&](uint32_t i) { return read_term(data_, h, i); };
+    auto posting_at = [&](uint64_t i) { return load_u32(postings + i * POSTING_SIZE); };
+    auto term_text = [&](const TermRecord& t) { return std::string_view(strings + t.term_offset, t.term_length); };
+
+    // 每个词对应词表中一段连续的前缀匹配区间 [begin, end)
+    struct WordMatch {
+        uint32_t begin;
+        uint32_t end;
+        size_t exact_length;
+        uint64_t postings = 0;
+    };
+    std::vector<WordMatch> matches;
+    for (const auto& word : words) {
+        WordMatch m;
+        uint32_t lo = 0, hi = h.term_count;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (term_text(term_at(mid)) < word) lo = mid + 1;
+            else hi = mid;
+        }
+        m.begin = m.end = lo;
+        for (; m.end != h.term_count; ++m.end) {
+            TermRecord t = term_at(m.end);
+            if (term_text(t).compare(0, word.size(), word) != 0) break;
+            m.postings += t.postings_count;
+        }
+        if (m.begin == m.end) {
+            return result;
+        }
+        m.exact_length = word.size();
+        matches.push_back(m);
+    }
+    // 从最短的 posting 集合开始求交集
+    std::sort(matches.begin(), matches.end(),
+              [](const WordMatch& a, const WordMatch& b) { return a.postings < b.postings; });
+
+    auto posting_score = [&](const TermRecord& t, uint32_t posting, size_t exact_length) {
+        return field_score(posting) * (t.term_length == exact_length ? 2 : 1);    // 完整词优先于前缀
+    };
+
+    // 候选：(包序号, 得分)，按序号有序；同一包取各匹配词条中的最高分
+    std::vector<std::pair<uint32_t, int>> candidates;
+    {
+        const WordMatch& m = matches.front();
+        for (uint32_t ti = m.begin; ti != m.end; ++ti) {
+            TermRecord t = term_at(ti);
+            for (uint32_t i = 0; i < t.postings_count; ++i) {
+                uint32_t posting = posting_at(uint64_t(t.postings_start) + i);
+                if ((posting & ID_MASK) >= h.package_count) continue;
+                candidates.emplace_back(posting & ID_MASK, posting_score(t, posting, m.exact_length));
+            }
+        }
+        if (m.end - m.begin > 1) {
+            std::sort(candidates.begin(), candidates.end());
+            size_t out = 0;
+            for (size_t i = 0; i < candidates.size(); ++i) {
+                if (out > 0 && candidates[out - 1].first == candidates[i].first) {
+                    candidates[out - 1].second = std::max(candidates[out - 1].second, candidates[i].second);
+                } else {
+                    candidates[out++] = candidates[i];
+                }
+            }
+            candidates.resize(out);
+        }
+    }
+
+    // 其余词：单个词条且候选较多时顺序归并，否则在各词条的有序 posting 中二分查找每个候选
+    for (size_t w = 1; w < matches.size() && !candidates.empty(); ++w) {
+        const WordMatch& m = matches[w];
+        size_t out = 0;
+        if (m.end - m.begin == 1 && candidates.size() * 16 > m.postings) {
+            TermRecord t = term_at(m.begin);
+            uint64_t p = t.postings_start;
+            uint64_t last = p + t.postings_count;
+            for (const auto& [id, score] : candidates) {
+                while (p != last && (posting_at(p) & ID_MASK) < id) ++p;
+                if (p == last) break;
+                uint32_t posting = posting_at(p);
+                if ((posting & ID_MASK) == id) {
+                    candidates[out++] = {id, score + posting_score(t, posting, m.exact_length)};
+                }
+            }
+            candidates.resize(out);
+            continue;
+        }
+        for (const auto& [id, score] : candidates) {
+            int best = 0;
+            for (uint32_t ti = m.begin; ti != m.end; ++ti) {
+                TermRecord t = term_at(ti);
+                uint64_t lo = t.postings_start, hi = lo + t.postings_count;
+                while (lo < hi) {
+                    uint64_t mid = lo + (hi - lo) / 2;
+                    if ((posting_at(mid) & ID_MASK) < id) lo = mid + 1;
+                    else hi = mid;
+                }
+                if (lo != uint64_t(t.postings_start) + t.postings_count && (posting_at(lo) & ID_MASK) == id) {
+                    best = std::max(best, posting_score(t, posting_at(lo), m.exact_length));
+                }
+            }
+            if (best > 0) {
+                candidates[out++] = {id, score + best};
+            }
+        }
+        candidates.resize(out);
+    }
+
+    size_t count = std::min(limit, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+                      [](const auto& a, const auto& b) {
+                          return a.second != b.second ? a.second > b.second : a.first < b.first;
+                      });
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t id = candidates[i].first;
+        result.push_back(package_at(id));
+    }
+    return result;
+}
+
+bool RegistryIndex::write(const std::string& path, uint64_t sequence, std::vector<IndexedPackage> packages) {
+    std::sort(packages.begin(), packages.end(),
+              [](const IndexedPackage& a, const IndexedPackage& b) { return a.name < b.name; });
+    if (packages.size() > ID_MASK) {
+        return false;
+    }
+
+    std::string strings;
+    auto add_string = [&](const std::string& s, uint32_t& offset, uint32_t& length) {
+        offset = static_cast<uint32_t>(strings.size());
+        length = static_cast<uint32_t>(s.size());
+        strings += s;
+    };
+
+    // 词 -> (包序号 | 字段标记)；包按序处理，同一包的多次出现合并到最后一条
+    std::unordered_map<std::string, std::vector<uint32_t>> term_postings;
+    auto index_text = [&](const std::string& text, uint32_t id, uint32_t field) {
+        for (const auto& token : tokenize(text)) {
+            auto& list = term_postings[token];
+            if (!list.empty() && (list.back() & ID_MASK) == id) list.back() |= field;
+            else list.push_back(id | field);
+        }
+    };
+
+    std::vector<PackageRecord> records(packages.size());
+    for (uint32_t id = 0; id < packages.size(); ++id) {
+        const IndexedPackage& p = packages[id];
+        std::string keywords;
+        for (size_t i = 0; i < p.keywords.size(); ++i) {
+            if (i) keywords += '\n';
+            keywords += p.keywords[i];
+        }
+        PackageRecord& r = records[id];
+        add_string(p.name, r.name_offset, r.name_length);
+        add_string(p.version, r.version_offset, r.version_length);
+        add_string(p.description, r.description_offset, r.description_length);
+        add_string(keywords, r.keywords_offset, r.keywords_length);
+
+        index_text(p.name, id, FIELD_NAME);
+        for (const auto& keyword : p.keywords) index_text(keyword, id, FIELD_KEYWORD);
+        index_text(p.description, id, FIELD_DESCRIPTION);
+    }
+
+    std::vector<std::string> words;
+    words.reserve(term_postings.size());
+    for (const auto& entry : term_postings) words.push_back(entry.first);
+    std::sort(words.begin(), words.end());
+
+    std::vector<TermRecord> terms(words.size());
+    std::vector<uint32_t> postings;
+    for (size_t i = 0; i < words.size(); ++i) {
+        const auto& list = term_postings[words[i]];
+        TermRecord& t = terms[i];
+        add_string(words[i], t.term_offset, t.term_length);
+        t.postings_start = static_cast<uint32_t>(postings.size());
+        t.postings_count = static_cast<uint32_t>(list.size());
+        postings.insert(postings.end(), list.begin(), list.end());
+    }
+
+    Header h = {};
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.sequence = sequence;
+    h.package_count = static_cast<uint32_t>(records.size());
+    h.term_count = static_cast<uint32_t>(terms.size());
+    h.packages_offset = align8(HEADER_SIZE);
+    h.terms_offset = align8(h.packages_offset + records.size() * PACKAGE_RECORD_SIZE);
+    h.postings_offset = align8(h.terms_offset + terms.size() * TERM_RECORD_SIZE);
+    h.postings_count = postings.size();
+    h.strings_offset = align8(h.postings_offset + postings.size() * POSTING_SIZE);
+    h.strings_size = strings.size();
+
+    std::vector<unsigned char> buffer(h.strings_offset + strings.size(), 0);
+    encode_header(buffer.data(), h);
+    for (size_t i = 0; i < records.size(); ++i) {
+        encode_package(buffer.data() + h.packages_offset + i * PACKAGE_RECORD_SIZE, records[i]);
+    }
+    for (size_t i = 0; i < terms.size(); ++i) {
+        encode_term(buffer.data() + h.terms_offset + i * TERM_RECORD_SIZE, terms[i]);
+    }
+    for (size_t i = 0; i < postings.size(); ++i) {
+        store_le(buffer.data() + h.postings_offset + i * POSTING_SIZE, postings[i], POSTING_SIZE);
+    }
+    std::memcpy(buffer.data() + h.strings_offset, strings.data(), strings.size());
+
+    // 先写临时文件再改名，已映射旧文件的读者不受影响
+    std::string temp = path + ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream ofs(temp, std::ios::binary | std::ios::trunc);
+        if (!ofs.is_open()) {
+            return false;
+        }
+        ofs.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        ofs.close();
+        if (!ofs) {
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+} // namespace cardity
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace cardity {
+
+// 索引中的一个包（最新版本的摘要）
+struct IndexedPackage {
+    std::string name;
+    std::string version;
+    std::string description;
+    std::vector<std::string> keywords;
+};
+
+// 本地注册表搜索索引：只读 mmap 的紧凑二进制文件，含名称、描述、关键词的倒排表。
+// 文件布局（小端，偏移均相对文件头，各段 8 字节对齐）：
+//   Header | Package[package_count]（按名称排序）| Term[term_count]（按词排序）| postings | 字符串区
+// 每条 posting 为 uint32：低 29 位是包序号，高 3 位标记词出现在名称/关键词/描述中
+class RegistryIndex {
+public:
+    RegistryIndex() = default;
+    ~RegistryIndex();
+    RegistryIndex(const RegistryIndex&) = delete;
+    RegistryIndex& operator=(const RegistryIndex&) = delete;
+
+    // 文件不存在或格式不符时返回 false
+    bool open(const std::string& path);
+    void close();
+    bool is_open() const { return data_ != nullptr; }
+
+    uint64_t sequence() const;       // 已同步到的变更序号
+    size_t size() const;             // 包数量
+
+    // 多个词取交集，每个词按前缀匹配；按相关度（名称 > 关键词 > 描述）排序
+    std::vector<IndexedPackage> search(const std::string& query, size_t limit = 20) const;
+
+    // 全部包（按名称），用于增量同步时重建
+    std::vector<IndexedPackage> packages() const;
+
+    // 原子地写出索引文件
+    static bool write(const std::string& path, uint64_t sequence, std::vector<IndexedPackage> packages);
+
+    // 小写化并按非字母数字切分；非 ASCII 字节视为词的一部分
+    static std::vector<std::string> tokenize(const std::string& text);
+
+private:
+    IndexedPackage package_at(uint32_t id) const;
+    std::string string_at(uint32_t offset, uint32_t length) const;
+
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace cardity
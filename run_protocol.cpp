@@ -4,7 +4,33 @@
 #include <map>
 #include <vector>
 #include <sstream>
-#include <regex>
+#include <cctype>
+
+// 查找 `protocol <name> {`，返回协议名（未找到返回空串）
+static std::string find_protocol_name(const std::string& content) {
+    auto is_word_char = [](char c) { return std::isalnum(static_cast<unsigned char>(c)) || c == '_'; };
+    auto skip_space = [&](size_t p) {
+        while (p < content.size() && std::isspace(static_cast<unsigned char>(content[p]))) p++;
+        return p;
+    };
+    size_t pos = content.find("protocol");
+    while (pos != std::string::npos) {
+        size_t p = pos + 8;
+        size_t name_start = skip_space(p);
+        if (name_start > p) {
+            size_t name_end = name_start;
+            while (name_end < content.size() && is_word_char(content[name_end])) name_end++;
+            if (name_end > name_start) {
+                size_t brace = skip_space(name_end);
+                if (brace < content.size() && content[brace] == '{') {
+                    return content.substr(name_start, name_end - name_start);
+                }
+            }
+        }
+        pos = content.find("protocol", pos + 1);
+    }
+    return "";
+}
 
 class SimpleProtocolRuntime {
 private:
@@ -29,10 +55,9 @@ public:
                            std::istreambuf_iterator<char>());
         
         // 简单的协议解析
-        std::regex protocol_regex(R"(protocol\s+(\w+)\s*\{)");
-        std::smatch match;
-        if (std::regex_search(content, match, protocol_regex)) {
-            protocol_name = match[1];
+        std::string name = find_protocol_name(content);
+        if (!name.empty()) {
+            protocol_name = name;
             std::cout << "📖 Loading protocol: " << filename << std::endl;
             std::cout << "🔧 Protocol name: " << protocol_name << std::endl;
             std::cout << "🔧 Initializing state..." << std::endl;
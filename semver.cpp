@@ -0,0 +1,248 @@
+#include "semver.h"
+#include <cctype>
+#include <sstream>
+
+namespace cardity {
+
+namespace {
+
+bool is_numeric(const std::string& s) {
+    if (s.empty()) return false;
+    for (char c : s) {
+        if (!std::isdigit(static_cast<unsigned char>(c))) return false;
+    }
+    return true;
+}
+
+bool parse_number(const std::string& s, int& out) {
+    // 不允许前导零（"0" 本身除外），防止 "01" 与 "1" 被当作同一版本
+    if (!is_numeric(s) || s.size() > 9 || (s.size() > 1 && s[0] == '0')) return false;
+    out = std::stoi(s);
+    return true;
+}
+
+bool is_wildcard(const std::string& s) {
+    return s == "x" || s == "X" || s == "*";
+}
+
+// 范围里的版本可以只写前几段或用 x/* 通配；parts 为给出的数字段数（0~3）
+struct Partial {
+    SemVer version;
+    int parts = 0;
+};
+
+bool parse_partial(std::string text, Partial& out) {
+    out = Partial();
+    if (!text.empty() && (text[0] == 'v' || text[0] == 'V')) text.erase(0, 1);
+    size_t plus = text.find('+');
+    if (plus != std::string::npos) text.erase(plus);
+    size_t dash = text.find('-');
+    if (dash != std::string::npos) {
+        out.version.prerelease = text.substr(dash + 1);
+        text.erase(dash);
+        if (out.version.prerelease.empty()) return false;
+    }
+    if (text.empty() || is_wildcard(text)) {
+        return out.version.prerelease.empty();
+    }
+
+    std::vector<std::string> fields;
+    std::stringstream ss(text);
+    std::string field;
+    while (std::getline(ss, field, '.')) fields.push_back(field);
+    if (fields.empty() || fields.size() > 3 || text.back() == '.') return false;
+
+    int* slots[3] = {&out.version.major, &out.version.minor, &out.version.patch};
+    for (size_t i = 0; i < fields.size(); ++i) {
+        if (is_wildcard(fields[i])) break;
+        if (!parse_number(fields[i], *slots[i])) return false;
+        out.parts = static_cast<int>(i) + 1;
+    }
+    // 预发布标识只能跟在完整版本号之后
+    return out.version.prerelease.empty() || out.parts == 3;
+}
+
+SemVer bump(const SemVer& v, int parts) {
+    // parts=1 -> (M+1).0.0，parts=2 -> M.(m+1).0
+    SemVer next;
+    next.major = parts == 1 ? v.major + 1 : v.major;
+    next.minor = parts == 2 ? v.minor + 1 : 0;
+    return next;
+}
+
+int compare_identifiers(const std::string& a, const std::string& b) {
+    std::stringstream sa(a), sb(b);
+    std::string ia, ib;
+    for (;;) {
+        bool ha = static_cast<bool>(std::getline(sa, ia, '.'));
+        bool hb = static_cast<bool>(std::getline(sb, ib, '.'));
+        if (!ha || !hb) return ha == hb ? 0 : (ha ? 1 : -1);
+        bool na = is_numeric(ia), nb = is_numeric(ib);
+        if (na && nb) {
+            if (ia.size() != ib.size()) return ia.size() < ib.size() ? -1 : 1;
+            int c = ia.compare(ib);
+            if (c != 0) return c < 0 ? -1 : 1;
+        } else if (na != nb) {
+            return na ? -1 : 1;    // 数字标识低于字母数字标识
+        } else {
+            int c = ia.compare(ib);
+            if (c != 0) return c < 0 ? -1 : 1;
+        }
+    }
+}
+
+} // namespace
+
+bool SemVer::parse(const std::string& text, SemVer& out) {
+    Partial partial;
+    if (!parse_partial(text, partial) || partial.parts != 3) return false;
+    out = partial.version;
+    return true;
+}
+
+std::string SemVer::to_string() const {
+    std::string s = std::to_string(major) + "." + std::to_string(minor) + "." + std::to_string(patch);
+    if (!prerelease.empty()) s += "-" + prerelease;
+    return s;
+}
+
+int SemVer::compare(const SemVer& other) const {
+    if (major != other.major) return major < other.major ? -1 : 1;
+    if (minor != other.minor) return minor < other.minor ? -1 : 1;
+    if (patch != other.patch) return patch < other.patch ? -1 : 1;
+    if (prerelease.empty() || other.prerelease.empty()) {
+        if (prerelease.empty() == other.prerelease.empty()) return 0;
+        return prerelease.empty() ? 1 : -1;
+    }
+    return compare_identifiers(prerelease, other.prerelease);
+}
+
+bool VersionRange::parse(const std::string& spec, VersionRange& out) {
+    out = VersionRange();
+    out.spec_ = spec;
+    std::string rest = spec;
+    for (;;) {
+        size_t bar = rest.find("||");
+        std::vector<Comparator> comparators;
+        if (!parse_alternative(rest.substr(0, bar), comparators)) return false;
+        out.alternatives_.push_back(std::move(comparators));
+        if (bar == std::string::npos) break;
+        rest.erase(0, bar + 2);
+    }
+    return true;
+}
+
+bool VersionRange::parse_alternative(const std::string& text, std::vector<Comparator>& out) {
+    // 切分空白，并把单独写出的运算符与后面的版本合并（">= 1.2" -> ">=1.2"）
+    std::vector<std::string> tokens;
+    std::stringstream ss(text);
+    std::string token;
+    while (ss >> token) {
+        if (!tokens.empty() && token != "-" &&
+            (tokens.back() == ">" || tokens.back() == ">=" || tokens.back() == "<" ||
+             tokens.back() == "<=" || tokens.back() == "=" || tokens.back() == "^" || tokens.back() == "~")) {
+            tokens.back() += token;
+        } else {
+            tokens.push_back(token);
+        }
+    }
+    if (tokens.size() == 1 && tokens[0] == "latest") tokens.clear();
+
+    auto upper_for = [&](const Partial& p) {
+        // 上界：完整版本为 <=v，部分版本为 <下一个版本
+        if (p.parts == 3) out.push_back({Op::LE, p.version});
+        else if (p.parts > 0) out.push_back({Op::LT, bump(p.version, p.parts)});
+    };
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        // 连字符范围 "a - b"
+        if (i + 2 < tokens.size() && tokens[i + 1] == "-") {
+            Partial lo, hi;
+            if (!parse_partial(tokens[i], lo) || !parse_partial(tokens[i + 2], hi)) return false;
+            if (lo.parts > 0) out.push_back({Op::GE, lo.version});
+            upper_for(hi);
+            i += 2;
+            continue;
+        }
+
+        const std::string& t = tokens[i];
+        std::string op;
+        size_t n = 0;
+        while (n < t.size() && (t[n] == '<' || t[n] == '>' || t[n] == '=' || t[n] == '^' || t[n] == '~')) ++n;
+        op = t.substr(0, n);
+        Partial p;
+        if (!parse_partial(t.substr(n), p)) return false;
+        const SemVer& v = p.version;
+
+        if (op.empty() || op == "=") {
+            if (p.parts == 3) {
+                out.push_back({Op::EQ, v});
+            } else if (p.parts > 0) {
+                out.push_back({Op::GE, v});
+                out.push_back({Op::LT, bump(v, p.parts)});
+            }
+        } else if (op == "^") {
+            if (p.parts == 0) continue;
+            out.push_back({Op::GE, v});
+            if (v.major > 0 || p.parts == 1) {
+                out.push_back({Op::LT, bump(v, 1)});
+            } else if (v.minor > 0 || p.parts == 2) {
+                out.push_back({Op::LT, bump(v, 2)});
+            } else {
+                SemVer next;
+                next.patch = v.patch + 1;
+                out.push_back({Op::LT, next});
+            }
+        } else if (op == "~") {
+            if (p.parts == 0) continue;
+            out.push_back({Op::GE, v});
+            out.push_back({Op::LT, bump(v, p.parts == 1 ? 1 : 2)});
+        } else if (op == ">") {
+            if (p.parts == 0) out.push_back({Op::LT, SemVer()});    // ">*" 不匹配任何版本
+            else if (p.parts == 3) out.push_back({Op::GT, v});
+            else out.push_back({Op::GE, bump(v, p.parts)});
+        } else if (op == ">=") {
+            if (p.parts > 0) out.push_back({Op::GE, v});
+        } else if (op == "<") {
+            out.push_back({Op::LT, v});    // 部分版本按 0 补齐："<1.2" 即 "<1.2.0"；"<*" 不匹配任何版本
+        } else if (op == "<=") {
+            upper_for(p);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VersionRange::satisfies(const SemVer& version) const {
+    for (const auto& comparators : alternatives_) {
+        bool ok = true;
+        bool prerelease_allowed = version.prerelease.empty();
+        for (const auto& c : comparators) {
+            int cmp = version.compare(c.version);
+            switch (c.op) {
+                case Op::EQ: ok = cmp == 0; break;
+                case Op::LT: ok = cmp < 0; break;
+                case Op::LE: ok = cmp <= 0; break;
+                case Op::GT: ok = cmp > 0; break;
+                case Op::GE: ok = cmp >= 0; break;
+            }
+            if (!ok) break;
+            if (!c.version.prerelease.empty() && c.version.major == version.major &&
+                c.version.minor == version.minor && c.version.patch == version.patch) {
+                prerelease_allowed = true;
+            }
+        }
+        if (ok && prerelease_allowed) return true;
+    }
+    return false;
+}
+
+bool VersionRange::is_any() const {
+    for (const auto& comparators : alternatives_) {
+        if (comparators.empty()) return true;
+    }
+    return false;
+}
+
+} // namespace cardity
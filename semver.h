@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace cardity {
+
+// 语义化版本 MAJOR.MINOR.PATCH[-prerelease][+build]
+struct SemVer {
+    int major = 0;
+    int minor = 0;
+    int patch = 0;
+    std::string prerelease;    // 为空表示正式版；build 元数据不参与比较，解析时丢弃
+
+    // 接受可选前缀 "v"；格式错误时返回 false
+    static bool parse(const std::string& text, SemVer& out);
+
+    std::string to_string() const;
+
+    // <0 / 0 / >0；预发布版低于同号正式版，标识符按 semver 2.0 规则逐段比较
+    int compare(const SemVer& other) const;
+    bool operator<(const SemVer& other) const { return compare(other) < 0; }
+    bool operator==(const SemVer& other) const { return compare(other) == 0; }
+};
+
+// 版本范围：支持 npm 风格的 "1.2.3"、"^1.2"、"~1.2.3"、">=1.0.0 <2.0.0"、"1.x"、
+// "1.2.3 - 2.0"、"*"/"latest" 以及 "||" 组合
+class VersionRange {
+public:
+    static bool parse(const std::string& spec, VersionRange& out);
+
+    // 预发布版只在某个比较器的版本号相同且带预发布标识时才匹配（与 npm 一致）
+    bool satisfies(const SemVer& version) const;
+
+    bool is_any() const;
+    const std::string& spec() const { return spec_; }
+
+private:
+    enum class Op { EQ, LT, LE, GT, GE };
+    struct Comparator {
+        Op op;
+        SemVer version;
+    };
+
+    static bool parse_alternative(const std::string& text, std::vector<Comparator>& out);
+
+    std::vector<std::vector<Comparator>> alternatives_;    // 各组之间为“或”，组内为“且”
+    std::string spec_;
+};
+
+} // namespace cardity
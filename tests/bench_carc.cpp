@@ -0,0 +1,132 @@
+// .carc v1 与压缩 v2 的体积与解析耗时对比（不在 ctest 中运行，计时依赖机器）。
+// 用法：carc_bench [-O] [迭代次数] file.car...
+// 每个文件列出 v1 字节数、无字典 zstd 字节数、v2（内置字典）字节数，
+// 以及 parse_carc_data 在 v1 与 v2 上的单次耗时（v2 含解压），最后一行为合计
+#include "tokenizer.h"
+#include "parser.h"
+#include "optimizer.h"
+#include "car_generator.h"
+#include "carc_generator.h"
+#include <zstd.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cardity;
+
+namespace {
+
+struct Row {
+    std::string name;
+    size_t v1 = 0;
+    size_t zstd = 0;
+    size_t v2 = 0;
+    double v1_parse_us = 0;
+    double v2_parse_us = 0;
+};
+
+std::vector<uint8_t> compile_file(const std::string& path, bool optimize) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Cannot open " + path);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    Tokenizer tokenizer(buffer.str());
+    Parser parser(tokenizer);
+    ProtocolAST ast = parser.parse_protocol();
+    if (optimize) Optimizer::optimize_protocol(ast);
+    return CarcGenerator::compile_to_carc(CarGenerator::normalize(CarGenerator::from_ast(ast)));
+}
+
+// 同一压缩级别、不带字典的 zstd，用来区分字典本身的收益
+size_t plain_zstd_size(const std::vector<uint8_t>& data, int level) {
+    std::vector<uint8_t> out(ZSTD_compressBound(data.size()));
+    size_t n = ZSTD_compress(out.data(), out.size(), data.data(), data.size(), level);
+    if (ZSTD_isError(n)) throw std::runtime_error(ZSTD_getErrorName(n));
+    return n;
+}
+
+double parse_micros(const std::vector<uint8_t>& data, int iterations) {
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink += CarcGenerator::parse_carc_data(data).methods.size();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+void print_row(const Row& row) {
+    std::cout << std::left << std::setw(28) << row.name << std::right
+              << std::setw(8) << row.v1 << std::setw(9) << row.zstd << std::setw(9) << row.v2
+              << std::fixed << std::setprecision(1)
+              << std::setw(10) << row.v1_parse_us << std::setw(10) << row.v2_parse_us << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool optimize = false;
+    int iterations = 2000;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-O") optimize = true;
+        else if (!arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos) iterations = std::atoi(arg.c_str());
+        else files.push_back(arg);
+    }
+    if (files.empty() || iterations <= 0) {
+        std::cerr << "Usage: " << argv[0] << " [-O] [iterations] file.car..." << std::endl;
+        return 1;
+    }
+
+    // 解析器会打印调试信息，所以先全部编译完再计时、输出表格
+    std::vector<std::vector<uint8_t>> images;
+    for (const auto& file : files) {
+        try {
+            images.push_back(compile_file(file, optimize));
+        } catch (const std::exception& e) {
+            std::cerr << "❌ " << file << ": " << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Row> rows;
+    Row total;
+    total.name = "total";
+    for (size_t i = 0; i < files.size(); ++i) {
+        const std::string& file = files[i];
+        const std::vector<uint8_t>& v1 = images[i];
+        std::vector<uint8_t> v2 = CarcGenerator::compress(v1);
+        if (CarcGenerator::decompress(v2) != v1) {
+            std::cerr << "❌ " << file << ": v2 does not round-trip" << std::endl;
+            return 1;
+        }
+        Row row;
+        row.name = file.substr(file.find_last_of('/') + 1);
+        row.v1 = v1.size();
+        row.zstd = plain_zstd_size(v1, 19);
+        row.v2 = v2.size();
+        row.v1_parse_us = parse_micros(v1, iterations);
+        row.v2_parse_us = parse_micros(v2, iterations);
+        total.v1 += row.v1;
+        total.zstd += row.zstd;
+        total.v2 += row.v2;
+        total.v1_parse_us += row.v1_parse_us;
+        total.v2_parse_us += row.v2_parse_us;
+        rows.push_back(row);
+    }
+
+    std::cout << "📊 " << iterations << " parses per file" << (optimize ? ", -O" : "") << ", zstd level 19" << std::endl;
+    std::cout << std::left << std::setw(28) << "file" << std::right << std::setw(8) << "v1" << std::setw(9) << "zstd"
+              << std::setw(9) << "v2" << std::setw(10) << "v1 us" << std::setw(10) << "v2 us" << std::endl;
+    for (const auto& row : rows) print_row(row);
+    if (rows.size() > 1) print_row(total);
+    std::cout << "v2 = " << std::fixed << std::setprecision(1) << 100.0 * total.v2 / total.v1 << "% of v1" << std::endl;
+    return 0;
+}
@@ -0,0 +1,124 @@
+// 基于 token 的扫描器与原 std::regex 实现的耗时对比（不在 ctest 中运行，计时依赖机器）。
+// 用法：tokenizer_bench [迭代次数]
+// 对比前先确认两种实现对样例给出相同的调用列表
+#include "tokenizer.h"
+#include "drc20_standard.h"
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace cardity;
+
+namespace {
+
+using Calls = std::vector<std::tuple<std::string, std::string, int>>;
+
+// 与 examples/08_usdt_like.car 中 transfer 相当的方法体，外加几处跨模块调用
+const char* TRANSFER_BODY = R"(
+    state._result = "ok";
+    if (params.amount <= 0) { state._result = "InvalidAmount" }
+    if (state.paused == "true") { state._result = "Paused" }
+    if (params.amount > state.max_tx_amount) { state._result = "ExceedsLimit" }
+    if (state.frozen[ctx.sender] == "true") { state._result = "SenderFrozen" }
+    if (state.frozen[params.to] == "true") { state._result = "RecipientFrozen" }
+    if (registry.isBlocked(params.to)) { state._result = "Blocked" }
+    if (state.balances[ctx.sender] < params.amount) { state._result = "Insufficient" }
+    if (state._result == "ok") { state._fee = oracle.feeFor(params.amount, state.basis_points_rate) }
+    if (state._result == "ok") { state._fee = state._fee / 10000 }
+    if (state._result == "ok") { if (state._fee > state.maximum_fee) { state._fee = state.maximum_fee } }
+    if (state._result == "ok") { state._send = params.amount - state._fee }
+    if (state._result == "ok") { state.balances[ctx.sender] = state.balances[ctx.sender] - params.amount }
+    if (state._result == "ok") { state.balances[params.to] = state.balances[params.to] + state._send }
+    if (state._result == "ok") { state.balances[state.owner_addr] = state.balances[state.owner_addr] + state._fee }
+    if (state._result == "ok") { ledger.record(ctx.sender, params.to, math.max(state._send, 0)) }
+    if (state._result == "ok") { audit.ping() }
+    if (state._result == "ok") { emit Transfer(ctx.sender, params.to, state._send, state._fee) }
+)";
+
+// 原 cardityc 实现：每次调用构造正则，参数按字符计数（零参数记为 1）
+void regex_scan_external_calls(const std::string& logic, Calls& outCalls) {
+    std::regex re(R"(([A-Za-z_][A-Za-z0-9_]*)\s*\.\s*([A-Za-z_][A-Za-z0-9_]*)\s*\()");
+    auto begin = std::sregex_iterator(logic.begin(), logic.end(), re);
+    auto end = std::sregex_iterator();
+    for (auto it = begin; it != end; ++it) {
+        auto m = *it;
+        std::string alias = m.str(1);
+        std::string method = m.str(2);
+        size_t pos = m.position() + m.length() - 1;
+        int depth = 0; int argCount = 0; bool inToken = false; bool anyChar = false;
+        for (size_t i = pos; i < logic.size(); ++i) {
+            char c = logic[i];
+            if (c == '(') { depth++; anyChar = true; }
+            else if (c == ')') { if (depth == 1) { if (inToken || anyChar) argCount++; } depth--; if (depth <= 0) { break; } }
+            else if (c == ',' && depth == 1) { argCount++; inToken = false; anyChar = false; }
+            else if (!isspace(static_cast<unsigned char>(c)) && depth >= 1) { inToken = true; anyChar = true; }
+        }
+        outCalls.emplace_back(alias, method, argCount);
+    }
+}
+
+// 原 Drc20Standard::validate_tick（长度检查 + 正则字符检查）
+bool regex_validate_tick(const std::string& tick) {
+    std::regex tick_regex("^[A-Za-z0-9]+$");
+    return tick.length() >= 2 && tick.length() <= 8 && std::regex_match(tick, tick_regex);
+}
+
+template <typename F>
+double micros_per_call(int iterations, F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) f();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / iterations;
+}
+
+void report(const std::string& name, double before, double after) {
+    std::cout << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << before << " us" << std::setw(10) << after << " us"
+              << std::setw(9) << std::setprecision(1) << before / after << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (iterations <= 0) iterations = 2000;
+    const std::string body = TRANSFER_BODY;
+
+    Calls by_regex, by_tokens;
+    regex_scan_external_calls(body, by_regex);
+    scan_external_calls(body, by_tokens);
+    bool same = by_regex.size() == by_tokens.size();
+    for (size_t i = 0; same && i < by_regex.size(); ++i) {
+        same = std::get<0>(by_regex[i]) == std::get<0>(by_tokens[i]) &&
+               std::get<1>(by_regex[i]) == std::get<1>(by_tokens[i]);
+    }
+    if (!same) {
+        std::cerr << "❌ scanners disagree on " << by_tokens.size() << " vs " << by_regex.size() << " calls" << std::endl;
+        return 1;
+    }
+    if (regex_validate_tick("DOGE") != Drc20Standard::validate_tick("DOGE")) {
+        std::cerr << "❌ tick validators disagree" << std::endl;
+        return 1;
+    }
+
+    std::cout << "📊 " << iterations << " iterations, " << body.size() << "-byte method body, "
+              << by_tokens.size() << " calls" << std::endl;
+    std::cout << std::left << std::setw(22) << "" << std::right << std::setw(13) << "std::regex"
+              << std::setw(13) << "tokens" << std::setw(10) << "speedup" << std::endl;
+
+    volatile size_t sink = 0;
+    double scan_before = micros_per_call(iterations, [&] { Calls c; regex_scan_external_calls(body, c); sink += c.size(); });
+    double scan_after = micros_per_call(iterations, [&] { Calls c; scan_external_calls(body, c); sink += c.size(); });
+    report("scan_external_calls", scan_before, scan_after);
+
+    double tick_before = micros_per_call(iterations * 10, [&] { sink += regex_validate_tick("DOGE"); });
+    double tick_after = micros_per_call(iterations * 10, [&] { sink += Drc20Standard::validate_tick("DOGE"); });
+    report("validate_tick", tick_before, tick_after);
+    return 0;
+}
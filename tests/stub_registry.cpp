@@ -0,0 +1,207 @@
+#include "stub_registry.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace cardity {
+
+namespace {
+
+const char* reason_phrase(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 404: return "Not Found";
+        case 500: return "Internal Server Error";
+        case 503: return "Service Unavailable";
+        default: return "Status";
+    }
+}
+
+bool send_all(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+StubRegistry::StubRegistry() = default;
+
+StubRegistry::~StubRegistry() {
+    stop();
+}
+
+void StubRegistry::start() {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+    }
+    int one = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 64) != 0 ||
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        std::string error = std::strerror(errno);
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        throw std::runtime_error("Failed to start stub registry: " + error);
+    }
+    port_ = ntohs(addr.sin_port);
+    stopping_ = false;
+    acceptor_ = std::thread(&StubRegistry::accept_loop, this);
+}
+
+void StubRegistry::stop() {
+    if (listen_fd_ < 0) return;
+    stopping_ = true;
+    if (acceptor_.joinable()) acceptor_.join();
+    ::close(listen_fd_);
+    listen_fd_ = -1;
+
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // 唤醒阻塞在 recv 上的连接线程
+        for (int fd : client_fds_) ::shutdown(fd, SHUT_RDWR);
+        workers.swap(workers_);
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+std::string StubRegistry::url() const {
+    return "http://127.0.0.1:" + std::to_string(port_);
+}
+
+void StubRegistry::add_package(const std::string& name, const std::string& metadata_json) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    packages_[name] = metadata_json;
+}
+
+void StubRegistry::add_archive(const std::string& name, const std::string& version, std::string bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    archives_[name + "/" + version] = std::move(bytes);
+}
+
+void StubRegistry::accept_loop() {
+    while (!stopping_) {
+        pollfd pfd{listen_fd_, POLLIN, 0};
+        if (::poll(&pfd, 1, 50) <= 0) continue;
+        int fd = ::accept(listen_fd_, nullptr, nullptr);
+        if (fd < 0) continue;
+        connections_++;
+        std::lock_guard<std::mutex> lock(mutex_);
+        client_fds_.push_back(fd);
+        workers_.emplace_back(&StubRegistry::serve_connection, this, fd);
+    }
+}
+
+void StubRegistry::serve_connection(int fd) {
+    std::string buffer;
+    char chunk[4096];
+    for (;;) {
+        size_t header_end;
+        while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) goto done;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        std::string head = buffer.substr(0, header_end);
+        buffer.erase(0, header_end + 4);
+
+        // 请求行：METHOD PATH HTTP/1.1；请求体按 Content-Length 读完后丢弃
+        size_t sp1 = head.find(' ');
+        size_t sp2 = sp1 == std::string::npos ? std::string::npos : head.find(' ', sp1 + 1);
+        if (sp2 == std::string::npos) break;
+        std::string method = head.substr(0, sp1);
+        std::string path = head.substr(sp1 + 1, sp2 - sp1 - 1);
+
+        std::string lower = head;
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+        size_t content_length = 0;
+        size_t cl = lower.find("\r\ncontent-length:");
+        if (cl != std::string::npos) content_length = std::strtoul(head.c_str() + cl + 17, nullptr, 10);
+        bool close_after = lower.find("\r\nconnection: close") != std::string::npos;
+        while (buffer.size() < content_length) {
+            ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) goto done;
+            buffer.append(chunk, static_cast<size_t>(n));
+        }
+        buffer.erase(0, content_length);
+
+        Reply reply = route(method, path);
+        requests_++;
+        std::string header = "HTTP/1.1 " + std::to_string(reply.status) + " " + reason_phrase(reply.status) +
+                             "\r\nContent-Type: " + reply.content_type +
+                             "\r\nContent-Length: " + std::to_string(reply.body.size()) +
+                             (close_after ? "\r\nConnection: close" : "\r\nConnection: keep-alive") + "\r\n\r\n";
+        if (!send_all(fd, header.data(), header.size())) break;
+        if (method != "HEAD" && !send_all(fd, reply.body.data(), reply.body.size())) break;
+        if (close_after) break;
+    }
+done:
+    std::lock_guard<std::mutex> lock(mutex_);
+    client_fds_.erase(std::remove(client_fds_.begin(), client_fds_.end(), fd), client_fds_.end());
+    ::close(fd);
+}
+
+StubRegistry::Reply StubRegistry::route(const std::string& method, const std::string& path) {
+    Reply reply;
+    if (method != "GET" && method != "HEAD") {
+        reply.status = 404;
+        reply.body = R"({"error":"not found"})";
+        return reply;
+    }
+    if (path.rfind("/status/", 0) == 0) {
+        reply.status = std::atoi(path.c_str() + 8);
+        reply.content_type = "text/plain";
+        reply.body = "status " + path.substr(8);
+        return reply;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const std::string prefix = "/packages/";
+    if (path.rfind(prefix, 0) == 0) {
+        std::string rest = path.substr(prefix.size());
+        const std::string suffix = "/download";
+        if (rest.size() > suffix.size() && rest.compare(rest.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            auto it = archives_.find(rest.substr(0, rest.size() - suffix.size()));
+            if (it != archives_.end()) {
+                reply.content_type = "application/gzip";
+                reply.body = it->second;
+                return reply;
+            }
+        } else {
+            auto it = packages_.find(rest);
+            if (it != packages_.end()) {
+                reply.body = it->second;
+                return reply;
+            }
+        }
+    }
+    reply.status = 404;
+    reply.body = R"({"error":"not found"})";
+    return reply;
+}
+
+} // namespace cardity
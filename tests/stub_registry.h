@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+namespace cardity {
+
+// 本地替身注册表：只监听 127.0.0.1 的最小 HTTP/1.1 服务器，支持 keep-alive，供客户端测试使用。
+// 路由：
+//   GET /packages/<name>                        已注册时返回 JSON 元数据，否则 404
+//   GET /packages/<name>/<version>/download     返回注册的归档字节
+//   GET /status/<code>                          返回对应状态码与一段文本
+// 其余路径返回 404。每个连接一个线程，stop() 或析构时关闭所有连接
+class StubRegistry {
+public:
+    StubRegistry();
+    ~StubRegistry();
+    StubRegistry(const StubRegistry&) = delete;
+    StubRegistry& operator=(const StubRegistry&) = delete;
+
+    // 在临时端口上开始监听；失败时抛出 std::runtime_error
+    void start();
+    void stop();
+
+    std::string url() const;    // http://127.0.0.1:<port>
+
+    void add_package(const std::string& name, const std::string& metadata_json);
+    void add_archive(const std::string& name, const std::string& version, std::string bytes);
+
+    size_t connections_accepted() const { return connections_; }
+    size_t requests_served() const { return requests_; }
+
+private:
+    struct Reply {
+        int status = 200;
+        std::string content_type = "application/json";
+        std::string body;
+    };
+
+    void accept_loop();
+    void serve_connection(int fd);
+    Reply route(const std::string& method, const std::string& path);
+
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::thread acceptor_;
+
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+    std::vector<int> client_fds_;
+    std::map<std::string, std::string> packages_;
+    std::map<std::string, std::string> archives_;    // "<name>/<version>" -> 字节
+
+    std::atomic<size_t> connections_{0};
+    std::atomic<size_t> requests_{0};
+};
+
+} // namespace cardity
@@ -0,0 +1,191 @@
+// 共享编解码器的测试：hex/base64 的 RFC 4648 向量、二进制调用格式的往返，以及各自对非法输入的拒绝。
+// 纯内存计算，失败时返回非 0
+#include "codec.h"
+#include "invoke_codec.h"
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace cardity;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::cerr << "❌ " << __FILE__ << ":" << __LINE__ << ": " #cond << std::endl; \
+            ++failures;                                                              \
+        }                                                                            \
+    } while (0)
+
+template <typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+std::vector<uint8_t> bytes(const std::string& s) {
+    return std::vector<uint8_t>(s.begin(), s.end());
+}
+
+bool decodes_to(const std::string& b64, const std::string& expected) {
+    std::vector<uint8_t> out;
+    return Codec::base64_decode(b64, out) && out == bytes(expected);
+}
+
+bool rejects(const std::string& b64) {
+    std::vector<uint8_t> out = {1, 2, 3};
+    return !Codec::base64_decode(b64, out) && out.empty();
+}
+
+void test_hex() {
+    std::vector<uint8_t> all(256);
+    for (size_t i = 0; i < all.size(); ++i) all[i] = static_cast<uint8_t>(i);
+    // 长度覆盖 SSE2 的 16 字节块与剩余部分
+    for (size_t n : {0, 1, 15, 16, 17, 33, 256}) {
+        std::vector<uint8_t> data(all.begin(), all.begin() + n);
+        std::string hex = Codec::hex_encode(data);
+        CHECK(hex.size() == n * 2);
+        std::vector<uint8_t> back;
+        CHECK(Codec::hex_decode(hex, back) && back == data);
+    }
+    CHECK(Codec::hex_encode(bytes("\x01\xab\xff")) == "01abff");
+    std::vector<uint8_t> out;
+    CHECK(Codec::hex_decode("01ABfF", out) && out == bytes("\x01\xab\xff"));
+    CHECK(!Codec::hex_decode("abc", out));
+    CHECK(!Codec::hex_decode("0g", out));
+}
+
+void test_base64() {
+    // RFC 4648 第 10 节
+    const char* vectors[][2] = {{"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"},
+                                {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"}};
+    for (const auto& v : vectors) {
+        CHECK(Codec::base64_encode(std::string(v[0])) == v[1]);
+        CHECK(decodes_to(v[1], v[0]));
+    }
+    std::vector<uint8_t> all(256);
+    for (size_t i = 0; i < all.size(); ++i) all[i] = static_cast<uint8_t>(255 - i);
+    std::vector<uint8_t> back;
+    CHECK(Codec::base64_decode(Codec::base64_encode(all), back) && back == all);
+
+    // 填充可省略，空白忽略
+    CHECK(decodes_to("Zg", "f"));
+    CHECK(decodes_to("Zm8", "fo"));
+    CHECK(decodes_to("Zm9v\nYmFy\r\n", "foobar"));
+    CHECK(decodes_to("Zg= =", "f"));
+
+    // 填充后的数据、多余或不完整的填充、孤立的单个字符、非法字符
+    CHECK(rejects("Zg==Zm9v"));
+    CHECK(rejects("Zm8=x"));
+    CHECK(rejects("Zg==="));
+    CHECK(rejects("Zg="));
+    CHECK(rejects("Zm9v="));
+    CHECK(rejects("===="));
+    CHECK(rejects("Z"));
+    CHECK(rejects("Zm9vY"));
+    CHECK(rejects("Zm9v*"));
+}
+
+// ---- 二进制调用格式 ----
+
+// 版本字节 + selector 0x01020304，后接给定字节
+std::vector<uint8_t> invoke_payload(std::initializer_list<uint8_t> rest) {
+    std::vector<uint8_t> out = {InvokeCodec::VERSION, 0x01, 0x02, 0x03, 0x04};
+    out.insert(out.end(), rest);
+    return out;
+}
+
+bool decode_rejects(const std::vector<uint8_t>& payload) {
+    return throws([&] { InvokeCodec::decode(payload); });
+}
+
+void test_invoke_round_trip() {
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    json args = json::array({true, false, 0, -1, 300, min, max, "hi", "", std::numeric_limits<uint64_t>::max(),
+                             "42", "042", 1.5, json::object({{"k", 1}})});
+    std::vector<std::string> types(args.size(), "string");
+    types[10] = types[11] = "int";
+    std::vector<uint8_t> payload = InvokeCodec::encode(0xdeadbeef, args, types);
+    DecodedInvoke decoded = InvokeCodec::decode(payload);
+    CHECK(decoded.selector == 0xdeadbeef);
+    std::vector<std::string> expected = {"true", "false", "0", "-1", "300", std::to_string(min), std::to_string(max),
+                                         "hi", "", "18446744073709551615", "42", "042", "1.5", R"({"k":1})"};
+    CHECK(decoded.args == expected);
+
+    // 标注为 int 的规范十进制按整数编码（tag 2），非规范的仍按字符串
+    std::vector<uint8_t> typed = InvokeCodec::encode(1, json::array({"42", "042"}), {"int", "int"});
+    CHECK(typed == std::vector<uint8_t>({InvokeCodec::VERSION, 0, 0, 0, 1, 2,
+                                         InvokeCodec::TAG_INT, 84, InvokeCodec::TAG_STRING, 3, '0', '4', '2'}));
+    CHECK(InvokeCodec::decode_hex("0x" + Codec::hex_encode(typed)).args == std::vector<std::string>({"42", "042"}));
+
+    // selector 为签名 SHA-256 的前 4 字节；未标注类型的参数按 string 计
+    json method = {{"params", {"to", "amount"}}, {"param_types", {"", "int"}}};
+    CHECK(InvokeCodec::method_signature("transfer", method) == "transfer(string,int)");
+    CHECK(InvokeCodec::method_selector("transfer", method) == InvokeCodec::selector("transfer(string,int)"));
+    json car = {{"cpl", {{"methods", {{"transfer", method}}}}}};
+    CHECK(InvokeCodec::decode(InvokeCodec::encode(car, "transfer", json::array({"D1", "7"}))).args ==
+          std::vector<std::string>({"D1", "7"}));
+    CHECK(throws([&] { InvokeCodec::encode(car, "transfer", json::array({"D1"})); }));
+    CHECK(throws([&] { InvokeCodec::encode(car, "missing", json::array()); }));
+}
+
+void test_invoke_rejects() {
+    CHECK(!decode_rejects(invoke_payload({0})));
+    CHECK(!decode_rejects(invoke_payload({1, InvokeCodec::TAG_INT, 0xac, 0x02})));    // 300 的 zigzag
+
+    // 版本、截断、尾随字节与未知 tag
+    CHECK(decode_rejects({0xC2, 1, 2, 3, 4, 0}));
+    CHECK(decode_rejects({InvokeCodec::VERSION, 1, 2, 3}));
+    CHECK(decode_rejects(invoke_payload({})));
+    CHECK(decode_rejects(invoke_payload({0, 0})));
+    CHECK(decode_rejects(invoke_payload({1, InvokeCodec::TAG_TRUE, 0})));
+    CHECK(decode_rejects(invoke_payload({1, 4})));
+    CHECK(decode_rejects(invoke_payload({1, 0xff})));
+    CHECK(decode_rejects(invoke_payload({2, InvokeCodec::TAG_TRUE})));
+    CHECK(decode_rejects(invoke_payload({5, 0})));
+    CHECK(decode_rejects(invoke_payload({1, InvokeCodec::TAG_STRING, 3, 'a', 'b'})));
+    CHECK(decode_rejects(invoke_payload({1, InvokeCodec::TAG_INT, 0x80})));
+
+    // 非最短 varint：argc、整数与字符串长度都不能多写高位的 0 组
+    CHECK(decode_rejects(invoke_payload({0x80, 0x00})));
+    CHECK(decode_rejects(invoke_payload({0x81, 0x00, InvokeCodec::TAG_TRUE})));
+    CHECK(decode_rejects(invoke_payload({1, InvokeCodec::TAG_INT, 0xac, 0x82, 0x00})));
+    CHECK(decode_rejects(invoke_payload({1, InvokeCodec::TAG_STRING, 0x81, 0x80, 0x00, 'a'})));
+
+    // 64 位边界：10 字节的最大值合法，超出的位数或第 11 个字节拒绝
+    CHECK(!decode_rejects(invoke_payload({1, InvokeCodec::TAG_INT,
+                                          0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01})));
+    CHECK(decode_rejects(invoke_payload({1, InvokeCodec::TAG_INT,
+                                         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x02})));
+    CHECK(decode_rejects(invoke_payload({1, InvokeCodec::TAG_INT,
+                                         0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x81, 0x00})));
+
+    CHECK(throws([] { InvokeCodec::decode_hex("c10102030"); }));
+    CHECK(throws([] { InvokeCodec::decode_hex("zz"); }));
+}
+
+} // namespace
+
+int main() {
+    test_hex();
+    test_base64();
+    test_invoke_round_trip();
+    test_invoke_rejects();
+
+    if (failures) {
+        std::cerr << "❌ " << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ codec tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,212 @@
+// 语义化版本与依赖求解器的离线测试：版本解析/比较、npm 风格范围、求解结果、冲突报告与 cardity.lock 读写。
+// 元数据由内存中的表提供，不访问网络，失败时返回非 0
+#include "semver.h"
+#include "dependency_solver.h"
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace cardity;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::cerr << "❌ " << __FILE__ << ":" << __LINE__ << ": " #cond << std::endl; \
+            ++failures;                                                              \
+        }                                                                            \
+    } while (0)
+
+bool satisfies(const std::string& spec, const std::string& version) {
+    VersionRange range;
+    SemVer v;
+    if (!VersionRange::parse(spec, range) || !SemVer::parse(version, v)) {
+        throw std::runtime_error("bad test input: " + spec + " / " + version);
+    }
+    return range.satisfies(v);
+}
+
+// 以内存中的元数据表代替注册表
+DependencySolver::MetadataFetcher registry(const std::map<std::string, json>& packages) {
+    return [packages](const std::string& name) {
+        std::promise<json> promise;
+        auto it = packages.find(name);
+        promise.set_value(it != packages.end() ? it->second : json::object());
+        return promise.get_future();
+    };
+}
+
+std::string solve_error(const std::map<std::string, json>& packages, const std::vector<Dependency>& roots) {
+    try {
+        DependencySolver(registry(packages)).solve(roots);
+    } catch (const std::exception& e) {
+        return e.what();
+    }
+    return "";
+}
+
+void test_semver_parse_and_compare() {
+    SemVer v;
+    CHECK(SemVer::parse("v1.2.3-beta.1+build.5", v));
+    CHECK(v.major == 1 && v.minor == 2 && v.patch == 3 && v.prerelease == "beta.1");
+    CHECK(v.to_string() == "1.2.3-beta.1");
+    CHECK(!SemVer::parse("1.2", v));
+    CHECK(!SemVer::parse("01.2.3", v));
+    CHECK(!SemVer::parse("1.2.3-", v));
+    CHECK(!SemVer::parse("1.2.x", v));
+
+    // semver 2.0 第 11 条的顺序
+    const char* ordered[] = {"1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-alpha.beta", "1.0.0-beta", "1.0.0-beta.2",
+                             "1.0.0-beta.11", "1.0.0-rc.1", "1.0.0", "1.0.1", "1.10.0", "2.0.0"};
+    for (size_t i = 0; i + 1 < sizeof(ordered) / sizeof(ordered[0]); ++i) {
+        SemVer a, b;
+        CHECK(SemVer::parse(ordered[i], a) && SemVer::parse(ordered[i + 1], b));
+        CHECK(a < b);
+        CHECK(!(b < a));
+    }
+    SemVer a, b;
+    CHECK(SemVer::parse("1.0.0+one", a) && SemVer::parse("1.0.0+two", b) && a == b);
+}
+
+void test_ranges() {
+    CHECK(satisfies("^1.2.3", "1.9.0"));
+    CHECK(!satisfies("^1.2.3", "2.0.0"));
+    CHECK(!satisfies("^1.2.3", "1.2.2"));
+    CHECK(satisfies("^0.2.3", "0.2.9"));
+    CHECK(!satisfies("^0.2.3", "0.3.0"));
+    CHECK(!satisfies("^0.0.3", "0.0.4"));
+    CHECK(satisfies("~1.2.3", "1.2.9"));
+    CHECK(!satisfies("~1.2.3", "1.3.0"));
+    CHECK(satisfies("1.x", "1.99.0"));
+    CHECK(!satisfies("1.x", "2.0.0"));
+    CHECK(satisfies(">=1.0.0 <2.0.0", "1.5.0"));
+    CHECK(!satisfies(">= 1.0.0 < 2.0.0", "2.0.0"));
+    CHECK(satisfies("1.2.3 - 2.3", "2.3.9"));
+    CHECK(!satisfies("1.2.3 - 2.3", "2.4.0"));
+    CHECK(satisfies("^1.0.0 || ^3.0.0", "3.1.0"));
+    CHECK(!satisfies("^1.0.0 || ^3.0.0", "2.1.0"));
+    CHECK(satisfies("*", "0.0.1"));
+    CHECK(satisfies("latest", "7.0.0"));
+    CHECK(!satisfies(">*", "1.0.0"));
+
+    // 预发布版只被同号带预发布标识的比较器匹配
+    CHECK(!satisfies("^1.0.0", "1.1.0-beta"));
+    CHECK(satisfies("^1.1.0-alpha", "1.1.0-beta"));
+    CHECK(!satisfies("^1.1.0-alpha", "1.2.0-beta"));
+    CHECK(!satisfies("*", "1.0.0-rc.1"));
+
+    VersionRange range;
+    CHECK(!VersionRange::parse("^1.2.3-", range));
+    CHECK(!VersionRange::parse("1.2-beta", range));
+    CHECK(!VersionRange::parse("!1.0.0", range));
+    CHECK(VersionRange::parse("latest", range) && range.is_any());
+}
+
+void test_solve() {
+    std::map<std::string, json> packages = {
+        {"app-lib", {{"versions", {
+            {"1.0.0", {{"dependencies", {{"util", "^1.0.0"}}}}},
+            {"1.4.0", {{"dependencies", {{"util", "^1.2.0"}, {"fmt", "~2.1.0"}}}, {"sha256", "aa"}}},
+            {"2.0.0-rc.1", {{"dependencies", {{"util", "^2.0.0"}}}}}}}}},
+        {"util", {{"versions", {"1.0.0", "1.2.0", "1.3.5", "2.0.0"}}}},
+        {"fmt", {{"versions", {"2.0.9", "2.1.0", "2.1.4", "2.2.0"}}}},
+        {"pin", {{"versions", {{"1.0.0", {{"dependencies", {{"app-lib", "1.0.0"}}}}}}}}},
+    };
+    DependencySolver solver(registry(packages));
+    DependencyGraph graph = solver.solve({Dependency("app-lib", "^1.0.0")});
+    CHECK(graph.nodes.size() == 3);
+    CHECK(graph.nodes["app-lib"].version == "1.4.0");
+    CHECK(graph.nodes["app-lib"].sha256 == "aa");
+    CHECK(graph.nodes["util"].version == "1.3.5");
+    CHECK(graph.nodes["fmt"].version == "2.1.4");
+    // 依赖在前
+    CHECK(graph.order.size() == 3 && graph.order.back() == "app-lib");
+
+    // 已安装且仍满足约束的版本优先保留
+    DependencySolver preferring(registry(packages));
+    preferring.set_preferred({{"util", "1.2.0"}});
+    CHECK(preferring.solve({Dependency("app-lib", "^1.0.0")}).nodes["util"].version == "1.2.0");
+
+    // 后到的约束迫使 app-lib 降级：撤回 1.4.0 带来的约束，只被它依赖的 fmt 一并移除
+    DependencyGraph pinned = DependencySolver(registry(packages)).solve(
+        {Dependency("app-lib", "^1.0.0"), Dependency("pin", "*")});
+    CHECK(pinned.nodes["app-lib"].version == "1.0.0");
+    CHECK(pinned.nodes["util"].version == "1.3.5");
+    CHECK(pinned.nodes.count("fmt") == 0);
+    CHECK(pinned.nodes.size() == 3);
+}
+
+void test_conflicts() {
+    std::map<std::string, json> packages = {
+        {"a", {{"versions", {{"1.0.0", {{"dependencies", {{"shared", "^1.0.0"}}}}}}}}},
+        {"b", {{"versions", {{"1.0.0", {{"dependencies", {{"shared", "^2.0.0"}}}}}}}}},
+        {"shared", {{"versions", {"1.0.0", "1.1.0", "2.0.0"}}}},
+        {"evil", {{"versions", {{"1.0.0", {{"dependencies", {{"../escape", "*"}}}}}}}}},
+        {"cycle-a", {{"versions", {{"1.0.0", {{"dependencies", {{"cycle-b", "*"}}}}}}}}},
+        {"cycle-b", {{"versions", {{"1.0.0", {{"dependencies", {{"cycle-a", "*"}}}}}}}}},
+    };
+    // 冲突信息列出每个约束的来源与可用版本
+    std::string error = solve_error(packages, {Dependency("a", "*"), Dependency("b", "*")});
+    CHECK(error.find("Version conflict for shared") != std::string::npos);
+    CHECK(error.find("a requires ^1.0.0") != std::string::npos);
+    CHECK(error.find("b requires ^2.0.0") != std::string::npos);
+    CHECK(error.find("available: 2.0.0 1.1.0 1.0.0") != std::string::npos);
+
+    CHECK(solve_error(packages, {Dependency("shared", "^3.0.0")}).find("cardity.json requires ^3.0.0") !=
+          std::string::npos);
+    CHECK(solve_error(packages, {Dependency("missing", "*")}).find("Package not found: missing") !=
+          std::string::npos);
+    CHECK(solve_error(packages, {Dependency("shared", "^^1")}).find("Invalid version range") != std::string::npos);
+    CHECK(solve_error(packages, {Dependency("evil", "*")}).find("Invalid package name") != std::string::npos);
+    CHECK(solve_error(packages, {Dependency("cycle-a", "*")}).find("Circular dependency") != std::string::npos);
+}
+
+void test_lockfile() {
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("cardity_lock_test_" + std::to_string(::getpid()) + ".lock")).string();
+    LockFile lock;
+    lock.requires_hash = LockFile::fingerprint({Dependency("util", "^1.0.0")});
+    PackageNode util;
+    util.name = "util";
+    util.version = "1.3.5";
+    util.sha256 = "bb";
+    lock.graph.nodes["util"] = util;
+    CHECK(lock.write(path));
+    CHECK(!std::filesystem::exists(path + ".tmp"));
+
+    LockFile read;
+    CHECK(LockFile::read(path, read));
+    CHECK(read.requires_hash == lock.requires_hash);
+    CHECK(read.graph.nodes.size() == 1);
+    CHECK(read.graph.nodes["util"].version == "1.3.5");
+    CHECK(read.graph.nodes["util"].sha256 == "bb");
+    CHECK(LockFile::fingerprint({Dependency("util", "^1.0.0")}) != LockFile::fingerprint({Dependency("util", "^2.0.0")}));
+    std::remove(path.c_str());
+
+    // 目录不存在：返回 false
+    CHECK(!lock.write(path + ".missing/cardity.lock"));
+}
+
+} // namespace
+
+int main() {
+    test_semver_parse_and_compare();
+    test_ranges();
+    test_solve();
+    test_conflicts();
+    test_lockfile();
+
+    if (failures) {
+        std::cerr << "❌ " << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ dependency_solver tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,335 @@
+// Dogecoin 交易层的离线测试向量：RFC 6979 确定性签名、low-S、地址/WIF 编码、已知签名哈希，以及部署交易与铭文链的标准性检查。
+// 不依赖节点与网络，失败时返回非 0
+#include "dogecoin_tx.h"
+#include "dogecoin_deployer.h"
+#include "inscription_planner.h"
+#include "codec.h"
+#include "sha256.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cardity;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::cerr << "❌ " << __FILE__ << ":" << __LINE__ << ": " #cond << std::endl; \
+            ++failures;                                                              \
+        }                                                                            \
+    } while (0)
+
+template <typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const std::exception&) {
+        return true;
+    }
+    return false;
+}
+
+std::vector<uint8_t> from_hex(const std::string& hex) {
+    std::vector<uint8_t> out;
+    if (!Codec::hex_decode(hex, out)) throw std::runtime_error("bad hex in test vector: " + hex);
+    return out;
+}
+
+std::vector<uint8_t> sha256(const std::string& message) {
+    Sha256 hasher;
+    hasher.update(message);
+    return hasher.digest();
+}
+
+// DER 签名中的 s（大端，去掉符号填充字节）
+std::vector<uint8_t> der_s(const std::vector<uint8_t>& der) {
+    size_t r_len = der.at(3);
+    size_t s_pos = 4 + r_len;
+    size_t s_len = der.at(s_pos + 1);
+    std::vector<uint8_t> s(der.begin() + s_pos + 2, der.begin() + s_pos + 2 + s_len);
+    while (s.size() > 1 && s[0] == 0) s.erase(s.begin());
+    return s;
+}
+
+// secp256k1 阶的一半（n / 2），low-S 要求 s <= 该值
+bool is_low_s(const std::vector<uint8_t>& s) {
+    static const std::vector<uint8_t> half = from_hex("7fffffffffffffffffffffffffffffff5d576e7357a4501ddfe92f46681b20a0");
+    if (s.size() != half.size()) return s.size() < half.size();
+    return s <= half;
+}
+
+// ---- RFC 6979 / low-S ----
+// 私钥、消息（SHA-256 后签名）与期望的 DER 签名；nonce k 由 RFC 6979（HMAC-SHA256）导出。
+// 这几组原始 s 均大于 n/2，期望值为规范化后的 low-S 形式
+struct SignVector {
+    const char* secret;
+    const char* message;
+    const char* k;          // 仅作记录：签名中的 r 由它决定
+    const char* der;
+};
+
+const SignVector SIGN_VECTORS[] = {
+    {"0000000000000000000000000000000000000000000000000000000000000001",
+     "Satoshi Nakamoto",
+     "8f8a276c19f4149656b280621e358cce24f5f52542772691ee69063b74f15d15",
+     "3045022100934b1ea10a4b3c1757e2b0c017d0b6143ce3c9a7e6a4a49860d7a6ab210ee3d8"
+     "02202442ce9d2b916064108014783e923ec36b49743e2ffa1c4496f01a512aafd9e5"},
+    {"0000000000000000000000000000000000000000000000000000000000000001",
+     "All those moments will be lost in time, like tears in rain. Time to die...",
+     "38aa22d72376b4dbc472e06c3ba403ee0a394da63fc58d88686c611aba98d6b3",
+     "30450221008600dbd41e348fe5c9465ab92d23e3db8b98b873beecd930736488696438cb6b"
+     "0220547fe64427496db33bf66019dacbf0039c04199abb0122918601db38a72cfc21"},
+    {"fffffffffffffffffffffffffffffffebaaedce6af48a03bbfd25e8cd0364140",
+     "Satoshi Nakamoto",
+     "33a19b60e25fb6f4435af53a3d42d493644827367e6453928554f43e49aa6f90",
+     "3045022100fd567d121db66e382991534ada77a6bd3106f0a1098c231e47993447cd6af2d0"
+     "02206b39cd0eb1bc8603e159ef5c20a5c8ad685a45b06ce9bebed3f153d10d93bed5"},
+    {"f8b8af8ce3c7cca5e300d33939540c10d45ce001b8f252bfbc57ba0342904181",
+     "Alan Turing",
+     "525a82b70e67874398067543fd84c83d30c175fdc45fdeee082fe13b1d7cfdf1",
+     "304402207063ae83e7f62bbb171798131b4a0564b956930092b33b07b395615d9ec7e15c"
+     "022058dfcc1e00a35e1572f366ffe34ba0fc47db1e7189759b9fb233c5b05ab388ea"},
+};
+
+void test_rfc6979_signatures() {
+    for (const auto& v : SIGN_VECTORS) {
+        Secp256k1Key key(from_hex(v.secret));
+        std::vector<uint8_t> digest = sha256(v.message);
+        std::vector<uint8_t> sig = key.sign(digest.data());
+        CHECK(Codec::hex_encode(sig) == v.der);
+        CHECK(is_low_s(der_s(sig)));
+        CHECK(Secp256k1Key::verify(key.public_key(), digest.data(), sig));
+        // 同一输入再次签名结果不变
+        CHECK(key.sign(digest.data()) == sig);
+
+        std::vector<uint8_t> other = sha256(std::string(v.message) + "!");
+        CHECK(!Secp256k1Key::verify(key.public_key(), other.data(), sig));
+    }
+}
+
+void test_low_s_many() {
+    Secp256k1Key key(from_hex("1111111111111111111111111111111111111111111111111111111111111111"));
+    for (int i = 0; i < 64; ++i) {
+        std::vector<uint8_t> digest = sha256("low-s #" + std::to_string(i));
+        std::vector<uint8_t> sig = key.sign(digest.data());
+        CHECK(is_low_s(der_s(sig)));
+        CHECK(Secp256k1Key::verify(key.public_key(), digest.data(), sig));
+    }
+}
+
+// ---- 地址 / WIF ----
+
+struct KeyVector {
+    const char* secret;
+    const char* pubkey;             // 压缩公钥
+    const char* pubkey_hash;
+    const char* address;            // 主网 P2PKH
+    const char* testnet_address;
+    const char* wif;                // 主网，压缩
+    const char* wif_uncompressed;   // 主网，非压缩
+    const char* address_uncompressed;
+    const char* testnet_wif;        // 测试网，压缩
+};
+
+const KeyVector KEY_VECTORS[] = {
+    {"0000000000000000000000000000000000000000000000000000000000000001",
+     "0279be667ef9dcbbac55a06295ce870b07029bfcdb2dce28d959f2815b16f81798",
+     "751e76e8199196d454941c45d1b3a323f1433bd6",
+     "DFpN6QqFfUm3gKNaxN6tNcab1FArL9cZLE",
+     "nesRpRaAbTDmZHwmzBkLd2AtF7Z9L9z5S2",
+     "QNcdLVw8fHkixm6NNyN6nVwxKek4u7qrioRbQmjxac5TVoTtZuot",
+     "6J8csdv3eDrnJcpSEb4shfjMh2JTiG9MKzC1Yfge4Y4GyUsjdM6",
+     "DJRU7MLhcPwCTNRZ4e8gJzDebtG1H5M7pc",
+     "cejxntqoC3o8qiC8HG8DrwoNyiRDBrMCEU8QrUVpLKdXsGy8LpTM"},
+    {"1111111111111111111111111111111111111111111111111111111111111111",
+     "034f355bdcb7cc0af728ef3cceb9615d90684bb5b2ca5f859ab0f0b704075871aa",
+     "fc7250a211deddc70ee5a2738de5f07817351cef",
+     "DU9umLs2Ze8eNRo69wbSj5HeufphJawFPh",
+     "nsCyVMbwVcbNFQNHBmEtyUsx9YCzMC8mub",
+     "QPBoWSh4QVwzxfMtR7PdJeMX91kqxM4WLELGafmJHAruSVa7vey5",
+     "6JG8pTDFNBdvuwTUxm3Qdd71V6cJtWU5P2fMJ9L6jBPdofeGnc6",
+     "DS1P3gwq6MFtatWprr2e2J32xGPd89n75C",
+     "cfK8xqbiwFzQqcTeKQ9kP6Cwo5RzF5Zqqu362NXA2tQyoy4TTpJY"},
+};
+
+void test_addresses_and_wif() {
+    const DogecoinNetwork& main = DogecoinNetwork::mainnet();
+    const DogecoinNetwork& test = DogecoinNetwork::testnet();
+    for (const auto& v : KEY_VECTORS) {
+        Secp256k1Key key(from_hex(v.secret));
+        CHECK(Codec::hex_encode(key.public_key()) == v.pubkey);
+        CHECK(Codec::hex_encode(key.pubkey_hash()) == v.pubkey_hash);
+        CHECK(key.address(main) == v.address);
+        CHECK(key.address(test) == v.testnet_address);
+
+        Secp256k1Key from_wif = Secp256k1Key::from_wif(v.wif, main);
+        CHECK(from_wif.address(main) == v.address);
+        Secp256k1Key uncompressed = Secp256k1Key::from_wif(v.wif_uncompressed, main);
+        CHECK(uncompressed.public_key().size() == 65);
+        CHECK(uncompressed.address(main) == v.address_uncompressed);
+        CHECK(Secp256k1Key::from_wif(v.testnet_wif, test).address(test) == v.testnet_address);
+
+        // 网络不符、校验和错误均拒绝
+        CHECK(throws([&] { Secp256k1Key::from_wif(v.wif, test); }));
+        std::string corrupt = v.wif;
+        corrupt.back() = corrupt.back() == 'a' ? 'b' : 'a';
+        CHECK(throws([&] { Secp256k1Key::from_wif(corrupt, main); }));
+
+        std::vector<uint8_t> script = Script::for_address(v.address, main);
+        std::vector<uint8_t> hash;
+        CHECK(Script::extract_pubkey_hash(script, hash));
+        CHECK(Codec::hex_encode(hash) == v.pubkey_hash);
+        CHECK(throws([&] { Script::for_address(v.address, test); }));
+    }
+}
+
+// ---- 签名哈希 ----
+// BIP 143 示例 1 的未签名交易；输入 0 花费 P2PK 输出，使用传统签名哈希（与 Dogecoin 相同）。
+// 发布的签名须能验证，且确定性签名应逐字节相同
+void test_known_sighash_vector() {
+    RawTransaction tx;
+    CHECK(TxSerializer::parse(from_hex(
+        "0100000002fff7f7881a8099afa6940d42d1e7f6362bec38171ea3edf433541db4e4ad969f0000000000eeffffff"
+        "ef51e1b804cc89d182d279655c3aa89e815b1b309fe287d9b2b55d57b90ec68a0100000000ffffffff02202cb206"
+        "000000001976a9148280b37df378db99f66f85c95a783a76ac7a6d5988ac9093510d000000001976a9143bde42db"
+        "ee7e4dbe6a21b2d50ce2f0167faa815988ac11000000"), tx));
+    CHECK(tx.inputs.size() == 2 && tx.outputs.size() == 2 && tx.locktime == 17);
+
+    Secp256k1Key key(from_hex("bbc27228ddcb9209d7fd6f36b02f7dfa6252af40bb2f1cbc7a557da8027ff866"));
+    CHECK(Codec::hex_encode(key.public_key()) == "03c9f4836b9a4f77fc0d81f7bcb01b7f1b35916864b9476c241ce9fc198bd25432");
+    std::vector<uint8_t> script_code = from_hex("21" + Codec::hex_encode(key.public_key()) + "ac");
+    std::vector<uint8_t> digest = TxSerializer::signature_hash(tx, 0, script_code);
+    CHECK(Codec::hex_encode(digest) == "63cec688ee06a91e913875356dd4dea2f8e0f2a2659885372da2a37e32c7532e");
+
+    const std::string published = "30450221008b9d1dc26ba6a9cb62127b02742fa9d754cd3bebf337f7a55d114c8e5cdd30be"
+                                  "022040529b194ba3f9281a99f2b1c0a19c0489bc22ede944ccf4ecbab4cc618ef3ed";
+    CHECK(Secp256k1Key::verify(key.public_key(), digest.data(), from_hex(published)));
+    CHECK(Codec::hex_encode(key.sign(digest.data())) == published);
+}
+
+// ---- 部署交易 ----
+
+DogecoinTransaction deployment(size_t carc_size, uint64_t amount) {
+    DogecoinTransaction tx;
+    tx.address = KEY_VECTORS[1].address;
+    tx.private_key = KEY_VECTORS[0].wif;
+    tx.amount = amount;
+    tx.carc_data.assign(carc_size, 0xca);
+    return tx;
+}
+
+std::vector<TxInput> funding() {
+    TxInput in;
+    in.prev_txid = std::string(64, 'a');
+    in.vout = 1;
+    in.amount = 100000000;
+    return {in};
+}
+
+void test_signed_deployment() {
+    TxBuildOptions options;
+    DogecoinTransaction tx = deployment(DogecoinDeployer::MAX_OP_RETURN_BYTES, DogecoinDeployer::DEFAULT_AMOUNT);
+    RawTransaction raw = DogecoinDeployer::build_signed_deployment(tx, funding(), options);
+
+    CHECK(raw.inputs.size() == 1);
+    CHECK(raw.outputs.size() == 3);    // OP_RETURN + 支付 + 找零
+    CHECK(raw.outputs[0].value == 0 && raw.outputs[0].script.at(0) == Script::OP_RETURN);
+    CHECK(raw.outputs[1].value == DogecoinDeployer::DEFAULT_AMOUNT);
+    CHECK(raw.outputs[1].script == Script::for_address(KEY_VECTORS[1].address));
+    for (size_t i = 1; i < raw.outputs.size(); ++i) {
+        CHECK(raw.outputs[i].value >= options.dust_limit);
+    }
+
+    // 签名可由 sighash 与公钥验证，且结果确定
+    const std::vector<uint8_t>& script_sig = raw.inputs[0].script_sig;
+    size_t sig_len = script_sig.at(0);
+    std::vector<uint8_t> sig(script_sig.begin() + 1, script_sig.begin() + sig_len);    // 去掉 sighash 类型字节
+    CHECK(script_sig.at(sig_len) == TxSerializer::SIGHASH_ALL);
+    std::vector<uint8_t> digest = TxSerializer::signature_hash(
+        raw, 0, Script::p2pkh(from_hex(KEY_VECTORS[0].pubkey_hash)));
+    CHECK(Secp256k1Key::verify(from_hex(KEY_VECTORS[0].pubkey), digest.data(), sig));
+    CHECK(is_low_s(der_s(sig)));
+    RawTransaction again = DogecoinDeployer::build_signed_deployment(tx, funding(), options);
+    CHECK(TxSerializer::to_hex(again) == TxSerializer::to_hex(raw));
+
+    RawTransaction parsed;
+    CHECK(TxSerializer::parse(TxSerializer::serialize(raw), parsed));
+    CHECK(TxSerializer::txid(parsed) == TxSerializer::txid(raw));
+}
+
+// 未压缩公钥的 scriptSig 多 32 字节，手续费仍需覆盖签名后的实际大小
+void test_uncompressed_key_fee() {
+    TxBuildOptions options;
+    DogecoinTransaction tx = deployment(DogecoinDeployer::MAX_OP_RETURN_BYTES, DogecoinDeployer::DEFAULT_AMOUNT);
+    tx.private_key = KEY_VECTORS[0].wif_uncompressed;
+    RawTransaction raw = DogecoinDeployer::build_signed_deployment(tx, funding(), options);
+
+    uint64_t total_out = 0;
+    for (const auto& o : raw.outputs) total_out += o.value;
+    size_t size = TxSerializer::serialize(raw).size();
+    CHECK(raw.inputs[0].script_sig.size() > 1 + 72 + 1 + 33);
+    CHECK(funding()[0].amount - total_out >= TxBuilder::fee_for_size(size, options.fee_per_kb));
+    CHECK(TxBuilder::estimate_signed_size(raw, 65) >= size);
+}
+
+void test_nonstandard_deployment_rejected() {
+    TxBuildOptions options;
+    // OP_RETURN 超过 80 字节
+    CHECK(throws([&] {
+        DogecoinDeployer::build_signed_deployment(
+            deployment(DogecoinDeployer::MAX_OP_RETURN_BYTES + 1, DogecoinDeployer::DEFAULT_AMOUNT), funding(), options);
+    }));
+    // 支付输出低于 dust
+    CHECK(throws([&] {
+        DogecoinDeployer::build_signed_deployment(deployment(32, options.dust_limit - 1), funding(), options);
+    }));
+    CHECK(throws([&] { DogecoinDeployer::build_signed_deployment(deployment(32, 1000), funding(), options); }));
+}
+
+// ---- 铭文链 ----
+
+void test_inscription_chain() {
+    Secp256k1Key key(from_hex(KEY_VECTORS[0].secret));
+    InscriptionOptions options;
+    options.destination = KEY_VECTORS[1].address;
+    std::vector<std::vector<uint8_t>> bodies = {std::vector<uint8_t>(2000, '{')};
+
+    InscriptionChain chain = InscriptionPlanner::plan(bodies, funding(), key, options);
+    CHECK(chain.transactions.front().role == "commit");
+    const RawTransaction& last = chain.transactions.back().tx;
+    CHECK(last.outputs.size() == 1);
+    CHECK(last.outputs[0].value == options.postage);
+    CHECK(last.outputs[0].value >= options.dust_limit);
+
+    // postage 低于 dust，或 reveal 数超出内存池后代上限，都不能规划
+    InscriptionOptions dusty = options;
+    dusty.postage = options.dust_limit - 1;
+    CHECK(throws([&] { InscriptionPlanner::plan(bodies, funding(), key, dusty); }));
+    std::vector<std::vector<uint8_t>> large = {std::vector<uint8_t>(
+        InscriptionPlanner::MEMPOOL_DESCENDANT_LIMIT * InscriptionPlanner::MAX_PARTIAL_SIZE, '{')};
+    CHECK(throws([&] { InscriptionPlanner::plan(large, funding(), key, options); }));
+}
+
+} // namespace
+
+int main() {
+    test_rfc6979_signatures();
+    test_low_s_many();
+    test_addresses_and_wif();
+    test_known_sighash_vector();
+    test_signed_deployment();
+    test_uncompressed_key_fee();
+    test_nonstandard_deployment_rejected();
+    test_inscription_chain();
+
+    if (failures) {
+        std::cerr << "❌ " << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ dogecoin_tx tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,177 @@
+// 共享 HTTP 客户端对本地替身注册表的测试：连接复用、并发请求、404/错误状态映射与流式响应体。
+// 只访问 127.0.0.1，失败时返回非 0
+#include "http_client.h"
+#include "registry_client.h"
+#include "byte_channel.h"
+#include "stub_registry.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace cardity;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::cerr << "❌ " << __FILE__ << ":" << __LINE__ << ": " #cond << std::endl; \
+            ++failures;                                                              \
+        }                                                                            \
+    } while (0)
+
+// 可校验的伪随机归档内容
+std::string make_bytes(size_t size) {
+    std::string bytes(size, '\0');
+    uint32_t x = 2463534242u;
+    for (auto& c : bytes) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        c = static_cast<char>(x);
+    }
+    return bytes;
+}
+
+HttpResponse get(const std::string& url) {
+    HttpRequest request;
+    request.url = url;
+    return HttpClient::instance().perform(std::move(request));
+}
+
+void test_connection_reuse(StubRegistry& registry) {
+    size_t accepted = registry.connections_accepted();
+    for (int i = 0; i < 20; ++i) {
+        HttpResponse response = get(registry.url() + "/packages/alpha");
+        CHECK(response.ok());
+        CHECK(response.status == 200);
+        CHECK(response.body == R"({"name":"alpha","version":"1.0.0"})");
+        CHECK(response.header("content-type") == "application/json");
+    }
+    // 顺序请求全部走同一条 keep-alive 连接
+    CHECK(registry.connections_accepted() - accepted == 1);
+}
+
+void test_concurrent_requests(StubRegistry& registry) {
+    size_t completed = HttpClient::instance().requests_completed();
+    std::vector<std::future<HttpResponse>> futures;
+    for (int i = 0; i < 32; ++i) {
+        HttpRequest request;
+        request.url = registry.url() + (i % 2 ? "/packages/alpha" : "/packages/beta");
+        futures.push_back(HttpClient::instance().send(std::move(request)));
+    }
+    for (size_t i = 0; i < futures.size(); ++i) {
+        HttpResponse response = futures[i].get();
+        CHECK(response.ok());
+        CHECK(response.body.find(i % 2 ? "alpha" : "beta") != std::string::npos);
+    }
+    CHECK(HttpClient::instance().requests_completed() - completed == futures.size());
+    // 连接数受 CURLMOPT_MAX_HOST_CONNECTIONS 限制，远少于请求数
+    CHECK(registry.connections_accepted() <= 1 + 8);
+}
+
+void test_error_mapping(StubRegistry& registry) {
+    // HTTP 错误不是传输错误：error 为空，status 为实际状态码，ok() 为 false
+    HttpResponse missing = get(registry.url() + "/packages/missing");
+    CHECK(missing.error.empty());
+    CHECK(missing.status == 404);
+    CHECK(!missing.ok());
+    CHECK(missing.body == R"({"error":"not found"})");
+
+    HttpResponse failed = get(registry.url() + "/status/500");
+    CHECK(failed.error.empty());
+    CHECK(failed.status == 500);
+    CHECK(!failed.ok());
+
+    // 404 的下载不留下文件
+    std::string path = (std::filesystem::temp_directory_path() /
+                        ("cardity_http_test_" + std::to_string(::getpid()) + ".tar.gz")).string();
+    RegistryClient client(registry.url());
+    CHECK(!client.download_package("missing", "1.0.0", path));
+    CHECK(!std::filesystem::exists(path));
+    CHECK(client.download_package("alpha", "1.0.0", path));
+    std::ifstream in(path, std::ios::binary);
+    std::string saved((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    CHECK(saved == make_bytes(256 * 1024));
+    std::remove(path.c_str());
+
+    // 连接被拒绝：传输错误，status 为 0
+    HttpResponse refused = get("http://127.0.0.1:1/");
+    CHECK(!refused.error.empty());
+    CHECK(refused.status == 0);
+    CHECK(!refused.ok());
+}
+
+void test_streaming_body(StubRegistry& registry) {
+    // 通道容量远小于响应体，传输需要多次暂停/恢复
+    const std::string expected = make_bytes(4 * 1024 * 1024 + 123);
+    auto channel = std::make_shared<ByteChannel>(64 * 1024);
+    HttpRequest request;
+    request.url = registry.url() + "/packages/big/2.0.0/download";
+    request.stream = channel;
+    std::future<HttpResponse> future = HttpClient::instance().send(std::move(request));
+
+    std::string received;
+    std::vector<char> buffer(8192);
+    long n;
+    while ((n = channel->read(buffer.data(), buffer.size())) > 0) {
+        received.append(buffer.data(), static_cast<size_t>(n));
+    }
+    CHECK(n == 0);
+    CHECK(received.size() == expected.size());
+    CHECK(received == expected);
+    HttpResponse response = future.get();
+    CHECK(response.ok());
+    CHECK(response.body.empty());
+
+    // 错误页不进入通道，以 "HTTP <status>" 结束
+    auto missing = std::make_shared<ByteChannel>(64 * 1024);
+    HttpRequest not_found;
+    not_found.url = registry.url() + "/packages/big/9.9.9/download";
+    not_found.stream = missing;
+    std::future<HttpResponse> missing_future = HttpClient::instance().send(std::move(not_found));
+    CHECK(missing->read(buffer.data(), buffer.size()) == -1);
+    CHECK(missing->error() == "HTTP 404");
+    CHECK(missing_future.get().status == 404);
+
+    // 消费者中途放弃：传输被中止，future 仍会完成
+    auto abandoned = std::make_shared<ByteChannel>(64 * 1024);
+    HttpRequest partial;
+    partial.url = registry.url() + "/packages/big/2.0.0/download";
+    partial.stream = abandoned;
+    std::future<HttpResponse> partial_future = HttpClient::instance().send(std::move(partial));
+    CHECK(abandoned->read(buffer.data(), buffer.size()) > 0);
+    abandoned->cancel();
+    CHECK(!partial_future.get().ok());
+}
+
+} // namespace
+
+int main() {
+    StubRegistry registry;
+    registry.add_package("alpha", R"({"name":"alpha","version":"1.0.0"})");
+    registry.add_package("beta", R"({"name":"beta","version":"0.3.1"})");
+    registry.add_archive("alpha", "1.0.0", make_bytes(256 * 1024));
+    registry.add_archive("big", "2.0.0", make_bytes(4 * 1024 * 1024 + 123));
+    registry.start();
+
+    test_connection_reuse(registry);
+    test_concurrent_requests(registry);
+    test_error_mapping(registry);
+    test_streaming_body(registry);
+
+    registry.stop();
+    if (failures) {
+        std::cerr << "❌ " << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "✅ http_client tests passed (" << registry.requests_served() << " requests, "
+              << registry.connections_accepted() << " connections)" << std::endl;
+    return 0;
+}